@@ -244,7 +244,41 @@ void console_add_to_history(const char *line, uint8_t line_length)
   console_history_end                         = (console_history_end + 1) % sizeof(console_history_buffer);
 }
 
-// Simple linear database search. This function could be replaced with a more complicated version
+// Finds the entry whose key is token. Keys of which token is only a prefix make the command incomplete.
+static sl_status_t console_find_entry(const console_database_t *db,
+                                      const char *token,
+                                      size_t token_length,
+                                      uint32_t *index)
+{
+  if (db->sorted) {
+    // The first key not below token is either token itself or, if any key starts with token, the smallest such key
+    uint32_t low  = 0;
+    uint32_t high = db->length;
+    while (low < high) {
+      uint32_t middle = low + (high - low) / 2;
+      if (strcmp(db->entries[middle].key, token) < 0) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    if ((low == db->length) || (strncmp(token, db->entries[low].key, token_length) != 0)) {
+      return SL_STATUS_FAIL;
+    }
+    *index = low;
+    return (db->entries[low].key[token_length] == '\0') ? SL_STATUS_OK : SL_STATUS_COMMAND_INCOMPLETE;
+  }
+
+  for (uint32_t i = 0; i < db->length; i++) {
+    if (strncmp(token, db->entries[i].key, token_length) == 0) {
+      *index = i;
+      return (strlen(db->entries[i].key) == token_length) ? SL_STATUS_OK : SL_STATUS_COMMAND_INCOMPLETE;
+    }
+  }
+  return SL_STATUS_FAIL;
+}
+
+// Database search, binary for generated databases and linear for unsorted ones
 sl_status_t console_find_command(char **string,
                                  char *string_end,
                                  const console_database_t *db,
@@ -271,22 +305,17 @@ sl_status_t console_find_command(char **string,
       return SL_STATUS_FAIL;
 
     size_t token_length = strlen(token);
+    uint32_t index      = 0;
 
-    for (uint32_t i = 0; i < db->length; i++) {
-      if (strncmp(token, db->entries[i].key, token_length) == 0) {
-        *entry          = &(db->entries[i]);
-        *starting_index = i;
-
-        if (strlen(db->entries[i].key) == token_length) {
-          break;
-        } else {
-          return SL_STATUS_COMMAND_INCOMPLETE;
-        }
-      }
-    }
-    if (*entry == NULL) {
+    status = console_find_entry(db, token, token_length, &index);
+    if (status == SL_STATUS_FAIL) {
       return SL_STATUS_FAIL;
     }
+    *entry          = &(db->entries[index]);
+    *starting_index = index;
+    if (status != SL_STATUS_OK) {
+      return status;
+    }
 
     output_command                               = (const console_descriptive_command_t *)(*entry)->value;
     const console_argument_type_t *argument_list = &(output_command->argument_list[0]);
@@ -62,6 +62,16 @@ void console_print_command_args(const console_descriptive_command_t *command);
 char *console_get_command_buffer(void);
 uint32_t console_read_data_from_cache(char *buffer, uint32_t buffer_size);
 
+/*
+ * Binary mode for scripted hosts. Received bytes, e.g. from console_read_data_from_cache(), are passed to
+ * console_binary_process() instead of the line editor, so nothing is echoed. A request payload is the zero terminated
+ * command name, a 32-bit bitmap of the arguments present and their values in argument order. Every request gets a
+ * response frame with the same request ID and a 32-bit sl_status_t payload, and the responses to the frames of one
+ * call are written together.
+ */
+sl_status_t console_binary_init(console_binary_write_t write);
+sl_status_t console_binary_process(const console_database_t *db, const uint8_t *data, uint32_t length);
+
 #ifdef __cplusplus
 } /*extern "C" */
 #endif
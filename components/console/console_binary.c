@@ -0,0 +1,362 @@
+/*******************************************************************************
+* @file  console_binary.c
+* @brief Length prefixed, CRC checked binary framing of console commands
+*******************************************************************************
+* # License
+* <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* The licensor of this software is Silicon Laboratories Inc. Your use of this
+* software is governed by the terms of Silicon Labs Master Software License
+* Agreement (MSLA) available at
+* www.silabs.com/about-us/legal/master-software-license-agreement. This
+* software is distributed to you in Source Code format and is governed by the
+* sections of the MSLA applicable to Source Code.
+*
+******************************************************************************/
+
+#include "console.h"
+#include "sl_ieee802_types.h"
+#include "sl_ip_types.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/******************************************************
+ *                      Macros
+ ******************************************************/
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/******************************************************
+ *                    Constants
+ ******************************************************/
+
+// Largest number of bytes of incomplete frames kept between calls to console_binary_process()
+#ifndef CONSOLE_BINARY_RX_BUFFER_SIZE
+#define CONSOLE_BINARY_RX_BUFFER_SIZE 512
+#endif
+
+// Responses are collected here and written in one go
+#ifndef CONSOLE_BINARY_TX_BUFFER_SIZE
+#define CONSOLE_BINARY_TX_BUFFER_SIZE 128
+#endif
+
+#ifndef CONSOLE_BINARY_MAX_COMMAND_LENGTH
+#define CONSOLE_BINARY_MAX_COMMAND_LENGTH 64
+#endif
+
+#define CONSOLE_BINARY_RESPONSE_LENGTH (CONSOLE_BINARY_FRAME_OVERHEAD + sizeof(uint32_t))
+
+/******************************************************
+ *               Static Function Declarations
+ ******************************************************/
+
+static void console_binary_dispatch(const console_database_t *db, uint8_t *frame);
+static sl_status_t console_binary_execute(const console_database_t *db, uint8_t *payload, uint16_t length);
+static sl_status_t console_binary_decode_arg(console_argument_type_t type,
+                                             uint8_t **data,
+                                             const uint8_t *end,
+                                             uint32_t *arg_result);
+static void console_binary_respond(uint16_t request_id, sl_status_t status);
+static void console_binary_flush(void);
+static uint16_t console_binary_crc(const uint8_t *data, uint32_t length);
+
+/******************************************************
+ *               Variable Definitions
+ ******************************************************/
+
+extern const arg_list_t console_argument_types[];
+extern const value_list_t console_argument_values[];
+
+static console_binary_write_t console_binary_write = NULL;
+
+static uint8_t console_binary_rx_buffer[CONSOLE_BINARY_RX_BUFFER_SIZE];
+static uint32_t console_binary_rx_length = 0;
+
+static uint8_t console_binary_tx_buffer[CONSOLE_BINARY_TX_BUFFER_SIZE];
+static uint32_t console_binary_tx_length = 0;
+
+/******************************************************
+ *               Function Definitions
+ ******************************************************/
+
+static inline uint16_t read_uint16(const uint8_t *data)
+{
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static inline uint32_t read_uint32(const uint8_t *data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static inline void write_uint16(uint8_t *data, uint16_t value)
+{
+  data[0] = (uint8_t)value;
+  data[1] = (uint8_t)(value >> 8);
+}
+
+static inline void write_uint32(uint8_t *data, uint32_t value)
+{
+  write_uint16(&data[0], (uint16_t)value);
+  write_uint16(&data[2], (uint16_t)(value >> 16));
+}
+
+sl_status_t console_binary_init(console_binary_write_t write)
+{
+  if (write == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  console_binary_write     = write;
+  console_binary_rx_length = 0;
+  console_binary_tx_length = 0;
+  return SL_STATUS_OK;
+}
+
+sl_status_t console_binary_process(const console_database_t *db, const uint8_t *data, uint32_t length)
+{
+  if (console_binary_write == NULL) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+
+  while (length > 0) {
+    uint32_t copy_length = MIN(length, sizeof(console_binary_rx_buffer) - console_binary_rx_length);
+    memcpy(&console_binary_rx_buffer[console_binary_rx_length], data, copy_length);
+    console_binary_rx_length += copy_length;
+    data += copy_length;
+    length -= copy_length;
+
+    // Run every complete frame. Anything that is not a frame with a valid CRC, such as line noise or a partial frame
+    // from before a host restart, is skipped a byte at a time.
+    uint32_t offset = 0;
+    while ((console_binary_rx_length - offset) >= CONSOLE_BINARY_FRAME_OVERHEAD) {
+      uint8_t *frame = &console_binary_rx_buffer[offset];
+      if (frame[0] != CONSOLE_BINARY_SYNC_BYTE) {
+        ++offset;
+        continue;
+      }
+      uint32_t frame_length = CONSOLE_BINARY_FRAME_OVERHEAD + read_uint16(&frame[1]);
+      if (frame_length > sizeof(console_binary_rx_buffer)) {
+        ++offset;
+        continue;
+      }
+      if ((console_binary_rx_length - offset) < frame_length) {
+        break;
+      }
+      uint32_t crc_offset = frame_length - sizeof(uint16_t);
+      if (console_binary_crc(&frame[1], crc_offset - 1) != read_uint16(&frame[crc_offset])) {
+        ++offset;
+        continue;
+      }
+      console_binary_dispatch(db, frame);
+      offset += frame_length;
+    }
+
+    // Keep the start of an incomplete frame for the next call
+    console_binary_rx_length -= offset;
+    memmove(console_binary_rx_buffer, &console_binary_rx_buffer[offset], console_binary_rx_length);
+  }
+
+  console_binary_flush();
+  return SL_STATUS_OK;
+}
+
+static void console_binary_dispatch(const console_database_t *db, uint8_t *frame)
+{
+  uint16_t payload_length = read_uint16(&frame[1]);
+  uint16_t request_id     = read_uint16(&frame[3]);
+
+  // Commands run from the frame in the receive buffer, so string and MAC address arguments point into it
+  sl_status_t status = console_binary_execute(db, &frame[CONSOLE_BINARY_HEADER_LENGTH], payload_length);
+  console_binary_respond(request_id, status);
+}
+
+static sl_status_t console_binary_execute(const console_database_t *db, uint8_t *payload, uint16_t length)
+{
+  // Command name, with '.' separating sub-commands as on the command line. The copy is padded with zeros because
+  // console_find_command() looks past the end of a name that stops at a sub-command database.
+  char name[CONSOLE_BINARY_MAX_COMMAND_LENGTH + 2] = { 0 };
+  uint8_t *name_end                                = memchr(payload, '\0', length);
+  if ((name_end == NULL) || ((size_t)(name_end - payload) > CONSOLE_BINARY_MAX_COMMAND_LENGTH)) {
+    return SL_STATUS_COMMAND_IS_INVALID;
+  }
+  memcpy(name, payload, (size_t)(name_end - payload));
+
+  const console_database_entry_t *entry = NULL;
+  uint32_t index                        = 0;
+  char *iter                            = name;
+  sl_status_t status = console_find_command(&iter, &name[name_end - payload], db, &entry, &index);
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  const console_descriptive_command_t *command = (const console_descriptive_command_t *)entry->value;
+  const console_argument_type_t *argument_list = &(command->argument_list[0]);
+  if (argument_list[0] == CONSOLE_ARG_SUB_COMMAND) {
+    return SL_STATUS_COMMAND_INCOMPLETE;
+  }
+
+  // Bitmap of the arguments present, numbered as in console_args_t, followed by their values in that order
+  uint8_t *data     = name_end + 1;
+  const uint8_t *end = payload + length;
+  if ((end - data) < (ptrdiff_t)sizeof(uint32_t)) {
+    return SL_STATUS_COMMAND_IS_INVALID;
+  }
+  uint32_t present = read_uint32(data);
+  data += sizeof(uint32_t);
+
+  console_args_t args = { 0 };
+  uint32_t arg_count  = 0;
+  for (uint32_t a = 0; argument_list[a] != CONSOLE_ARG_END; ++arg_count) {
+    console_argument_type_t type = argument_list[a];
+    bool is_optional             = (type & CONSOLE_ARG_OPTIONAL) != 0;
+    if (is_optional) {
+      type = argument_list[a + 1];
+      a += 2;
+    } else {
+      ++a;
+    }
+
+    if (arg_count >= SL_SI91X_CLI_CONSOLE_MAX_ARG_COUNT) {
+      return SL_STATUS_COMMAND_IS_INVALID;
+    }
+    if (!(present & (1 << arg_count))) {
+      if (is_optional) {
+        continue;
+      }
+      return SL_STATUS_COMMAND_IS_INVALID;
+    }
+    status = console_binary_decode_arg(type, &data, end, &args.arg[arg_count]);
+    if (status != SL_STATUS_OK) {
+      return status;
+    }
+    args.bitmap |= (1 << arg_count);
+  }
+  if (data != end) {
+    return SL_STATUS_COMMAND_IS_INVALID;
+  }
+
+  return command->handler(&args);
+}
+
+// Argument values are the binary form of what console_parse_arg() produces from text
+static sl_status_t console_binary_decode_arg(console_argument_type_t type,
+                                             uint8_t **data,
+                                             const uint8_t *end,
+                                             uint32_t *arg_result)
+{
+  uint8_t *iter           = *data;
+  ptrdiff_t available     = end - iter;
+  ptrdiff_t decode_length = 0;
+
+  if (type & CONSOLE_ARG_ENUM) {
+    // One byte index into the option list
+    if (available < 1) {
+      return SL_STATUS_COMMAND_IS_INVALID;
+    }
+    uint8_t enum_index = type & CONSOLE_ARG_ENUM_INDEX_MASK;
+    for (uint32_t a = 0; a <= iter[0]; ++a) {
+      if (console_argument_types[enum_index][a] == NULL) {
+        return SL_STATUS_COMMAND_IS_INVALID;
+      }
+    }
+    if (console_argument_values[enum_index] == NULL) {
+      *arg_result = iter[0];
+    } else {
+      *arg_result = console_argument_values[enum_index][iter[0]];
+    }
+    *data = iter + 1;
+    return SL_STATUS_OK;
+  }
+
+  switch (type & CONSOLE_ARG_ENUM_INDEX_MASK) {
+    case CONSOLE_ARG_NONE:
+      *arg_result = 0;
+      break;
+
+    case CONSOLE_ARG_UINT:
+    case CONSOLE_ARG_INT:
+    case CONSOLE_ARG_HEX:
+      decode_length = sizeof(uint32_t);
+      if (available >= decode_length) {
+        *arg_result = read_uint32(iter);
+      }
+      break;
+
+    case CONSOLE_ARG_STRING:
+    case CONSOLE_ARG_REMAINING_COMMAND_LINE: {
+      // Zero terminated, used in place
+      const uint8_t *string_end = memchr(iter, '\0', (size_t)available);
+      if (string_end == NULL) {
+        return SL_STATUS_COMMAND_IS_INVALID;
+      }
+      decode_length = string_end - iter + 1;
+      *arg_result   = (uint32_t)iter;
+    } break;
+
+    case CONSOLE_ARG_MAC_ADDRESS:
+      // Six bytes, used in place
+      decode_length = sizeof(sl_mac_address_t);
+      *arg_result   = (uint32_t)iter;
+      break;
+
+    case CONSOLE_ARG_IP_ADDRESS: {
+      // Four bytes in network order
+      sl_ipv4_address_t temp_ip = { 0 };
+      decode_length             = sizeof(temp_ip.bytes);
+      if (available >= decode_length) {
+        memcpy(temp_ip.bytes, iter, sizeof(temp_ip.bytes));
+        *arg_result = temp_ip.value;
+      }
+    } break;
+
+    default:
+      return SL_STATUS_COMMAND_IS_INVALID;
+  }
+
+  if (available < decode_length) {
+    return SL_STATUS_COMMAND_IS_INVALID;
+  }
+  *data = iter + decode_length;
+  return SL_STATUS_OK;
+}
+
+static void console_binary_respond(uint16_t request_id, sl_status_t status)
+{
+  if ((sizeof(console_binary_tx_buffer) - console_binary_tx_length) < CONSOLE_BINARY_RESPONSE_LENGTH) {
+    console_binary_flush();
+  }
+
+  uint8_t *frame = &console_binary_tx_buffer[console_binary_tx_length];
+  frame[0]       = CONSOLE_BINARY_SYNC_BYTE;
+  write_uint16(&frame[1], sizeof(uint32_t));
+  write_uint16(&frame[3], request_id);
+  write_uint32(&frame[5], status);
+  write_uint16(&frame[9], console_binary_crc(&frame[1], CONSOLE_BINARY_RESPONSE_LENGTH - 3));
+  console_binary_tx_length += CONSOLE_BINARY_RESPONSE_LENGTH;
+}
+
+static void console_binary_flush(void)
+{
+  if (console_binary_tx_length != 0) {
+    console_binary_write(console_binary_tx_buffer, console_binary_tx_length);
+    console_binary_tx_length = 0;
+  }
+}
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+static uint16_t console_binary_crc(const uint8_t *data, uint32_t length)
+{
+  uint16_t crc = 0xFFFF;
+  while (length--) {
+    crc ^= (uint16_t)(*data++ << 8);
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
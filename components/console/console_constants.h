@@ -37,6 +37,9 @@ extern "C" {
   .length  = sizeof((console_database_entry_t[]){ __VA_ARGS__ }) / sizeof(console_database_entry_t), \
   .entries = { __VA_ARGS__ }
 
+// Entries whose keys are in strcmp() order, as the command database generator emits them
+#define CONSOLE_SORTED_DATABASE_ENTRIES(...) .sorted = 1, CONSOLE_DATABASE_ENTRIES(__VA_ARGS__)
+
 #define CONSOLE_VARIABLE(name_string, var, ...)                   \
   {                                                               \
     .name = name_string, .variable = var, .type = { __VA_ARGS__ } \
@@ -110,6 +113,14 @@ extern "C" {
 #define CONSOLE_ARG_OPTIONAL_CHARACTER_MASK 0x7F
 #define CONSOLE_ARG_ENUM_INDEX_MASK         0x3F
 
+/*
+ * Binary framing, see console_binary_process(). Each frame is the sync byte, a 16-bit payload length, a 16-bit request
+ * ID, the payload and a CRC-16/CCITT-FALSE of everything after the sync byte, with all fields little endian.
+ */
+#define CONSOLE_BINARY_SYNC_BYTE      0xA5
+#define CONSOLE_BINARY_HEADER_LENGTH  5
+#define CONSOLE_BINARY_FRAME_OVERHEAD (CONSOLE_BINARY_HEADER_LENGTH + 2)
+
 /******************************************************
  *                   Enumerations
  ******************************************************/
@@ -45,6 +45,9 @@ typedef struct {
 
 typedef sl_status_t (*console_handler_t)(console_args_t *arguments);
 
+// Writes a batch of binary response frames to the host
+typedef void (*console_binary_write_t)(const uint8_t *data, uint32_t length);
+
 typedef struct {
   const char *description;
   const char **argument_help;
@@ -62,6 +65,7 @@ typedef struct {
 
 typedef struct {
   uint32_t length;
+  uint32_t sorted; // Non-zero if the keys are in strcmp() order, which lets lookups use a binary search
   console_database_entry_t entries[];
 } console_database_t;
 
@@ -1326,7 +1326,7 @@ static const console_descriptive_command_t _wifi_update_gain_table_command = {
   .handler       = sl_wifi_update_gain_table_command_handler,
   .argument_list = { CONSOLE_ARG_UINT, CONSOLE_ARG_UINT, CONSOLE_ARG_END }
 };
-const console_database_t console_command_database = { CONSOLE_DATABASE_ENTRIES(
+const console_database_t console_command_database = { CONSOLE_SORTED_DATABASE_ENTRIES(
   { "get", &_get_command },
   { "help", &_help_command },
   { "list", &_list_command },
@@ -93,6 +93,17 @@
 // <i> Default: 32
 #define SL_IOSTREAM_USART_VCOM_RX_BUFFER_SIZE 32
 
+// <o SL_IOSTREAM_USART_VCOM_TX_BUFFER_SIZE> Transmit buffer size
+// <i> Writes return once the data is in this buffer; 0 sends byte by byte.
+// <i> Default: 256
+#define SL_IOSTREAM_USART_VCOM_TX_BUFFER_SIZE 256
+
+// <o SL_IOSTREAM_USART_VCOM_TX_OVERFLOW_POLICY> Transmit buffer overflow
+// <SL_IOSTREAM_UART_TX_OVERFLOW_BLOCK=> Wait for room
+// <SL_IOSTREAM_UART_TX_OVERFLOW_DROP=> Drop data
+// <i> Default: SL_IOSTREAM_UART_TX_OVERFLOW_BLOCK
+#define SL_IOSTREAM_USART_VCOM_TX_OVERFLOW_POLICY SL_IOSTREAM_UART_TX_OVERFLOW_BLOCK
+
 // <q SL_IOSTREAM_USART_VCOM_CONVERT_BY_DEFAULT_LF_TO_CRLF> Convert \n to \r\n
 // <i> It can be changed at runtime using the C API.
 // <i> Default: 0
@@ -72,30 +72,51 @@ extern "C" {
 // Iostream Instance in Si91x ,7 because using same sl_iostream.h
 #define SL_IOSTREAM_TYPE_91X_UART 7
 
+/// @brief What a write does when the UART Tx buffer is full
+typedef enum {
+  SL_IOSTREAM_UART_TX_OVERFLOW_BLOCK, ///< Wait until the buffered data has made room
+  SL_IOSTREAM_UART_TX_OVERFLOW_DROP,  ///< Drop the data that does not fit and return SL_STATUS_WOULD_OVERFLOW
+} sl_iostream_uart_tx_overflow_policy_t;
+
 /// @brief I/O Stream UART stream object
 typedef struct {
   sl_iostream_t stream;                           ///< stream
   sl_status_t (*deinit)(void *stream);            ///< uart deinit
   void (*set_auto_cr_lf)(void *context, bool on); ///< set_auto_cr_lf
   bool (*get_auto_cr_lf)(void *context);          ///< get_auto_cr_lf
+  uint32_t (*get_tx_dropped)(void *context);      ///< get_tx_dropped
 } sl_iostream_uart_t;
 
 /// @brief I/O Stream UART config
 typedef struct {
-  uint8_t *rx_buffer;      ///< UART Rx Buffer
-  size_t rx_buffer_length; ///< UART Rx Buffer length
-  bool lf_to_crlf;         ///< lf_to_crlf
+  uint8_t *rx_buffer;                                       ///< UART Rx Buffer
+  size_t rx_buffer_length;                                  ///< UART Rx Buffer length
+  uint8_t *tx_buffer;                                       ///< UART Tx Buffer, NULL to send byte by byte
+  size_t tx_buffer_length;                                  ///< UART Tx Buffer length
+  sl_iostream_uart_tx_overflow_policy_t tx_overflow_policy; ///< Behavior of writes when the Tx Buffer is full
+  bool lf_to_crlf;                                          ///< lf_to_crlf
 } sl_iostream_uart_config_t;
 
 /// @brief I/O Stream UART context
 typedef struct {
-  uint8_t *rx_buffer;                          ///< UART Rx Buffer
-  size_t rx_buffer_len;                        ///< UART Rx Buffer length
-  sl_status_t (*tx)(void *context, char c);    ///< Tx function pointer
-  void (*set_next_byte_detect)(void *context); ///< Pointer to a function to enable detection of next
-                                               ///< byte on stream
-  sl_status_t (*deinit)(void *context);        ///< DeInit function pointer
-  bool lf_to_crlf;                             ///< lf_to_crlf
+  uint8_t *rx_buffer;                                       ///< UART Rx Buffer
+  size_t rx_buffer_len;                                     ///< UART Rx Buffer length
+  size_t rx_tail;                                           ///< Offset of the oldest unread byte in the Rx Buffer
+  volatile size_t rx_count;                                 ///< Unread bytes of completed receives
+  volatile size_t rx_armed_len;                             ///< Length of the pending receive, 0 if none
+  volatile size_t rx_armed_read;                            ///< Bytes already read from the pending receive
+  uint8_t *tx_buffer;                                       ///< UART Tx Buffer
+  size_t tx_buffer_len;                                     ///< UART Tx Buffer length
+  volatile size_t tx_tail;                                  ///< Offset of the oldest unsent byte in the Tx Buffer
+  volatile size_t tx_count;                                 ///< Unsent bytes, including the transfer in progress
+  volatile size_t tx_active_len;                            ///< Length of the transfer in progress, 0 if none
+  volatile uint32_t tx_dropped;                             ///< Bytes dropped because the Tx Buffer was full
+  sl_iostream_uart_tx_overflow_policy_t tx_overflow_policy; ///< Behavior of writes when the Tx Buffer is full
+  sl_status_t (*tx)(void *context, char c);                 ///< Tx function pointer
+  void (*set_next_byte_detect)(void *context);              ///< Pointer to a function to enable detection of next
+                                                            ///< byte on stream
+  sl_status_t (*deinit)(void *context);                     ///< DeInit function pointer
+  bool lf_to_crlf;                                          ///< lf_to_crlf
 } sl_iostream_uart_context_t;
 
 // -----------------------------------------------------------------------------
@@ -137,6 +158,18 @@ __STATIC_INLINE bool sl_iostream_uart_get_auto_cr_lf(sl_iostream_uart_t *iostrea
   return iostream_uart->get_auto_cr_lf(iostream_uart->stream.context);
 }
 
+/***************************************************************************/ /**
+ * Get the number of bytes dropped because the Tx buffer was full.
+ *
+ * @param[in] iostream_uart   UART stream object.
+ *
+ * @return Number of bytes dropped since initialization.
+ ******************************************************************************/
+__STATIC_INLINE uint32_t sl_iostream_uart_get_tx_dropped(sl_iostream_uart_t *iostream_uart)
+{
+  return iostream_uart->get_tx_dropped(iostream_uart->stream.context);
+}
+
 /***************************************************************************/ /**
  * UART Set next byte detect IRQ.
  *
@@ -37,6 +37,7 @@
 #include "sli_iostream_uart_si91x.h"
 #include "sl_iostream_usart_si91x.h"
 #include "sl_atomic.h"
+#include "em_core.h"
 #include <string.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -47,11 +48,25 @@
  *******************************   DEFINES   ***********************************
  ******************************************************************************/
 
+// Largest number of bytes handed to the USART driver in one transmit, bounded by one DMA descriptor
+#ifndef SL_IOSTREAM_USART_TX_TRANSFER_SIZE
+#define SL_IOSTREAM_USART_TX_TRANSFER_SIZE 1024
+#endif
+
+// Largest number of bytes requested from the USART driver in one receive, 0 for the free space of the receive buffer.
+// In DMA mode received bytes become readable only once a receive completes, so set it to 1 for interactive input.
+#ifndef SL_IOSTREAM_USART_RX_TRANSFER_SIZE
+#define SL_IOSTREAM_USART_RX_TRANSFER_SIZE 0
+#endif
+
 /*******************************************************************************
  **************************   GLOBAL VARIABLES   *******************************
  ******************************************************************************/
 sl_usart_handle_t usart_handle;
 volatile boolean_t send_complete = false, transfer_complete = false, receive_complete = false;
+
+// Context of the stream serviced by callback_event()
+static sl_iostream_uart_context_t *usart_stream_context;
 /*******************************************************************************
  *********************   LOCAL FUNCTION PROTOTYPES   ***************************
  ******************************************************************************/
@@ -66,9 +81,19 @@ static void set_auto_cr_lf(void *context, bool on);
 
 static bool get_auto_cr_lf(void *context);
 
+static uint32_t get_tx_dropped(void *context);
+
 static size_t read_rx_buffer(sl_iostream_uart_context_t *uart_context, uint8_t *buffer, size_t buffer_len);
 static sl_status_t usart_tx(void *context, char c);
 
+static sl_status_t write_tx_buffer(sl_iostream_uart_context_t *uart_context, const uint8_t *data, size_t length);
+
+static void usart_tx_start(sl_iostream_uart_context_t *uart_context);
+
+static void usart_rx_start(sl_iostream_uart_context_t *uart_context);
+
+static void usart_tx_flush(sl_iostream_uart_context_t *uart_context);
+
 static sl_status_t usart_deinit(void *context);
 
 /*******************************************************************************
@@ -118,11 +143,14 @@ sl_status_t sli_iostream_uart_context_init(sl_iostream_uart_t *uart,
   // Configure iostream struct and context
   memset(context, 0, sizeof(*context));
 
-  context->rx_buffer     = config->rx_buffer;
-  context->rx_buffer_len = config->rx_buffer_length;
-  context->lf_to_crlf    = config->lf_to_crlf;
-  context->tx            = tx;
-  context->deinit        = deinit;
+  context->rx_buffer          = config->rx_buffer;
+  context->rx_buffer_len      = config->rx_buffer_length;
+  context->tx_buffer          = config->tx_buffer;
+  context->tx_buffer_len      = config->tx_buffer_length;
+  context->tx_overflow_policy = config->tx_overflow_policy;
+  context->lf_to_crlf         = config->lf_to_crlf;
+  context->tx                 = tx;
+  context->deinit             = deinit;
 
   uart->stream.context = context;
   uart->stream.write   = uart_write;
@@ -130,6 +158,7 @@ sl_status_t sli_iostream_uart_context_init(sl_iostream_uart_t *uart,
   uart->set_auto_cr_lf = set_auto_cr_lf;
   uart->get_auto_cr_lf = get_auto_cr_lf;
   uart->deinit         = uart_deinit;
+  uart->get_tx_dropped = get_tx_dropped;
 
   sl_iostream_set_system_default(&uart->stream);
 
@@ -181,11 +210,18 @@ sl_status_t sl_iostream_usart_init(sl_iostream_uart_t *iostream_uart,
   }
 
   // Register user callback function
+  usart_stream_context = &usart_context->context;
   status = sl_si91x_usart_multiple_instance_register_event_callback(init->usart_module, callback_event);
   if (status != SL_STATUS_OK) {
     return status;
   }
 
+  // Keep a receive pending at all times, so incoming bytes land in the receive buffer without the reader polling
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  usart_rx_start(&usart_context->context);
+  CORE_EXIT_CRITICAL();
+
   return SL_STATUS_OK;
 }
 
@@ -215,31 +251,141 @@ static sl_status_t usart_tx(void *context, char c)
   return SL_STATUS_OK;
 }
 
+/*******************************************************************************
+ * Starts transmitting the oldest contiguous run of the transmit buffer if the
+ * USART is idle. Called from a critical section or the USART interrupt.
+ ******************************************************************************/
+static void usart_tx_start(sl_iostream_uart_context_t *uart_context)
+{
+  size_t length;
+
+  if ((uart_context->tx_active_len != 0) || (uart_context->tx_count == 0)) {
+    return;
+  }
+
+  length = uart_context->tx_buffer_len - uart_context->tx_tail;
+  if (length > uart_context->tx_count) {
+    length = uart_context->tx_count;
+  }
+  if (length > SL_IOSTREAM_USART_TX_TRANSFER_SIZE) {
+    length = SL_IOSTREAM_USART_TX_TRANSFER_SIZE;
+  }
+
+  // The driver moves the run with DMA when it is configured for it, and raises SEND_COMPLETE once it is out
+  if (sl_si91x_usart_send_data(usart_handle, &uart_context->tx_buffer[uart_context->tx_tail], length)
+      == SL_STATUS_OK) {
+    uart_context->tx_active_len = length;
+  }
+}
+
+/*******************************************************************************
+ * Copies data into the transmit buffer and starts transmitting it.
+ * When the buffer is full, waits for room or drops the rest of the data,
+ * depending on the overflow policy.
+ ******************************************************************************/
+static sl_status_t write_tx_buffer(sl_iostream_uart_context_t *uart_context, const uint8_t *data, size_t length)
+{
+  while (length > 0) {
+    size_t head;
+    size_t copy_length;
+
+    CORE_DECLARE_IRQ_STATE;
+    CORE_ENTER_CRITICAL();
+    copy_length = uart_context->tx_buffer_len - uart_context->tx_count;
+    if (copy_length == 0) {
+      usart_tx_start(uart_context);
+      CORE_EXIT_CRITICAL();
+      if (uart_context->tx_overflow_policy == SL_IOSTREAM_UART_TX_OVERFLOW_DROP) {
+        uart_context->tx_dropped += length;
+        return SL_STATUS_WOULD_OVERFLOW;
+      }
+      if (uart_context->tx_active_len == 0) {
+        // Nothing is draining the buffer, the USART refused the transfer
+        return SL_STATUS_FAIL;
+      }
+      // Wait for the interrupt to release the run in flight
+      while (uart_context->tx_count == uart_context->tx_buffer_len)
+        ;
+      continue;
+    }
+
+    head = (uart_context->tx_tail + uart_context->tx_count) % uart_context->tx_buffer_len;
+    if (copy_length > (uart_context->tx_buffer_len - head)) {
+      copy_length = uart_context->tx_buffer_len - head;
+    }
+    if (copy_length > length) {
+      copy_length = length;
+    }
+    memcpy(&uart_context->tx_buffer[head], data, copy_length);
+    uart_context->tx_count += copy_length;
+    usart_tx_start(uart_context);
+    CORE_EXIT_CRITICAL();
+
+    data += copy_length;
+    length -= copy_length;
+  }
+
+  return SL_STATUS_OK;
+}
+
+/*******************************************************************************
+ * Waits until the transmit buffer has been sent.
+ ******************************************************************************/
+static void usart_tx_flush(sl_iostream_uart_context_t *uart_context)
+{
+  while ((uart_context->tx_count != 0) && (uart_context->tx_active_len != 0))
+    ;
+}
+
 /*******************************************************************************
  * Internal stream write implementation
  ******************************************************************************/
 static sl_status_t uart_write(void *context, const void *buffer, size_t buffer_length)
 {
   sl_iostream_uart_context_t *uart_context = (sl_iostream_uart_context_t *)context;
-  char *c                                  = (char *)buffer;
+  const uint8_t *data                      = (const uint8_t *)buffer;
   bool lf_to_crlf                          = false;
-  uint32_t i                               = 0;
-  sl_status_t status                       = SL_STATUS_FAIL;
+  sl_status_t status                       = SL_STATUS_OK;
 
   sl_atomic_load(lf_to_crlf, uart_context->lf_to_crlf);
 
-  while (i < buffer_length) {
-    if (lf_to_crlf == true) {
-      if (*c == '\n') {
+  if (uart_context->tx_buffer == NULL) {
+    // No transmit buffer configured, send byte by byte
+    for (size_t i = 0; i < buffer_length; i++) {
+      if ((lf_to_crlf == true) && (data[i] == '\n')) {
         status = uart_context->tx(uart_context, '\r');
+        if (status != SL_STATUS_OK) {
+          return status;
+        }
+      }
+      status = uart_context->tx(uart_context, (char)data[i]);
+      if (status != SL_STATUS_OK) {
+        return status;
       }
     }
-    status = uart_context->tx(uart_context, *c);
-    if (status != SL_STATUS_OK) {
-      return status;
+    return status;
+  }
+
+  while (buffer_length > 0) {
+    // Queue everything up to the next line feed in one copy, then the expanded line ending
+    const uint8_t *line_feed = lf_to_crlf ? memchr(data, '\n', buffer_length) : NULL;
+    size_t run_length        = (line_feed != NULL) ? (size_t)(line_feed - data) : buffer_length;
+
+    if (run_length > 0) {
+      status = write_tx_buffer(uart_context, data, run_length);
+      if (status != SL_STATUS_OK) {
+        return status;
+      }
+    }
+    if (line_feed != NULL) {
+      status = write_tx_buffer(uart_context, (const uint8_t *)"\r\n", 2);
+      if (status != SL_STATUS_OK) {
+        return status;
+      }
+      run_length++;
     }
-    c++;
-    i++;
+    data += run_length;
+    buffer_length -= run_length;
   }
 
   return status;
@@ -261,32 +407,91 @@ static sl_status_t uart_read(void *context, void *buffer, size_t buffer_length,
   }
 }
 
+/*******************************************************************************
+ * Requests the next receive into the free space of the receive buffer if none
+ * is pending. Called from a critical section or the USART interrupt.
+ ******************************************************************************/
+static void usart_rx_start(sl_iostream_uart_context_t *uart_context)
+{
+  size_t head;
+  size_t length;
+
+  if ((uart_context->rx_buffer_len == 0) || (uart_context->rx_armed_len != 0)
+      || (uart_context->rx_count == uart_context->rx_buffer_len)) {
+    return;
+  }
+
+  head   = (uart_context->rx_tail + uart_context->rx_count) % uart_context->rx_buffer_len;
+  length = uart_context->rx_buffer_len - uart_context->rx_count;
+  if (length > (uart_context->rx_buffer_len - head)) {
+    length = uart_context->rx_buffer_len - head;
+  }
+  if ((SL_IOSTREAM_USART_RX_TRANSFER_SIZE != 0) && (length > SL_IOSTREAM_USART_RX_TRANSFER_SIZE)) {
+    length = SL_IOSTREAM_USART_RX_TRANSFER_SIZE;
+  }
+
+  if (sl_si91x_usart_receive_data(usart_handle, &uart_context->rx_buffer[head], length) == SL_STATUS_OK) {
+    uart_context->rx_armed_len  = length;
+    uart_context->rx_armed_read = 0;
+  }
+}
+
 /*******************************************************************************
  * Tries to read the requested amount of data.
  * Returns the number of bytes read.
  ******************************************************************************/
 static size_t read_rx_buffer(sl_iostream_uart_context_t *uart_context, uint8_t *buffer, size_t buffer_len)
 {
-  size_t ret_val;
-  uint8_t ch;
+  size_t available;
+  size_t read_size;
+  size_t copy_length;
+
+  if (uart_context->rx_buffer_len == 0) {
+    return 0;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  // Bytes of completed receives, followed by the bytes the pending receive has stored so far
+  available = uart_context->rx_count;
+  if (uart_context->rx_armed_len != 0) {
+    available += sl_si91x_usart_get_rx_data_count(usart_handle) - uart_context->rx_armed_read;
+  }
   // read the smallest amount between the data available and the size of the user buffer
-  size_t read_size = buffer_len < uart_context->rx_buffer_len ? buffer_len : uart_context->rx_buffer_len;
-
-  for (ret_val = 0; ret_val < read_size; ret_val++) {
-    // Read the byte received
-    sl_si91x_usart_receive_data(usart_handle, &ch, 1);
-    // wait till data byte receive
-    while (!receive_complete)
-      ;
-    // Clear the variable to receive next byte
-    receive_complete = false;
-    //Copying the char received from USART to buffer
-    uart_context->rx_buffer[ret_val] = ch;
+  read_size = buffer_len < available ? buffer_len : available;
+
+  copy_length = uart_context->rx_buffer_len - uart_context->rx_tail;
+  if (copy_length > read_size) {
+    copy_length = read_size;
   }
-  // Copy the data received in buffer
-  memcpy(buffer, uart_context->rx_buffer, read_size);
+  memcpy(buffer, &uart_context->rx_buffer[uart_context->rx_tail], copy_length);
+  memcpy(&buffer[copy_length], uart_context->rx_buffer, read_size - copy_length);
+  uart_context->rx_tail = (uart_context->rx_tail + read_size) % uart_context->rx_buffer_len;
+
+  // Completed receives are consumed first; the rest comes out of the pending receive
+  if (read_size > uart_context->rx_count) {
+    uart_context->rx_armed_read += read_size - uart_context->rx_count;
+    uart_context->rx_count = 0;
+  } else {
+    uart_context->rx_count -= read_size;
+  }
+  usart_rx_start(uart_context);
+  CORE_EXIT_CRITICAL();
 
-  return ret_val;
+  return read_size;
+}
+
+/*******************************************************************************
+ * Get the number of bytes dropped because the transmit buffer was full
+ ******************************************************************************/
+static uint32_t get_tx_dropped(void *context)
+{
+  sl_iostream_uart_context_t *uart_context = (sl_iostream_uart_context_t *)context;
+  uint32_t dropped;
+
+  sl_atomic_load(dropped, uart_context->tx_dropped);
+
+  return dropped;
 }
 
 /*******************************************************************************
@@ -306,6 +511,9 @@ static sl_status_t uart_deinit(void *stream)
   if ((sl_iostream_uart_t *)default_stream == uart) {
     sl_iostream_set_system_default(NULL);
   }
+  // Let the buffered output drain before the USART goes away
+  usart_tx_flush(uart_context);
+
   // Uninitialize the uart and set the power mode to off
   status = sl_si91x_usart_deinit(usart_handle);
   if (status != SL_STATUS_OK) {
@@ -318,6 +526,8 @@ static sl_status_t uart_deinit(void *stream)
   uart->stream.read    = NULL;
   uart->set_auto_cr_lf = NULL;
   uart->get_auto_cr_lf = NULL;
+  uart->get_tx_dropped = NULL;
+  usart_stream_context = NULL;
 
   status = uart_context->deinit(uart_context);
 
@@ -343,15 +553,28 @@ static sl_status_t usart_deinit(void *context)
  ******************************************************************************/
 void callback_event(uint32_t event)
 {
-  switch (event) {
-    case SL_USART_EVENT_SEND_COMPLETE:
+  sl_iostream_uart_context_t *uart_context = usart_stream_context;
+
+  if (event & (SL_USART_EVENT_SEND_COMPLETE | SL_USART_EVENT_TRANSFER_COMPLETE)) {
+    if ((uart_context != NULL) && (uart_context->tx_active_len != 0)) {
+      // Release the run that went out and start the next one
+      uart_context->tx_tail = (uart_context->tx_tail + uart_context->tx_active_len) % uart_context->tx_buffer_len;
+      uart_context->tx_count -= uart_context->tx_active_len;
+      uart_context->tx_active_len = 0;
+      usart_tx_start(uart_context);
+    } else {
       send_complete = true;
-      break;
-    case SL_USART_EVENT_RECEIVE_COMPLETE:
+    }
+  }
+  if (event & SL_USART_EVENT_RECEIVE_COMPLETE) {
+    if ((uart_context != NULL) && (uart_context->rx_armed_len != 0)) {
+      // Bytes the reader already took from the pending receive are no longer in the buffer
+      uart_context->rx_count += uart_context->rx_armed_len - uart_context->rx_armed_read;
+      uart_context->rx_armed_len  = 0;
+      uart_context->rx_armed_read = 0;
+      usart_rx_start(uart_context);
+    } else {
       receive_complete = true;
-      break;
-    case SL_USART_EVENT_TRANSFER_COMPLETE:
-      send_complete = true;
-      break;
+    }
   }
-}
\ No newline at end of file
+}
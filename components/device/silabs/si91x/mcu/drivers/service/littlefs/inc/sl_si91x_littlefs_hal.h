@@ -44,6 +44,32 @@ extern "C" {
 
 #define QSPI_OK    (0)                                                        // QSPI operation success
 #define QSPI_ERROR (1)                                                        // Error In qspi Opearation
+
+// Read cache line size in bytes, reads smaller than a line are served from the cache
+#ifndef SL_SI91X_LITTLEFS_CACHE_LINE_SIZE
+#define SL_SI91X_LITTLEFS_CACHE_LINE_SIZE LITTLEFS_FLASH_PAGE_SIZE
+#endif
+
+// Number of read cache lines, replaced least recently used first; 0 disables the read cache
+#ifndef SL_SI91X_LITTLEFS_CACHE_LINES
+#define SL_SI91X_LITTLEFS_CACHE_LINES 8
+#endif
+
+// Number of lines read ahead when a cache miss follows a miss on the previous line
+#ifndef SL_SI91X_LITTLEFS_PREFETCH_LINES
+#define SL_SI91X_LITTLEFS_PREFETCH_LINES 2
+#endif
+
+// Size of the buffer that combines consecutive programs into one flash write; 0 programs every call directly
+#ifndef SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE
+#define SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE LITTLEFS_FLASH_PAGE_SIZE
+#endif
+
+// Read the file system region through the memory-mapped QSPI window instead of manual QSPI reads.
+// Enable only when the QSPI stays in auto mode and the region is not held in the M4 instruction cache.
+#ifndef SL_SI91X_LITTLEFS_MEMORY_MAPPED_READ
+#define SL_SI91X_LITTLEFS_MEMORY_MAPPED_READ 0
+#endif
 /***************************************************************************/ /**
  * @brief get the qspi default configs.
  * @details This function containts the default Configurations for QSPI module
@@ -85,6 +111,8 @@ int si91x_block_device_read(const struct lfs_config *cfg,
  * @details Program a region in a block. The block must have previously been erased.
  * Negative error codes are propagated to the user. May return LFS_ERR_CORRUPT
  * if the block should be considered bad.
+ * Programs that continue one another are combined and written to the flash
+ * when the combining buffer fills, on a read or erase, or on sync.
  *
  * @param[in] cfg  littlefs config struct
  * @param[in] block block no to write in region
@@ -113,12 +141,11 @@ int si91x_block_device_erase(const struct lfs_config *cfg, lfs_block_t block);
 
 /***************************************************************************/ /**
  * @brief Sync the state of the underlying block device.
- * @details Sync the state of the underlying block device. if the write function does not
- * perform caching, and therefore each read or write call hits the memory, the
- * sync function can simply return 0.
+ * @details Sync the state of the underlying block device. Programs held in the
+ * write-combining buffer are written to the flash.
  *
  * @param[in] cfg  littlefs config struct
- * @return 0 - QSPI_OK
+ * @return 0 - QSPI_OK for success else error code(1 - QSPI_ERROR)
  ******************************************************************************/
 int si91x_block_device_sync(const struct lfs_config *c);
 #ifdef __cplusplus
@@ -32,6 +32,7 @@
 #include "rsi_rom_qspi.h"
 #include "rsi_rom_egpio.h"
 #include "rsi_rom_clks.h"
+#include <stdbool.h>
 /*******************************************************************************
  ***************************  Defines / Macros  ********************************
  ******************************************************************************/
@@ -81,6 +82,32 @@ extern char linker_littlefs_begin;
 __attribute__((used)) uint8_t littlefs_default_storage[LITTLEFS_DEFAULT_MEM_SIZE] __attribute__((section(".ltfs")));
 #define LITTLEFS_BASE (&linker_littlefs_begin)
 
+#define LITTLEFS_CACHE_LINE_INVALID 0xFFFFFFFF
+
+// QSPI configuration shared by all flash accesses, built once instead of on every call
+static spi_config_t littlefs_spi_config;
+static bool littlefs_spi_config_valid;
+
+#if SL_SI91X_LITTLEFS_CACHE_LINES > 0
+#if SL_SI91X_LITTLEFS_PREFETCH_LINES >= SL_SI91X_LITTLEFS_CACHE_LINES
+#error "SL_SI91X_LITTLEFS_PREFETCH_LINES must be less than SL_SI91X_LITTLEFS_CACHE_LINES"
+#endif
+// Read cache, write-through for programs; each line holds the flash bytes at its line-aligned address
+static uint8_t littlefs_cache_data[SL_SI91X_LITTLEFS_CACHE_LINES][SL_SI91X_LITTLEFS_CACHE_LINE_SIZE];
+static uint32_t littlefs_cache_address[SL_SI91X_LITTLEFS_CACHE_LINES];
+static uint32_t littlefs_cache_last_use[SL_SI91X_LITTLEFS_CACHE_LINES];
+static uint32_t littlefs_cache_use_count;
+static uint32_t littlefs_cache_last_miss = LITTLEFS_CACHE_LINE_INVALID;
+static bool littlefs_cache_valid;
+#endif
+
+#if SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE > 0
+// Consecutive programs not yet written to the flash
+static uint8_t littlefs_write_combine_data[SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE];
+static uint32_t littlefs_write_combine_address;
+static uint32_t littlefs_write_combine_length;
+#endif
+
 /******************************************************************************
  * Configurations for QSPI module
  ******************************************************************************/
@@ -148,6 +175,18 @@ void set_qspi_configs(spi_config_t *spi_config)
   spi_config->spi_config_7.status_reg_read_cmd  = 0x5;
 }
 
+/******************************************************************************
+ * Get the QSPI configuration used for littlefs accesses
+ ******************************************************************************/
+static spi_config_t *si91x_littlefs_spi_config(void)
+{
+  if (!littlefs_spi_config_valid) {
+    set_qspi_configs(&littlefs_spi_config);
+    littlefs_spi_config_valid = true;
+  }
+  return &littlefs_spi_config;
+}
+
 /******************************************************************************
  * QSPI gpio confiurations
  ******************************************************************************/
@@ -203,8 +242,209 @@ void sl_si91x_littlefs_qspi_init()
 
   /* initializes QSPI  */
   RSI_QSPI_SpiInit((qspi_reg_t *)QSPI_BASE, &spi_configs_init, 1, 0, 0);
+
+  littlefs_spi_config       = spi_configs_init;
+  littlefs_spi_config_valid = true;
+}
+
+/******************************************************************************
+ * Read the flash, bypassing the cache
+ ******************************************************************************/
+static void si91x_flash_read(uint32_t flash_addr, uint8_t *buffer, uint32_t size)
+{
+#if SL_SI91X_LITTLEFS_MEMORY_MAPPED_READ
+  memcpy(buffer, (const void *)flash_addr, size);
+#else
+  RSI_QSPI_ManualRead((qspi_reg_t *)QSPI_BASE,
+                      si91x_littlefs_spi_config(),
+                      flash_addr,
+                      buffer,
+                      0 /*_32BIT*/,
+                      size,
+                      0,
+                      0,
+                      0);
+#endif
+}
+
+/******************************************************************************
+ * Program the flash, bypassing the write-combining buffer
+ ******************************************************************************/
+static uint32_t si91x_flash_prog(uint32_t flash_addr, const uint8_t *buffer, uint32_t size)
+{
+  return RSI_QSPI_SpiWrite((qspi_reg_t *)QSPI_BASE,
+                           si91x_littlefs_spi_config(),
+                           0x2,
+                           flash_addr,
+                           (uint8_t *)buffer,
+                           size,
+                           LITTLEFS_FLASH_PAGE_SIZE,
+                           _1BYTE,
+                           0,
+                           0,
+                           0,
+                           0,
+                           0,
+                           0);
+}
+
+/******************************************************************************
+ * Write the programs held in the write-combining buffer to the flash
+ ******************************************************************************/
+static uint32_t si91x_write_combine_flush(void)
+{
+  uint32_t status = QSPI_OK;
+
+#if SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE > 0
+  if (littlefs_write_combine_length != 0) {
+    status = si91x_flash_prog(littlefs_write_combine_address,
+                              littlefs_write_combine_data,
+                              littlefs_write_combine_length);
+    littlefs_write_combine_length = 0;
+  }
+#endif
+  return status;
+}
+
+#if SL_SI91X_LITTLEFS_CACHE_LINES > 0
+/******************************************************************************
+ * Look up the cache line holding a line-aligned flash address, -1 if none
+ ******************************************************************************/
+static int si91x_cache_find(uint32_t line_addr)
+{
+  if (!littlefs_cache_valid) {
+    for (int i = 0; i < SL_SI91X_LITTLEFS_CACHE_LINES; i++) {
+      littlefs_cache_address[i] = LITTLEFS_CACHE_LINE_INVALID;
+    }
+    littlefs_cache_valid = true;
+  }
+  for (int i = 0; i < SL_SI91X_LITTLEFS_CACHE_LINES; i++) {
+    if (littlefs_cache_address[i] == line_addr) {
+      littlefs_cache_last_use[i] = ++littlefs_cache_use_count;
+      return i;
+    }
+  }
+  return -1;
 }
 
+/******************************************************************************
+ * Load a line-aligned flash address into the least recently used cache line
+ ******************************************************************************/
+static int si91x_cache_fill(uint32_t line_addr)
+{
+  int victim = 0;
+
+  for (int i = 0; i < SL_SI91X_LITTLEFS_CACHE_LINES; i++) {
+    if (littlefs_cache_address[i] == LITTLEFS_CACHE_LINE_INVALID) {
+      victim = i;
+      break;
+    }
+    if (littlefs_cache_last_use[i] < littlefs_cache_last_use[victim]) {
+      victim = i;
+    }
+  }
+  si91x_flash_read(line_addr, littlefs_cache_data[victim], SL_SI91X_LITTLEFS_CACHE_LINE_SIZE);
+#if SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE > 0
+  // The line may cover held programs that are not in the flash yet
+  if (littlefs_write_combine_length != 0) {
+    uint32_t start = line_addr;
+    uint32_t end   = line_addr + SL_SI91X_LITTLEFS_CACHE_LINE_SIZE;
+    if (start < littlefs_write_combine_address) {
+      start = littlefs_write_combine_address;
+    }
+    if (end > (littlefs_write_combine_address + littlefs_write_combine_length)) {
+      end = littlefs_write_combine_address + littlefs_write_combine_length;
+    }
+    if (start < end) {
+      memcpy(&littlefs_cache_data[victim][start - line_addr],
+             &littlefs_write_combine_data[start - littlefs_write_combine_address],
+             end - start);
+    }
+  }
+#endif
+  littlefs_cache_address[victim]  = line_addr;
+  littlefs_cache_last_use[victim] = ++littlefs_cache_use_count;
+  return victim;
+}
+
+/******************************************************************************
+ * Read through the cache; a miss on the line after the previous miss is taken
+ * as a sequential read and the following lines are loaded as well
+ ******************************************************************************/
+static void si91x_cache_read(uint32_t flash_addr, uint8_t *buffer, uint32_t size, uint32_t region_end)
+{
+  while (size > 0) {
+    uint32_t line_addr = flash_addr - (flash_addr % SL_SI91X_LITTLEFS_CACHE_LINE_SIZE);
+    uint32_t line_off  = flash_addr - line_addr;
+    uint32_t length    = SL_SI91X_LITTLEFS_CACHE_LINE_SIZE - line_off;
+    int line           = si91x_cache_find(line_addr);
+
+    if (line < 0) {
+      uint32_t last_addr = line_addr;
+
+      line = si91x_cache_fill(line_addr);
+      if (line_addr == (littlefs_cache_last_miss + SL_SI91X_LITTLEFS_CACHE_LINE_SIZE)) {
+        for (uint32_t i = 0; i < SL_SI91X_LITTLEFS_PREFETCH_LINES; i++) {
+          uint32_t prefetch_addr = last_addr + SL_SI91X_LITTLEFS_CACHE_LINE_SIZE;
+          if (((prefetch_addr + SL_SI91X_LITTLEFS_CACHE_LINE_SIZE) > region_end)
+              || (si91x_cache_find(prefetch_addr) >= 0)) {
+            break;
+          }
+          si91x_cache_fill(prefetch_addr);
+          last_addr = prefetch_addr;
+        }
+      }
+      // The next miss continues the sequence if it is on the line after the last one loaded
+      littlefs_cache_last_miss = last_addr;
+    }
+
+    if (length > size) {
+      length = size;
+    }
+    memcpy(buffer, &littlefs_cache_data[line][line_off], length);
+    flash_addr += length;
+    buffer += length;
+    size -= length;
+  }
+}
+
+/******************************************************************************
+ * Update the cached copy of a flash range that has been programmed
+ ******************************************************************************/
+static void si91x_cache_update(uint32_t flash_addr, const uint8_t *buffer, uint32_t size)
+{
+  while (size > 0) {
+    uint32_t line_addr = flash_addr - (flash_addr % SL_SI91X_LITTLEFS_CACHE_LINE_SIZE);
+    uint32_t line_off  = flash_addr - line_addr;
+    uint32_t length    = SL_SI91X_LITTLEFS_CACHE_LINE_SIZE - line_off;
+    int line           = si91x_cache_find(line_addr);
+
+    if (length > size) {
+      length = size;
+    }
+    if (line >= 0) {
+      memcpy(&littlefs_cache_data[line][line_off], buffer, length);
+    }
+    flash_addr += length;
+    buffer += length;
+    size -= length;
+  }
+}
+
+/******************************************************************************
+ * Drop the cache lines of an erased flash range
+ ******************************************************************************/
+static void si91x_cache_invalidate(uint32_t flash_addr, uint32_t size)
+{
+  for (int i = 0; i < SL_SI91X_LITTLEFS_CACHE_LINES; i++) {
+    if ((littlefs_cache_address[i] >= flash_addr) && (littlefs_cache_address[i] < (flash_addr + size))) {
+      littlefs_cache_address[i] = LITTLEFS_CACHE_LINE_INVALID;
+    }
+  }
+  littlefs_cache_last_miss = LITTLEFS_CACHE_LINE_INVALID;
+}
+#endif
+
 /******************************************************************************
  * Read the data from flash
  ******************************************************************************/
@@ -215,25 +455,42 @@ int si91x_block_device_read(const struct lfs_config *cfg,
                             lfs_size_t size)
 {
   uint32_t flash_read_addr = 0, status = QSPI_OK;
-  spi_config_t spi_configs_program;
 
   assert(block < cfg->block_count);
 
   //Calculate the flash read address based on block number and offset
   flash_read_addr = (uint32_t)LITTLEFS_BASE + (block * cfg->block_size) + off;
-  set_qspi_configs(&spi_configs_program);
   if (flash_read_addr == 0) {
     status = QSPI_ERROR;
   }
-  RSI_QSPI_ManualRead((qspi_reg_t *)QSPI_BASE,
-                      &spi_configs_program,
-                      flash_read_addr,
-                      (uint8_t *)buffer,
-                      0 /*_32BIT*/,
-                      size,
-                      0,
-                      0,
-                      0);
+
+#if SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE > 0
+  // Reads of held programs, such as littlefs checking what it just programmed, are served from the combining buffer;
+  // any other read that overlaps them needs them in the flash first
+  uint32_t write_combine_end = littlefs_write_combine_address + littlefs_write_combine_length;
+  if ((littlefs_write_combine_length != 0) && (flash_read_addr < write_combine_end)
+      && ((flash_read_addr + size) > littlefs_write_combine_address)) {
+    if ((flash_read_addr >= littlefs_write_combine_address) && ((flash_read_addr + size) <= write_combine_end)) {
+      memcpy(buffer, &littlefs_write_combine_data[flash_read_addr - littlefs_write_combine_address], size);
+      return status;
+    }
+    if (si91x_write_combine_flush() != QSPI_OK) {
+      status = QSPI_ERROR;
+    }
+  }
+#endif
+
+#if SL_SI91X_LITTLEFS_CACHE_LINES > 0
+  if (size < SL_SI91X_LITTLEFS_CACHE_LINE_SIZE) {
+    si91x_cache_read(flash_read_addr,
+                     (uint8_t *)buffer,
+                     size,
+                     (uint32_t)LITTLEFS_BASE + (cfg->block_count * cfg->block_size));
+    return status;
+  }
+#endif
+  // Reads of a line or more go to the flash in one transfer; the cache is write-through, so it never holds newer data
+  si91x_flash_read(flash_read_addr, (uint8_t *)buffer, size);
 
   return status;
 }
@@ -248,30 +505,39 @@ int si91x_block_device_prog(const struct lfs_config *cfg,
                             lfs_size_t size)
 {
   uint32_t flash_prog_addr = 0, status = QSPI_OK;
-  spi_config_t spi_configs_program;
   assert(block < cfg->block_count);
-  set_qspi_configs(&spi_configs_program);
   //Calculate the flash write address based on block number and offset
   flash_prog_addr = (uint32_t)LITTLEFS_BASE + (block * cfg->block_size) + off;
 
   if (flash_prog_addr == 0) {
-    status = QSPI_ERROR;
+    return QSPI_ERROR;
   }
+
+#if SL_SI91X_LITTLEFS_CACHE_LINES > 0
+  si91x_cache_update(flash_prog_addr, (const uint8_t *)buffer, size);
+#endif
+
+#if SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE > 0
+  // Append to the held programs when this one continues them, otherwise write them out first
+  if ((littlefs_write_combine_length != 0)
+      && ((flash_prog_addr != (littlefs_write_combine_address + littlefs_write_combine_length))
+          || ((littlefs_write_combine_length + size) > SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE))) {
+    status = si91x_write_combine_flush();
+  }
+  if (size < SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE) {
+    if (littlefs_write_combine_length == 0) {
+      littlefs_write_combine_address = flash_prog_addr;
+    }
+    memcpy(&littlefs_write_combine_data[littlefs_write_combine_length], buffer, size);
+    littlefs_write_combine_length += size;
+    if (littlefs_write_combine_length == SL_SI91X_LITTLEFS_WRITE_COMBINE_SIZE) {
+      status |= si91x_write_combine_flush();
+    }
+    return status;
+  }
+#endif
   //Call QSPI write API
-  status = RSI_QSPI_SpiWrite((qspi_reg_t *)QSPI_BASE,
-                             &spi_configs_program,
-                             0x2,
-                             flash_prog_addr,
-                             (uint8_t *)buffer,
-                             size,
-                             LITTLEFS_FLASH_PAGE_SIZE,
-                             _1BYTE,
-                             0,
-                             0,
-                             0,
-                             0,
-                             0,
-                             0);
+  status |= si91x_flash_prog(flash_prog_addr, (const uint8_t *)buffer, size);
 
   return status;
 }
@@ -282,7 +548,6 @@ int si91x_block_device_prog(const struct lfs_config *cfg,
 int si91x_block_device_erase(const struct lfs_config *cfg, lfs_block_t block)
 {
   uint32_t flash_erase_addr = 0, status = QSPI_OK;
-  spi_config_t spi_configs_erase;
 
   assert((block < cfg->block_count));
 
@@ -292,9 +557,12 @@ int si91x_block_device_erase(const struct lfs_config *cfg, lfs_block_t block)
   if (flash_erase_addr == 0)
     status = QSPI_ERROR;
 
-  set_qspi_configs(&spi_configs_erase);
+  status |= si91x_write_combine_flush();
+#if SL_SI91X_LITTLEFS_CACHE_LINES > 0
+  si91x_cache_invalidate(flash_erase_addr, cfg->block_size);
+#endif
   //Call QSPI erase API
-  RSI_QSPI_SpiErase((qspi_reg_t *)QSPI_BASE, &spi_configs_erase, SECTOR_ERASE, flash_erase_addr, 1, 0);
+  RSI_QSPI_SpiErase((qspi_reg_t *)QSPI_BASE, si91x_littlefs_spi_config(), SECTOR_ERASE, flash_erase_addr, 1, 0);
 
   return status;
 }
@@ -305,5 +573,5 @@ int si91x_block_device_erase(const struct lfs_config *cfg, lfs_block_t block)
 int si91x_block_device_sync(const struct lfs_config *c)
 {
   (void)c;
-  return 0;
+  return (int)si91x_write_combine_flush();
 }
@@ -0,0 +1,109 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Background repacking and asynchronous writes for NVM3 on the Si91x common flash
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SL_SI91X_NVM3_BACKGROUND_H
+#define SL_SI91X_NVM3_BACKGROUND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nvm3.h"
+#include "sl_status.h"
+#include <stddef.h>
+
+// Number of asynchronous writes that can be queued for the background thread
+#ifndef SL_SI91X_NVM3_BACKGROUND_QUEUE_SIZE
+#define SL_SI91X_NVM3_BACKGROUND_QUEUE_SIZE 4
+#endif
+
+// Stack size of the background thread in bytes
+#ifndef SL_SI91X_NVM3_BACKGROUND_STACK_SIZE
+#define SL_SI91X_NVM3_BACKGROUND_STACK_SIZE 1024
+#endif
+
+/***************************************************************************/ /**
+ * @brief
+ *   Handler called from the background thread once an asynchronous write has completed.
+ * @param[in] status
+ *   Result of nvm3_writeData().
+ * @param[in] key
+ *   Key of the written object.
+ * @param[in] context
+ *   Context passed to @ref sl_si91x_nvm3_write_data_async.
+ ******************************************************************************/
+typedef void (*sl_si91x_nvm3_write_complete_t)(Ecode_t status, nvm3_ObjectKey_t key, void *context);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Start the low-priority background thread that repacks the default NVM3 instance ahead of time and performs
+ *   asynchronous writes.
+ * @details
+ *   Repacking in the background keeps free pages available, so writes from other threads do not have to repack
+ *   and erase pages themselves. The thread sleeps until the flash is written and then repacks if the user repack
+ *   limit is reached, which NVM3_DEFAULT_REPACK_HEADROOM places above the forced repack limit. This component
+ *   sets NVM3_DEFAULT_REPACK_HEADROOM to 1024, the NVM3 default of 0 leaves no room to repack ahead of writes.
+ *   Calling it again has no effect.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_nvm3_background_init(void);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Queue an NVM3 data object write for the background thread and return without waiting for the flash.
+ * @details
+ *   Starts the background thread if @ref sl_si91x_nvm3_background_init has not been called.
+ * @param[in] handle
+ *   NVM3 instance, for example nvm3_defaultHandle.
+ * @param[in] key
+ *   Key of the object.
+ * @param[in] value
+ *   Object data; it must stay valid and unchanged until complete_handler is called.
+ * @param[in] length
+ *   Object data length in bytes.
+ * @param[in] complete_handler
+ *   Handler called with the write result, may be NULL.
+ * @param[in] context
+ *   Context passed to complete_handler.
+ * @return
+ *   sl_status_t. SL_STATUS_FULL if SL_SI91X_NVM3_BACKGROUND_QUEUE_SIZE writes are already queued.
+ ******************************************************************************/
+sl_status_t sl_si91x_nvm3_write_data_async(nvm3_Handle_t *handle,
+                                           nvm3_ObjectKey_t key,
+                                           const void *value,
+                                           size_t length,
+                                           sl_si91x_nvm3_write_complete_t complete_handler,
+                                           void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SL_SI91X_NVM3_BACKGROUND_H */
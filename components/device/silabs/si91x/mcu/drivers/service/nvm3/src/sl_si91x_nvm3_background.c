@@ -0,0 +1,167 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Background repacking and asynchronous writes for NVM3 on the Si91x common flash
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include "sl_si91x_nvm3_background.h"
+#include "nvm3_default.h"
+#include "cmsis_os2.h"
+#include <stdbool.h>
+
+// Thread flag that wakes the background thread after a write was queued or the flash was written
+#define SLI_SI91X_NVM3_BACKGROUND_WAKE_EVENT (1U << 0)
+
+// Asynchronous write queued for the background thread
+typedef struct {
+  nvm3_Handle_t *handle;
+  nvm3_ObjectKey_t key;
+  const void *value;
+  size_t length;
+  sl_si91x_nvm3_write_complete_t complete_handler;
+  void *context;
+} sli_si91x_nvm3_write_request_t;
+
+static osThreadId_t volatile background_thread;
+static osMessageQueueId_t write_queue;
+
+static const osThreadAttr_t background_thread_attributes = {
+  .name       = "nvm3_background",
+  .attr_bits  = 0,
+  .cb_mem     = 0,
+  .cb_size    = 0,
+  .stack_mem  = 0,
+  .stack_size = SL_SI91X_NVM3_BACKGROUND_STACK_SIZE,
+  .priority   = osPriorityLow,
+  .tz_module  = 0,
+  .reserved   = 0,
+};
+
+static void sli_si91x_nvm3_background_thread(void *args)
+{
+  sli_si91x_nvm3_write_request_t request;
+  (void)args;
+
+  while (1) {
+    // Sleep until something was written, free space only shrinks on writes
+    osThreadFlagsWait(SLI_SI91X_NVM3_BACKGROUND_WAKE_EVENT, osFlagsWaitAny, osWaitForever);
+
+    while (osMessageQueueGet(write_queue, &request, NULL, 0) == osOK) {
+      Ecode_t status = nvm3_writeData(request.handle, request.key, request.value, request.length);
+      if (request.complete_handler != NULL) {
+        request.complete_handler(status, request.key, request.context);
+      }
+      // Repack the instance just written before the next queued write needs the space
+      while (nvm3_repackNeeded(request.handle)) {
+        if (nvm3_repack(request.handle) != ECODE_NVM3_OK) {
+          break;
+        }
+      }
+    }
+
+    // Each call repacks or erases at most one page, so NVM3 users waiting for the lock are held up briefly
+    while ((nvm3_defaultHandle->hasBeenOpened) && nvm3_repackNeeded(nvm3_defaultHandle)
+           && (osMessageQueueGetCount(write_queue) == 0)) {
+      if (nvm3_repack(nvm3_defaultHandle) != ECODE_NVM3_OK) {
+        break;
+      }
+    }
+  }
+}
+
+sl_status_t sl_si91x_nvm3_background_init(void)
+{
+  sl_status_t status = SL_STATUS_OK;
+  // Keep other threads out while the thread and its queue are created, so only one caller creates them
+  int32_t lock = osKernelLock();
+
+  if (background_thread == NULL) {
+    write_queue = osMessageQueueNew(SL_SI91X_NVM3_BACKGROUND_QUEUE_SIZE, sizeof(sli_si91x_nvm3_write_request_t), NULL);
+    if (write_queue != NULL) {
+      background_thread = osThreadNew(sli_si91x_nvm3_background_thread, NULL, &background_thread_attributes);
+    }
+    if (background_thread != NULL) {
+      // Repack whatever writes before the thread started left behind
+      osThreadFlagsSet(background_thread, SLI_SI91X_NVM3_BACKGROUND_WAKE_EVENT);
+    }
+    if (background_thread == NULL) {
+      if (write_queue != NULL) {
+        osMessageQueueDelete(write_queue);
+        write_queue = NULL;
+      }
+      status = SL_STATUS_ALLOCATION_FAILED;
+    }
+  }
+
+  if (lock >= 0) {
+    osKernelRestoreLock(lock);
+  }
+  return status;
+}
+
+sl_status_t sl_si91x_nvm3_write_data_async(nvm3_Handle_t *handle,
+                                           nvm3_ObjectKey_t key,
+                                           const void *value,
+                                           size_t length,
+                                           sl_si91x_nvm3_write_complete_t complete_handler,
+                                           void *context)
+{
+  sli_si91x_nvm3_write_request_t request = {
+    .handle           = handle,
+    .key              = key,
+    .value            = value,
+    .length           = length,
+    .complete_handler = complete_handler,
+    .context          = context,
+  };
+  sl_status_t status;
+
+  if ((handle == NULL) || ((value == NULL) && (length != 0))) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  status = sl_si91x_nvm3_background_init();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  if (osMessageQueuePut(write_queue, &request, 0, 0) != osOK) {
+    return SL_STATUS_FULL;
+  }
+  osThreadFlagsSet(background_thread, SLI_SI91X_NVM3_BACKGROUND_WAKE_EVENT);
+  return SL_STATUS_OK;
+}
+
+void sli_si91x_nvm3_hal_written(void);
+
+// Overrides the HAL default, so every flash write wakes the background thread to check the repack limit
+void sli_si91x_nvm3_hal_written(void)
+{
+  osThreadId_t thread = background_thread;
+
+  if (thread != NULL) {
+    osThreadFlagsSet(thread, SLI_SI91X_NVM3_BACKGROUND_WAKE_EVENT);
+  }
+}
@@ -34,6 +34,7 @@
 #include "sl_si91x_dual_flash_intf.h"
 #endif
 #include "si91x_device.h"
+#include "sl_common.h"
 #include "nvm3.h"
 #include "nvm3_hal_flash.h"
 #include <stdbool.h>
@@ -63,11 +64,23 @@
 #define DEVICE_NUMBER 19
 /* Enable delay for flash (Qspi) operations.*/
 #define CCP_FLASH_DELAY 100000
+/* Largest number of NVM3 pages whose erased state is tracked */
+#ifndef SL_SI91X_NVM3_HAL_MAX_PAGES
+#define SL_SI91X_NVM3_HAL_MAX_PAGES 64
+#endif
 
 /******************************************************************************
  ***************************   LOCAL VARIABLES   ******************************
  *****************************************************************************/
 
+/* NVM3 region passed to open, and a bit per page that is known to be erased
+ * and not written since */
+static uint32_t nvm_base;
+static size_t nvm_size;
+static uint32_t erased_pages[(SL_SI91X_NVM3_HAL_MAX_PAGES + 31) / 32];
+
+void sli_si91x_nvm3_hal_written(void);
+
 /******************************************************************************
  ***************************   LOCAL FUNCTIONS   ******************************
  *****************************************************************************/
@@ -92,9 +105,10 @@ static bool isErased(void *adr, size_t len)
     /* Caluclating the number words */
     cnt = len / sizeof(uint32_t);
     for (i = 0U; i < cnt; i++) {
-      /* checking flash data after page erase */
+      /* checking flash data after page erase, the first programmed word settles it */
       if (*data != 0xFFFFFFFFUL) {
         status = false;
+        break;
       }
       data++;
     }
@@ -102,6 +116,55 @@ static bool isErased(void *adr, size_t len)
   return status;
 }
 
+/***************************************************************************/ /**
+ * Called after each write. Does nothing unless the NVM3 background component
+ * overrides it.
+ ******************************************************************************/
+SL_WEAK void sli_si91x_nvm3_hal_written(void)
+{
+}
+
+/***************************************************************************/ /**
+ * Get the index of the page holding an NVM3 address, -1 if it is not tracked.
+ ******************************************************************************/
+static int32_t pageIndex(uint32_t adr)
+{
+  uint32_t index;
+
+  if ((adr < nvm_base) || (adr >= (nvm_base + nvm_size))) {
+    return -1;
+  }
+  index = (adr - nvm_base) / PAGE_SIZE;
+  return (index < SL_SI91X_NVM3_HAL_MAX_PAGES) ? (int32_t)index : -1;
+}
+
+/***************************************************************************/ /**
+ * Record whether a page is known to be erased.
+ ******************************************************************************/
+static void setPageErased(uint32_t adr, bool erased)
+{
+  int32_t index = pageIndex(adr);
+
+  if (index < 0) {
+    return;
+  }
+  if (erased) {
+    erased_pages[index / 32] |= (1UL << (index % 32));
+  } else {
+    erased_pages[index / 32] &= ~(1UL << (index % 32));
+  }
+}
+
+/***************************************************************************/ /**
+ * Check whether a page is known to be erased.
+ ******************************************************************************/
+static bool isPageErased(uint32_t adr)
+{
+  int32_t index = pageIndex(adr);
+
+  return (index >= 0) && ((erased_pages[index / 32] & (1UL << (index % 32))) != 0);
+}
+
 /***************************************************************************/ /**
  *   This function must be run at initialization, before any other functions
  *   are called. It is used to call necessary startup routines before the
@@ -109,10 +172,13 @@ static bool isErased(void *adr, size_t len)
  ******************************************************************************/
 static Ecode_t nvm3_halFlashOpen(nvm3_HalPtr_t nvmAdr, size_t flashSize)
 {
-  (void)nvmAdr;
-  (void)flashSize;
   Ecode_t halSta = ECODE_NVM3_ERR_NOT_OPENED;
 
+  /* Nothing is known about the erased state of the pages yet */
+  nvm_base = (uint32_t)nvmAdr;
+  nvm_size = flashSize;
+  memset(erased_pages, 0, sizeof(erased_pages));
+
 #if CCP_FLASH_DELAY
   /* Delay is added for flash (Qspi) operations.
    * It is added to resolve target connection lost (mcu reset) issue in SiWx917
@@ -201,6 +267,9 @@ static Ecode_t nvm3_halFlashWriteWords(nvm3_HalPtr_t nvmAdr, void const *src, si
   if ((pDst == NULL) || (pSrc == NULL)) {
     halSta = ECODE_NVM3_ERR_WRITE_FAILED;
   } else {
+    /* The written page, and the next one if the words cross into it, are no longer erased */
+    setPageErased((uint32_t)pDst, false);
+    setPageErased((uint32_t)pDst + byteCnt - 1, false);
     /* Calling this function for flash write */
     if (!(rsi_flash_write(pDst, (unsigned char *)pSrc, byteCnt))) {
       halSta = ECODE_NVM3_OK;
@@ -216,6 +285,9 @@ static Ecode_t nvm3_halFlashWriteWords(nvm3_HalPtr_t nvmAdr, void const *src, si
     }
   }
 #endif
+
+  /* Writes use up free space, let the background repack check whether it needs to run */
+  sli_si91x_nvm3_hal_written();
   return halSta;
 }
 
@@ -229,21 +301,30 @@ static Ecode_t nvm3_halFlashPageErase(nvm3_HalPtr_t nvmAdr)
   //check for NVM3 address is valid or NULL
   if (nvmAdr == NULL) {
     halSta = ECODE_NVM3_ERR_ERASE_FAILED;
+  } else if (isPageErased((uint32_t)nvmAdr)) {
+    /* An erase of this page completed and nothing was written since, so the sector erase and its tens of
+     * milliseconds are not needed. Reading the page as all 0xFF is not enough, an interrupted erase can
+     * leave weakly erased cells that read as erased. */
+    halSta = ECODE_NVM3_OK;
   } else {
     /* Calling this function for flash erase */
     if (!(rsi_flash_erase_sector((uint32_t *)nvmAdr))) {
       halSta = ECODE_NVM3_OK;
     }
-  }
 
-  /* Check if the page is erased */
+    /* Check if the page is erased */
 #if CHECK_DATA
-  if (halSta == ECODE_NVM3_OK) {
-    if (!isErased((nvmAdr), PAGE_SIZE)) {
-      halSta = ECODE_NVM3_ERR_ERASE_FAILED;
+    if (halSta == ECODE_NVM3_OK) {
+      if (!isErased((nvmAdr), PAGE_SIZE)) {
+        halSta = ECODE_NVM3_ERR_ERASE_FAILED;
+      }
     }
-  }
 #endif
+  }
+
+  if (halSta == ECODE_NVM3_OK) {
+    setPageErased((uint32_t)nvmAdr, true);
+  }
   return halSta;
 }
 
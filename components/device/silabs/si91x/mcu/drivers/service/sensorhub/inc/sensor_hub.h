@@ -57,6 +57,18 @@
 #define SL_EM_TASK_RUN_TICKS             osWaitForever ///< Max wait time of message queue in Event task
 #define MAP_TABLE_SIZE                   10            ///< Size of the sensors interrupt MAP table
 
+#ifndef SL_SH_EM_EVENT_QUEUE_DEPTH
+#define SL_SH_EM_EVENT_QUEUE_DEPTH 32 ///< Number of events pending for the EM task, must be a power of two
+#endif
+
+#ifndef SL_SH_EM_MAX_BATCH_SIZE
+#define SL_SH_EM_MAX_BATCH_SIZE 8 ///< Max number of events delivered in one call of the batch callback
+#endif
+
+#if (SL_SH_EM_EVENT_QUEUE_DEPTH & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)) != 0
+#error "SL_SH_EM_EVENT_QUEUE_DEPTH must be a power of two"
+#endif
+
 /*******************************************************************************
  ***********************  GPIO IRQ Defines / Macros  ***************************
  ******************************************************************************/
@@ -169,6 +181,15 @@ typedef struct {
   };
 } sl_data_deliver_type_t;
 
+/// @brief Sample FIFO configuration of a sensor; a depth of 0 keeps the data delivery mode behavior
+
+typedef struct {
+  uint16_t depth;     ///< Number of samples kept, the oldest sample is overwritten when the FIFO is full
+  uint16_t watermark; ///< Number of samples that triggers SL_SENSOR_DATA_READY, 0 for the FIFO depth
+  uint8_t decimation; ///< Number of sensor readings combined into one FIFO sample, 0 or 1 to keep every reading
+  bool average;       ///< Store the average of the combined readings instead of the last reading
+} sl_sensor_fifo_config_t;
+
 /// @brief Storing the Sensor Configurations from the User
 
 typedef struct {
@@ -186,8 +207,27 @@ typedef struct {
   sl_sensor_range_t sensor_range;          ///< Range of sensor
   sl_data_deliver_type_t data_deliver;     ///< Data delivery mode for the sensor
   sl_sensor_data_group_t *sensor_data_ptr; ///< Sensor data storage structure
+  sl_sensor_fifo_config_t fifo;            ///< Sample FIFO, for polling mode sensors other than ADC
 } sl_sensor_info_t;
 
+/// @brief Timestamped sensor sample stored in the sample FIFO
+
+typedef struct {
+  uint32_t timestamp;    ///< Kernel tick count of the last reading of the sample
+  sl_sensor_data_t data; ///< Sensor data
+} sl_sensor_fifo_sample_t;
+
+/// @brief Sample FIFO state of a sensor
+
+typedef struct {
+  sl_sensor_fifo_sample_t *buffer; ///< Sample storage, NULL when the sensor has no FIFO
+  uint16_t head;                   ///< Index of the oldest sample
+  uint16_t count;                  ///< Number of samples in the FIFO
+  uint32_t overruns;               ///< Samples overwritten before they were read
+  uint8_t readings;                ///< Readings combined into the sample being decimated
+  float sum[5];                    ///< Sums of the readings being averaged
+} sl_sensor_fifo_t;
+
 /// @brief Monitoring the Sensors Status.
 
 typedef struct {
@@ -200,6 +240,8 @@ typedef struct {
   sl_sensor_impl_type_t *sensor_impl; ///< Sensor implementation structure
   sl_sensor_status_t sensor_status;   ///< Sensor status
   TimerHandle_t timer_handle;         ///< RTOS timer handle
+  uint32_t event_drops;               ///< Events dropped because the EM event queue was full
+  sl_sensor_fifo_t fifo;              ///< Sample FIFO state
 } sl_sensor_handle_t;
 
 /// @brief Maintaining Sensors list for Polling mode
@@ -233,11 +275,16 @@ typedef struct {
   sl_sensorhub_event_t event; ///< Sensors HUB Callback Events
 } sl_em_event_t;
 
+/// @brief Batch event callback, called with up to SL_SH_EM_MAX_BATCH_SIZE events in posting order
+
+typedef void (*sl_sensor_batch_signalEvent_t)(const sl_em_event_t *events, uint32_t count);
+
 /// @brief Event callback configuration structure
 
 typedef struct {
-  sl_sensor_signalEvent_t cb_event; ///< Event callback
-  sl_sensor_id_t *cb_event_ack;     ///< Event callback acknowledge
+  sl_sensor_signalEvent_t cb_event;             ///< Event callback
+  sl_sensor_id_t *cb_event_ack;                 ///< Event callback acknowledge
+  sl_sensor_batch_signalEvent_t cb_batch_event; ///< Batch event callback, used instead of cb_event when registered
 } sl_sensor_cb_info_t;
 
 /// @brief I2C bus interface configuration structure
@@ -426,12 +473,13 @@ sl_status_t sl_si91x_sensorhub_stop_sensor(sl_sensor_id_t sensor_id);
 * Post the events to event manager(EM) to be notified to the application
 *
 * @details
-* It waits for mutex till ticks_to_wait and updates event queue if mutex is acquired
+* It adds the event to the EM event queue without blocking and wakes up the EM task.
+* If the queue is full the event is dropped and counted against the sensor.
 *
 * @param[in] sensor_id -   id of the  sensor
 * @param[in] event -   sensor hub events
 * @param[in] dataPtr -   sensor data pointer
-* @param[in] ticks_to_wait -   max time to wait for the post
+* @param[in] ticks_to_wait -   unused, posting never blocks
 * @param[out] -   None
 * @return     -   NULL
 *
@@ -625,6 +673,71 @@ sl_sensor_info_t *sli_si91x_get_sensor_info(sl_sensor_id_t sensor_id);
 ******************************************************************************/
 sl_status_t sl_si91x_sensorhub_notify_cb_register(sl_sensor_signalEvent_t cb_event, sl_sensor_id_t *cb_ack);
 
+/***************************************************************************/ /**
+* @brief
+* Batch call back function to the application.
+*
+* @details
+* This function registers a callback that receives the pending events in batches of up to
+* SL_SH_EM_MAX_BATCH_SIZE instead of one call per event. The events point into the EM event queue
+* and are valid until the callback returns. The data of every SL_SENSOR_DATA_READY event in a batch
+* is acknowledged when the callback returns, so the callback must consume or copy the sensor data.
+*
+* @param[in] cb_batch_event  -   Pointer to the batch callback, NULL to go back to per event delivery
+* @param[out] -   None
+* @return     -   If successful returns SL_STATUS_OK
+*
+******************************************************************************/
+sl_status_t sl_si91x_sensorhub_notify_batch_cb_register(sl_sensor_batch_signalEvent_t cb_batch_event);
+
+/***************************************************************************/ /**
+* @brief
+* Get the number of events dropped for a sensor.
+*
+* @details
+* Posting an event never blocks; when the EM event queue is full the event is dropped and
+* counted against its sensor. A dropped SL_SENSOR_DATA_READY event is posted again with the next sample.
+*
+* @param[in] sensor_id   -   Sensor ID
+* @param[out] drops      -   Number of events dropped since the sensor was created
+* @return     -   If successful returns SL_STATUS_OK else returns error code
+*
+******************************************************************************/
+sl_status_t sl_si91x_sensorhub_get_event_drops(sl_sensor_id_t sensor_id, uint32_t *drops);
+
+/***************************************************************************/ /**
+* @brief
+* Read samples from the sample FIFO of a sensor.
+*
+* @details
+* Sensors configured with a FIFO depth are sampled regardless of pending acknowledges and
+* notify SL_SENSOR_DATA_READY once the FIFO reaches its watermark. This function removes up
+* to max_samples samples from the FIFO, oldest first.
+*
+* @param[in] sensor_id     -   Sensor ID
+* @param[out] samples      -   Buffer that receives the samples
+* @param[in] max_samples   -   Number of samples that fit in the buffer
+* @param[out] count        -   Number of samples read
+* @return     -   If successful returns SL_STATUS_OK else returns error code
+*
+******************************************************************************/
+sl_status_t sl_si91x_sensorhub_read_fifo(sl_sensor_id_t sensor_id,
+                                         sl_sensor_fifo_sample_t *samples,
+                                         uint32_t max_samples,
+                                         uint32_t *count);
+
+/***************************************************************************/ /**
+* @brief
+* Get the fill level of the sample FIFO of a sensor.
+*
+* @param[in] sensor_id   -   Sensor ID
+* @param[out] count      -   Number of samples in the FIFO
+* @param[out] overruns   -   Samples overwritten before they were read, may be NULL
+* @return     -   If successful returns SL_STATUS_OK else returns error code
+*
+******************************************************************************/
+sl_status_t sl_si91x_sensorhub_get_fifo_status(sl_sensor_id_t sensor_id, uint32_t *count, uint32_t *overruns);
+
 /***************************************************************************/ /**
 * @brief
 * Sensor OS timer callback function.
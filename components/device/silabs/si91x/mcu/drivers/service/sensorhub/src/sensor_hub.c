@@ -67,7 +67,9 @@
 /*******************************************************************************
  ********************** Sensor HUB Defines / Macros  ***************************
  ******************************************************************************/
-#define SENSORS_RAM_SIZE            4096 //< This RAM is used the store all sensor's data
+#ifndef SENSORS_RAM_SIZE
+#define SENSORS_RAM_SIZE 4096 //< This RAM is used the store all sensor's data and sample FIFOs
+#endif
 #define ALARM_WAKEUP_SOURCE         1    //< This is for the Alarm based wakup
 #define GPIO_WAKEUP_SOURCE          0    //< This is for the UULP_GPIO based wakup
 #define SL_SH_SOCLDOTURNONWAITTIME  31
@@ -138,13 +140,16 @@ sl_sensor_cb_info_t cb_info; //< sensor call back handler
 /*******************************************************************************
  ******************  CMSIS OS handlers/Variables   *****************************
  ******************************************************************************/
-QueueHandle_t sl_event_queue_handler; //< Event queue handler
+#define SL_EM_EVENT_POSTED_FLAG 0x1 //< EM task thread flag for posted events
+
+static sl_em_event_t sl_em_event_queue[SL_SH_EM_EVENT_QUEUE_DEPTH]; //< Event queue, read only by the EM task
+
+static volatile uint32_t sl_em_event_head;  //< Number of events posted
+static volatile uint32_t sl_em_event_tail;  //< Number of events delivered
+static osThreadId_t sl_em_thread_id = NULL; //< EM task, woken up by the event posts
 
-SemaphoreHandle_t sl_event_queue_mutex;   //< Event Mutux handler
 SemaphoreHandle_t sl_sensor_mutex = NULL; //< Sensor Mutux handler
 
-osMessageQueueAttr_t sl_osMessageQueueAttr; //< OS message queue attributes
-osMutexAttr_t sl_em_osMutexAttr_t;          //< EM task mutux attributes
 osMutexAttr_t sl_osMutexAttr_t;             //< Sensor task mutux attributes
 osEventFlagsAttr_t sl_eventFlagsAttr;       //< Event creation attributes
 EventGroupHandle_t sl_event_group = NULL;   //< Event group handler
@@ -647,6 +652,42 @@ sl_status_t sl_si91x_sensorhub_notify_cb_register(sl_sensor_signalEvent_t cb_eve
   return SL_STATUS_OK;
 }
 
+/**************************************************************************/ /**
+ *  @fn          sl_status_t sl_si91x_sensorhub_notify_batch_cb_register(
+ *                    sl_sensor_batch_signalEvent_t cb_batch_event)
+ *  @brief       To register the application batch callback handler
+ *  @param[in]   cb_batch_event  pointer to the batch handler, NULL to unregister
+*******************************************************************************/
+sl_status_t sl_si91x_sensorhub_notify_batch_cb_register(sl_sensor_batch_signalEvent_t cb_batch_event)
+{
+  cb_info.cb_batch_event = cb_batch_event;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************/ /**
+ *  @fn          sl_status_t sl_si91x_sensorhub_get_event_drops(sl_sensor_id_t sensor_id,
+ *                    uint32_t *drops)
+ *  @brief       To get the number of events dropped for a sensor
+ *  @param[in]   sensor_id     id of the target sensor
+ *  @param[out]  drops         number of dropped events
+*******************************************************************************/
+sl_status_t sl_si91x_sensorhub_get_event_drops(sl_sensor_id_t sensor_id, uint32_t *drops)
+{
+  uint32_t sensor_index;
+
+  if (drops == NULL) {
+    return SL_SH_INVALID_PARAMETERS;
+  }
+  sensor_index = sli_si91x_get_sensor_index(sensor_id);
+  if (sensor_index == SL_SH_SENSOR_INDEX_NOT_FOUND) {
+    return SL_SH_SENSOR_INDEX_NOT_FOUND;
+  }
+  *drops = sensor_list.sl_sensors_st[sensor_index].event_drops;
+
+  return SL_STATUS_OK;
+}
+
 /**************************************************************************/ /**
  *  @fn          void sl_si91x_sensors_timer_cb(TimerHandle_t xTimer)
  *  @brief       software timer callback
@@ -1169,6 +1210,21 @@ sl_status_t sl_si91x_sensorhub_create_sensor(sl_sensor_id_t sensor_id)
   sensor_list.sl_sensors_st[sensor_index].max_samples = (ramAllocationSize - 2) / sizeof(sl_sensor_data_t);
   //}
 
+  /*Allocate the sample FIFO, the readings of ADC sensors are already buffered by the ADC FIFO*/
+  memset(&sensor_list.sl_sensors_st[sensor_index].fifo, 0, sizeof(sl_sensor_fifo_t));
+  if (local_info->fifo.depth != 0) {
+    if ((local_info->sensor_mode != SL_SH_POLLING_MODE) || (local_info->sensor_bus == SL_SH_ADC)) {
+      return SL_SH_INVALID_MODE;
+    }
+    ramAllocationSize = local_info->fifo.depth * sizeof(sl_sensor_fifo_sample_t);
+    ramAllocationSize = (ramAllocationSize + 3) & ~3U;
+    if ((free_ram_index + ramAllocationSize) > sizeof(sensor_data_ram)) {
+      return SL_SH_MEMORY_LIMIT_EXCEEDED;
+    }
+    sensor_list.sl_sensors_st[sensor_index].fifo.buffer = (sl_sensor_fifo_sample_t *)&sensor_data_ram[free_ram_index];
+    free_ram_index += ramAllocationSize;
+  }
+
   /*Find the Sensor HAL Implementation*/
   sensor_list.sl_sensors_st[sensor_index].sensor_impl =
     sli_si91x_get_sensor_implementation((sensor_id & SL_SENSOR_ID_MASK) >> SL_SENSOR_ID_OFFSET);
@@ -1260,6 +1316,7 @@ sl_status_t sl_si91x_sensorhub_create_sensor(sl_sensor_id_t sensor_id)
 
   /* update sensor status into sensor list */
   sensor_list.sl_sensors_st[sensor_index].sensor_status = SL_SENSOR_VALID;
+  sensor_list.sl_sensors_st[sensor_index].event_drops   = 0;
 
   return SL_STATUS_OK;
 }
@@ -1465,24 +1522,59 @@ void sl_si91x_em_post_event(sl_sensor_id_t sensor_id,
                             void *dataPtr,
                             TickType_t ticks_to_wait)
 {
-  sl_em_event_t em_event;
-  em_event.sensor_id      = sensor_id;
-  em_event.event          = event;
-  em_event.em_sensor_data = dataPtr;
-
-  BaseType_t mutex_result = pdFALSE;
-  mutex_result            = osMutexAcquire(sl_event_queue_mutex, ticks_to_wait);
-  if (mutex_result != osOK) {
-    DEBUGOUT("\r\n osMutexAcquire failed in Sensor_Task:%u \r\n", (uint8_t)mutex_result);
-  }
-  mutex_result = osMessageQueuePut(sl_event_queue_handler, &em_event, 0U, 0U);
-  if (mutex_result == osOK) {
-    //xSemaphoreGiveRecursive(event_queue_mutex);
-    mutex_result = osMutexRelease(sl_event_queue_mutex);
-
-    if (mutex_result != osOK) {
-      DEBUGOUT("\r\n osMutexRelease failed in em task:%u \r\n", (uint8_t)mutex_result);
+  uint32_t primask;
+  uint32_t head;
+  uint32_t sensor_index;
+  bool posted = false;
+  osThreadId_t em_thread_id;
+  (void)ticks_to_wait;
+
+  // Posting tasks only serialize among themselves for the slot claim; the EM task reads the queue without locking
+  primask = __get_PRIMASK();
+  __disable_irq();
+  head = sl_em_event_head;
+  if ((head - sl_em_event_tail) < SL_SH_EM_EVENT_QUEUE_DEPTH) {
+    sl_em_event_queue[head & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)].sensor_id      = sensor_id;
+    sl_em_event_queue[head & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)].event          = event;
+    sl_em_event_queue[head & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)].em_sensor_data = dataPtr;
+    __DMB();
+    sl_em_event_head = head + 1;
+    posted           = true;
+  }
+  __set_PRIMASK(primask);
+
+  if (!posted) {
+    // Queue full: count the drop, and let the sensor task post the data ready event again with the next sample
+    sensor_index = sli_si91x_get_sensor_index(sensor_id);
+    if (sensor_index != SL_SH_SENSOR_INDEX_NOT_FOUND) {
+      sensor_list.sl_sensors_st[sensor_index].event_drops++;
+      if (event == SL_SENSOR_DATA_READY) {
+        sensor_list.sl_sensors_st[sensor_index].event_ack = CLEAR_EVENT_ACK;
+      }
     }
+    DEBUGOUT("\r\n EM event queue full, event %d of sensor %d dropped \r\n", event, sensor_id);
+    return;
+  }
+
+  // Events posted before the EM task runs are delivered when it starts
+  em_thread_id = sl_em_thread_id;
+  if (em_thread_id != NULL) {
+    osThreadFlagsSet(em_thread_id, SL_EM_EVENT_POSTED_FLAG);
+  }
+}
+
+/**************************************************************************/ /**
+ *  @fn          static void sli_si91x_em_clear_event_ack(sl_sensor_id_t sensor_id)
+ *  @brief       To release the sensor data of an acknowledged sensor
+ *  @param[in]   sensor_id     id of the acknowledged sensor
+*******************************************************************************/
+static void sli_si91x_em_clear_event_ack(sl_sensor_id_t sensor_id)
+{
+  uint32_t sensor_index = sli_si91x_get_sensor_index(sensor_id);
+
+  if (sensor_index != SL_SH_SENSOR_INDEX_NOT_FOUND) {
+    sensor_list.sl_sensors_st[sensor_index].config_st->sensor_data_ptr->number = 0;
+    sensor_list.sl_sensors_st[sensor_index].event_ack                          = CLEAR_EVENT_ACK;
   }
 }
 
@@ -1492,51 +1584,46 @@ void sl_si91x_em_post_event(sl_sensor_id_t sensor_id,
 *******************************************************************************/
 void sl_si91x_em_task(void)
 {
-
-  sl_em_event_t em_event;
+  const sl_em_event_t *em_events;
+  uint32_t em_event_count;
+  uint32_t tail;
+  uint32_t i;
+#if defined(SL_SH_POWER_STATE_TRANSITIONS) || defined(SL_SH_PS1_STATE)
+  bool em_data_ready;
+#endif
   osStatus_t sl_semcq_status;
-  sl_status_t em_wlan_status;
-  sl_osMessageQueueAttr.name      = NULL;
-  sl_osMessageQueueAttr.attr_bits = 0;
-  sl_osMessageQueueAttr.cb_mem    = NULL;
-  sl_osMessageQueueAttr.cb_size   = 0;
-  sl_osMessageQueueAttr.mq_mem    = NULL;
-  sl_osMessageQueueAttr.mq_size   = 0;
-
-  sl_em_osMutexAttr_t.name      = NULL;
-  sl_em_osMutexAttr_t.attr_bits = 0;
-  sl_em_osMutexAttr_t.cb_mem    = NULL;
-  sl_em_osMutexAttr_t.cb_size   = 0;
-
-  osStatus_t sl_em_mutex_acc_status = 0, sl_em_mutex_rel_status = 0, sl_semrel_status = 0;
-  sl_semaphore_em_task_id = osSemaphoreNew(1U, 0U, NULL);
-
-  /*Create an Event Queue*/
-  sl_event_queue_handler = osMessageQueueNew(20, sizeof(sl_em_event_t), &sl_osMessageQueueAttr); //CMSIS V2 API
-  if (sl_event_queue_handler == NULL) {
-    DEBUGOUT("create event queue failed");
-    while (1)
-      ;
-  }
+  osStatus_t sl_semrel_status = 0;
+  sl_sensor_id_t em_ack;
 
-  sl_event_queue_mutex = osMutexNew(&sl_em_osMutexAttr_t);
-  if (sl_event_queue_mutex == NULL) {
-    DEBUGOUT("create event mutex failed");
-    while (1)
-      ;
-  }
+  sl_semaphore_em_task_id = osSemaphoreNew(1U, 0U, NULL);
+  sl_em_thread_id         = osThreadGetId();
 
   while (1) {
-    /*Wait for the Event on Queue*/
-    while ((osMessageQueueGet(sl_event_queue_handler, &em_event, NULL, SL_EM_TASK_RUN_TICKS)) == osOK) {
+    /*Deliver the posted events, a contiguous run of the queue at a time*/
+    tail = sl_em_event_tail;
+    while (sl_em_event_head != tail) {
+      __DMB();
+      em_event_count = sl_em_event_head - tail;
+      if (em_event_count > (SL_SH_EM_EVENT_QUEUE_DEPTH - (tail & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)))) {
+        em_event_count = SL_SH_EM_EVENT_QUEUE_DEPTH - (tail & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1));
+      }
+      if (cb_info.cb_batch_event == NULL) {
+        em_event_count = 1;
+      } else if (em_event_count > SL_SH_EM_MAX_BATCH_SIZE) {
+        em_event_count = SL_SH_EM_MAX_BATCH_SIZE;
+      }
+      em_events = &sl_em_event_queue[tail & (SL_SH_EM_EVENT_QUEUE_DEPTH - 1)];
 
-      /*Acquire the mutex*/
-      sl_em_mutex_acc_status = osMutexAcquire(sl_event_queue_mutex, osWaitForever);
-      if (sl_em_mutex_acc_status != osOK) {
-        DEBUGOUT("\r\n Mutex Acquire fail:%d \r\n", sl_em_mutex_acc_status);
+#if defined(SL_SH_POWER_STATE_TRANSITIONS) || defined(SL_SH_PS1_STATE)
+      em_data_ready = false;
+      for (i = 0; i < em_event_count; i++) {
+        if (em_events[i].event == SL_SENSOR_DATA_READY) {
+          em_data_ready = true;
+        }
       }
+#endif
 #ifdef SL_SH_POWER_STATE_TRANSITIONS
-      if (em_event.event == SL_SENSOR_DATA_READY) {
+      if (em_data_ready) {
         if (sl_ps4_ps2_done == SL_PWR_STATE_SWICTH_DONE) {
           sl_ps4_ps2_done     = 0;
           sl_power_state_enum = SL_SH_PS2TOPS4;
@@ -1552,22 +1639,25 @@ void sl_si91x_em_task(void)
         }
       }
 #endif
-      /*Call the handler and notify the event */
-      cb_info.cb_event(em_event.sensor_id, em_event.event, em_event.em_sensor_data);
-
-      if (*cb_info.cb_event_ack != SL_STATUS_OK) {
-        for (uint8_t i = 0; i < SL_MAX_NUM_SENSORS; i++) {
-          if (sensor_list.sl_sensors_st[i].config_st->sensor_id == *cb_info.cb_event_ack) {
-            sensor_list.sl_sensors_st[i].config_st->sensor_data_ptr->number = 0;
-            sensor_list.sl_sensors_st[i].event_ack                          = CLEAR_EVENT_ACK;
-            *cb_info.cb_event_ack                                           = (sl_sensor_id_t)NULL;
+      /*Call the handler and notify the events; the queue slots stay owned by this task until the tail moves*/
+      if (cb_info.cb_batch_event != NULL) {
+        cb_info.cb_batch_event(em_events, em_event_count);
+        for (i = 0; i < em_event_count; i++) {
+          if (em_events[i].event == SL_SENSOR_DATA_READY) {
+            sli_si91x_em_clear_event_ack(em_events[i].sensor_id);
           }
         }
+      } else if (cb_info.cb_event != NULL) {
+        cb_info.cb_event(em_events[0].sensor_id, em_events[0].event, em_events[0].em_sensor_data);
       }
-      /*Release the mutex*/
-      sl_em_mutex_rel_status = osMutexRelease(sl_event_queue_mutex);
-      if (sl_em_mutex_rel_status != osOK) {
-        DEBUGOUT("\r\n Mutex Release fail:%d\r\n", sl_em_mutex_rel_status);
+      tail += em_event_count;
+      __DMB();
+      sl_em_event_tail = tail;
+
+      if ((cb_info.cb_event_ack != NULL) && (*cb_info.cb_event_ack != SL_STATUS_OK)) {
+        em_ack                = *cb_info.cb_event_ack;
+        *cb_info.cb_event_ack = (sl_sensor_id_t)NULL;
+        sli_si91x_em_clear_event_ack(em_ack);
       }
 #if SH_AWS_ENABLE
       sl_semrel_status = osSemaphoreRelease(sl_semaphore_aws_task_id);
@@ -1581,7 +1671,7 @@ void sl_si91x_em_task(void)
       }
 #endif
 #ifdef SL_SH_POWER_STATE_TRANSITIONS
-      if (em_event.event == SL_SENSOR_DATA_READY) {
+      if (em_data_ready) {
         if (sl_ps4_ps2_done != SL_PWR_STATE_SWICTH_DONE) {
           sl_power_state_enum = SL_SH_PS4TOPS2;
           sl_semrel_status    = osSemaphoreRelease(sl_semaphore_power_task_id);
@@ -1597,8 +1687,7 @@ void sl_si91x_em_task(void)
       }
 #endif
 #ifdef SL_SH_PS1_STATE
-      osStatus_t sl_semrel_status;
-      if (em_event.event == SL_SENSOR_DATA_READY) {
+      if (em_data_ready) {
         sl_power_state_enum = SL_SH_SLEEP_WAKEUP;
         sl_semrel_status    = osSemaphoreRelease(sl_semaphore_power_task_id);
         if (sl_semrel_status != osOK) {
@@ -1606,19 +1695,195 @@ void sl_si91x_em_task(void)
         }
       }
 #endif
-    } //end of os_message Queue
-    if (*cb_info.cb_event_ack != SL_STATUS_OK) {
-      for (uint8_t i = 0; i < SL_MAX_NUM_SENSORS; i++) {
-        if (sensor_list.sl_sensors_st[i].config_st->sensor_id == *cb_info.cb_event_ack) {
-          sensor_list.sl_sensors_st[i].config_st->sensor_data_ptr->number = 0;
-          sensor_list.sl_sensors_st[i].event_ack                          = CLEAR_EVENT_ACK;
-          *cb_info.cb_event_ack                                           = (sl_sensor_id_t)NULL;
-        }
-      }
+    } //end of event delivery
+
+    /*Wait for the next posted event*/
+    osThreadFlagsWait(SL_EM_EVENT_POSTED_FLAG, osFlagsWaitAny, SL_EM_TASK_RUN_TICKS);
+
+    if ((cb_info.cb_event_ack != NULL) && (*cb_info.cb_event_ack != SL_STATUS_OK)) {
+      em_ack                = *cb_info.cb_event_ack;
+      *cb_info.cb_event_ack = (sl_sensor_id_t)NULL;
+      sli_si91x_em_clear_event_ack(em_ack);
     } //end of if
   }   // end of while(1);
 } //end of file
 
+/**************************************************************************/ /**
+ *  @fn          static uint8_t sli_si91x_sensor_fifo_fields(sl_sensor_id_t sensor_id,
+ *                    sl_sensor_data_t *data, float **fields)
+ *  @brief       To get the fields of a sensor reading that are averaged
+ *  @param[in]   sensor_id     id of the sensor
+ *  @param[in]   data          sensor reading
+ *  @param[out]  fields        first field, the fields are consecutive floats
+ *  @return      number of fields, 0 if the readings of the sensor are not averaged
+*******************************************************************************/
+static uint8_t sli_si91x_sensor_fifo_fields(sl_sensor_id_t sensor_id, sl_sensor_data_t *data, float **fields)
+{
+  switch ((sensor_id & SL_SENSOR_ID_MASK) >> SL_SENSOR_ID_OFFSET) {
+    case SL_TEMPERATURE_SENSOR_ID:
+      *fields = &data->temperature;
+      return 1;
+
+    case SL_LIGHT_SENSOR_ID:
+      // Light, UV and RGBW readings all start at the first field
+      *fields = &data->rgbw.r;
+      return 4;
+
+    case SL_GESTURE_PROXIMITY_RGB_SENSOR_ID:
+      *fields = &data->rgbw.r;
+      return 5;
+
+    case SL_ACCELEROMETER_SENSOR_ID:
+      *fields = &data->accelerometer.x;
+      return 3;
+
+    default:
+      return 0;
+  }
+}
+
+/**************************************************************************/ /**
+ *  @fn          static void sli_si91x_sensor_fifo_sample(sl_sensor_handle_t *sensor)
+ *  @brief       To take a reading of a sensor with a sample FIFO, called by the sensor task
+ *  @param[in]   sensor     sensor handle
+*******************************************************************************/
+static void sli_si91x_sensor_fifo_sample(sl_sensor_handle_t *sensor)
+{
+  sl_sensor_info_t *config = sensor->config_st;
+  sl_sensor_fifo_t *fifo   = &sensor->fifo;
+  sl_sensor_fifo_sample_t *sample;
+  sl_sensor_data_t *reading;
+  float *fields;
+  uint8_t field_count = 0;
+  uint16_t watermark;
+  int32_t status;
+
+  /*Readings go to the first entry of the data group and are folded into the FIFO right away, so
+    the sensor keeps sampling while the application has not acknowledged the previous notification*/
+  config->sensor_data_ptr->number = 0;
+  status = sensor->sensor_impl->sample(sensor->sensor_handle, config->sensor_data_ptr);
+  if ((status != SL_STATUS_OK) || (config->sensor_data_ptr->number == 0)) {
+    DEBUGOUT("\r\n Sensor polling sample fail:%d \r\n", config->sensor_id);
+    return;
+  }
+  reading = &config->sensor_data_ptr->sensor_data[0];
+
+  if (config->fifo.average) {
+    field_count = sli_si91x_sensor_fifo_fields(config->sensor_id, reading, &fields);
+    for (uint8_t field = 0; field < field_count; field++) {
+      fifo->sum[field] = (fifo->readings == 0) ? fields[field] : (fifo->sum[field] + fields[field]);
+    }
+  }
+  fifo->readings++;
+  if (fifo->readings < config->fifo.decimation) {
+    return;
+  }
+
+  if (fifo->count == config->fifo.depth) {
+    fifo->head = (fifo->head + 1) % config->fifo.depth;
+    fifo->count--;
+    fifo->overruns++;
+  }
+  sample            = &fifo->buffer[(fifo->head + fifo->count) % config->fifo.depth];
+  sample->timestamp = osKernelGetTickCount();
+  sample->data      = *reading;
+  if (field_count != 0) {
+    sli_si91x_sensor_fifo_fields(config->sensor_id, &sample->data, &fields);
+    for (uint8_t field = 0; field < field_count; field++) {
+      fields[field] = fifo->sum[field] / fifo->readings;
+    }
+  }
+  fifo->readings = 0;
+  fifo->count++;
+
+  /*Notify the application once per watermark instead of once per reading*/
+  watermark = config->fifo.watermark;
+  if ((watermark == 0) || (watermark > config->fifo.depth)) {
+    watermark = config->fifo.depth;
+  }
+  if ((fifo->count >= watermark) && (sensor->event_ack == CLEAR_EVENT_ACK)) {
+    sensor->event_ack = SET_EVENT_ACK;
+    sl_si91x_em_post_event(config->sensor_id, SL_SENSOR_DATA_READY, config->sensor_data_ptr, EM_POST_TIME);
+  }
+}
+
+/**************************************************************************/ /**
+ *  @fn          sl_status_t sl_si91x_sensorhub_read_fifo(sl_sensor_id_t sensor_id,
+ *                    sl_sensor_fifo_sample_t *samples, uint32_t max_samples, uint32_t *count)
+ *  @brief       To read samples from the sample FIFO of a sensor
+ *  @param[in]   sensor_id     id of the target sensor
+ *  @param[out]  samples       buffer that receives the samples
+ *  @param[in]   max_samples   number of samples that fit in the buffer
+ *  @param[out]  count         number of samples read
+*******************************************************************************/
+sl_status_t sl_si91x_sensorhub_read_fifo(sl_sensor_id_t sensor_id,
+                                         sl_sensor_fifo_sample_t *samples,
+                                         uint32_t max_samples,
+                                         uint32_t *count)
+{
+  sl_sensor_handle_t *sensor;
+  uint32_t sensor_index;
+  uint32_t read = 0;
+
+  if ((samples == NULL) || (count == NULL)) {
+    return SL_SH_INVALID_PARAMETERS;
+  }
+  sensor_index = sli_si91x_get_sensor_index(sensor_id);
+  if (sensor_index == SL_SH_SENSOR_INDEX_NOT_FOUND) {
+    return SL_SH_SENSOR_INDEX_NOT_FOUND;
+  }
+  sensor = &sensor_list.sl_sensors_st[sensor_index];
+  if (sensor->fifo.buffer == NULL) {
+    return SL_SH_INVALID_DELIVERY_MODE;
+  }
+
+  /*The sensor task fills the FIFO while holding the sensor mutex*/
+  if (sl_sensor_mutex != NULL) {
+    osMutexAcquire(sl_sensor_mutex, osWaitForever);
+  }
+  while ((read < max_samples) && (sensor->fifo.count != 0)) {
+    samples[read++]   = sensor->fifo.buffer[sensor->fifo.head];
+    sensor->fifo.head = (sensor->fifo.head + 1) % sensor->config_st->fifo.depth;
+    sensor->fifo.count--;
+  }
+  if (sl_sensor_mutex != NULL) {
+    osMutexRelease(sl_sensor_mutex);
+  }
+  *count = read;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************/ /**
+ *  @fn          sl_status_t sl_si91x_sensorhub_get_fifo_status(sl_sensor_id_t sensor_id,
+ *                    uint32_t *count, uint32_t *overruns)
+ *  @brief       To get the fill level of the sample FIFO of a sensor
+ *  @param[in]   sensor_id     id of the target sensor
+ *  @param[out]  count         number of samples in the FIFO
+ *  @param[out]  overruns      samples overwritten before they were read, may be NULL
+*******************************************************************************/
+sl_status_t sl_si91x_sensorhub_get_fifo_status(sl_sensor_id_t sensor_id, uint32_t *count, uint32_t *overruns)
+{
+  uint32_t sensor_index;
+
+  if (count == NULL) {
+    return SL_SH_INVALID_PARAMETERS;
+  }
+  sensor_index = sli_si91x_get_sensor_index(sensor_id);
+  if (sensor_index == SL_SH_SENSOR_INDEX_NOT_FOUND) {
+    return SL_SH_SENSOR_INDEX_NOT_FOUND;
+  }
+  if (sensor_list.sl_sensors_st[sensor_index].fifo.buffer == NULL) {
+    return SL_SH_INVALID_DELIVERY_MODE;
+  }
+  *count = sensor_list.sl_sensors_st[sensor_index].fifo.count;
+  if (overruns != NULL) {
+    *overruns = sensor_list.sl_sensors_st[sensor_index].fifo.overruns;
+  }
+
+  return SL_STATUS_OK;
+}
+
 /**************************************************************************/ /**
  *  @fn          void sl_si91x_sensor_task(void)
  *  @brief       Task to handle the sensor operations.
@@ -1668,7 +1933,9 @@ void sl_si91x_sensor_task(void)
     i = 0;
     while (event_flags) {
 
-      if ((event_flags & 0x1) == 0x1) {
+      if (((event_flags & 0x1) == 0x1) && (sensor_list.sl_sensors_st[i].fifo.buffer != NULL)) {
+        sli_si91x_sensor_fifo_sample(&sensor_list.sl_sensors_st[i]);
+      } else if ((event_flags & 0x1) == 0x1) {
 
         if (sensor_list.sl_sensors_st[i].event_ack == CLEAR_EVENT_ACK) {
           if (sensor_list.sl_sensors_st[i].config_st->data_deliver.data_mode == SL_SH_THRESHOLD) {
@@ -272,6 +272,12 @@ psa_status_t sli_si91x_crypto_aead_encrypt(const psa_key_attributes_t *attribute
     return status;
   }
 
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_AEAD,
+                                    attributes,
+                                    plaintext_length + additional_data_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
   psa_key_type_t key_type = psa_get_key_type(attributes);
   size_t key_bits         = psa_get_key_bits(attributes);
   uint8_t tag_length      = PSA_AEAD_TAG_LENGTH(key_type, key_bits, alg);
@@ -403,6 +409,12 @@ psa_status_t sli_si91x_crypto_aead_decrypt(const psa_key_attributes_t *attribute
   if (status != PSA_SUCCESS) {
     return status;
   }
+
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_AEAD,
+                                    attributes,
+                                    ciphertext_length + additional_data_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
   *plaintext_length = 0;
 
   psa_key_type_t key_type = psa_get_key_type(attributes);
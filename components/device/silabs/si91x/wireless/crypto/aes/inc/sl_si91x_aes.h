@@ -135,3 +135,14 @@ typedef struct {
 sl_status_t sl_si91x_aes(sl_si91x_aes_config_t *config, uint8_t *output);
 
 /** @} */
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+// Queues one chunk of the message described by config without waiting for its response
+sl_status_t sli_si91x_aes_queue(const sl_si91x_aes_config_t *config,
+                                uint16_t chunk_length,
+                                uint8_t aes_flags,
+                                uint16_t *packet_id);
+
+// Waits for the response to a chunk queued with sli_si91x_aes_queue and copies its output
+sl_status_t sli_si91x_aes_collect(uint16_t packet_id, uint8_t *output);
+#endif
@@ -91,6 +91,10 @@ psa_status_t sli_si91x_crypto_cipher_encrypt(const psa_key_attributes_t *attribu
     return PSA_ERROR_INVALID_ARGUMENT;
   }
 
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_CIPHER, attributes, input_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
   switch (alg) {
     case (PSA_ALG_ECB_NO_PADDING):
       /* Setting mode as ECB_MODE */
@@ -171,6 +175,10 @@ psa_status_t sli_si91x_crypto_cipher_decrypt(const psa_key_attributes_t *attribu
     return PSA_ERROR_INVALID_ARGUMENT;
   }
 
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_CIPHER, attributes, input_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
   switch (alg) {
     case (PSA_ALG_ECB_NO_PADDING):
       /* Setting mode as ECB_MODE */
@@ -113,4 +113,15 @@ typedef struct {
 ******************************************************************************/
 sl_status_t sl_si91x_ccm(sl_si91x_ccm_config_t *config, uint8_t *output);
 
-/** @} */
\ No newline at end of file
+/** @} */
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+// Queues one chunk of the message described by config without waiting for its response
+sl_status_t sli_si91x_ccm_queue(const sl_si91x_ccm_config_t *config,
+                                uint16_t chunk_length,
+                                uint8_t ccm_flags,
+                                uint16_t *packet_id);
+
+// Waits for the response to a chunk queued with sli_si91x_ccm_queue and copies its output
+sl_status_t sli_si91x_ccm_collect(const sl_si91x_ccm_config_t *config, uint16_t packet_id, uint8_t *output);
+#endif
@@ -125,4 +125,15 @@ typedef struct {
 ******************************************************************************/
 sl_status_t sl_si91x_gcm(sl_si91x_gcm_config_t *config, uint8_t *output);
 
-/** @} */
\ No newline at end of file
+/** @} */
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+// Queues one chunk of the message described by config without waiting for its response
+sl_status_t sli_si91x_gcm_queue(const sl_si91x_gcm_config_t *config,
+                                uint16_t chunk_length,
+                                uint8_t gcm_flags,
+                                uint16_t *packet_id);
+
+// Waits for the response to a chunk queued with sli_si91x_gcm_queue and copies its output
+sl_status_t sli_si91x_gcm_collect(const sl_si91x_gcm_config_t *config, uint16_t packet_id, uint8_t *output);
+#endif
@@ -56,17 +56,15 @@ static void sli_si91x_gcm_get_key_info(sl_si91x_gcm_request_t *request, const sl
 #endif
 
 #ifndef SL_SI91X_SIDE_BAND_CRYPTO
-static sl_status_t sli_si91x_gcm_pending(sl_si91x_gcm_config_t *config,
-                                         uint16_t chunk_length,
-                                         uint8_t gcm_flags,
-                                         uint8_t *output)
+sl_status_t sli_si91x_gcm_queue(const sl_si91x_gcm_config_t *config,
+                                uint16_t chunk_length,
+                                uint8_t gcm_flags,
+                                uint16_t *packet_id)
 {
   sl_status_t status              = SL_STATUS_FAIL;
   sl_wifi_buffer_t *buffer        = NULL;
   sl_si91x_packet_t *packet       = NULL;
-  sl_si91x_gcm_request_t *request = (sl_si91x_gcm_request_t *)malloc(sizeof(sl_si91x_gcm_request_t));
-
-  SL_VERIFY_POINTER_OR_RETURN(request, SL_STATUS_ALLOCATION_FAILED);
+  sl_si91x_gcm_request_t *request = NULL;
 
   // Only 32 bytes M4 OTA built-in key support is present
   if (config->key_config.b0.key_type == SL_SI91X_BUILT_IN_KEY) {
@@ -85,7 +83,14 @@ static sl_status_t sli_si91x_gcm_pending(sl_si91x_gcm_config_t *config,
   }
 #endif
 
-  memset(request, 0, sizeof(sl_si91x_gcm_request_t));
+  // The request is built straight in the command frame
+  status = sl_si91x_driver_allocate_command_buffer(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
+                                                   sizeof(sl_si91x_gcm_request_t),
+                                                   &buffer,
+                                                   (void **)&request);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  memset(request, 0, sizeof(sl_si91x_gcm_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES);
 
   request->algorithm_type       = GCM;
   request->gcm_flags            = gcm_flags;
@@ -103,41 +108,61 @@ static sl_status_t sli_si91x_gcm_pending(sl_si91x_gcm_config_t *config,
   sli_si91x_gcm_get_key_info(request, config);
 
 #else
-  memcpy(request->key, config->key_config.a0.key, request->key_length);
   request->key_length = config->key_config.a0.key_length;
+  memcpy(request->key, config->key_config.a0.key, request->key_length);
 #endif
 
-  status =
-    sl_si91x_driver_send_command(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
-                                 SI91X_COMMON_CMD_QUEUE,
-                                 request,
-                                 (sizeof(sl_si91x_gcm_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES + chunk_length),
-                                 SL_SI91X_WAIT_FOR_RESPONSE(32000),
-                                 NULL,
-                                 &buffer);
-
-  if ((status != SL_STATUS_OK)) {
-    free(request);
-    if (buffer != NULL)
-      sl_si91x_host_free_buffer(buffer);
-  }
-  VERIFY_STATUS_AND_RETURN(status);
+  packet         = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+  packet->length = (sizeof(sl_si91x_gcm_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES + chunk_length) & 0xFFF;
 
-  packet = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+  // Ownership of the frame passes to the driver
+  return sl_si91x_driver_queue_command_buffer(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
+                                              SI91X_COMMON_CMD_QUEUE,
+                                              buffer,
+                                              SL_SI91X_WAIT_FOR_RESPONSE(32000),
+                                              packet_id);
+}
 
-  SL_ASSERT(packet->length == config->msg_length + SL_SI91X_TAG_SIZE);
-  if (config->gcm_mode == SL_SI91X_GCM_MODE) {
-    memcpy(output, packet->data, packet->length);
-  } else { // CMAC mode
-    memcpy(output, packet->data, SL_SI91X_TAG_SIZE);
+sl_status_t sli_si91x_gcm_collect(const sl_si91x_gcm_config_t *config, uint16_t packet_id, uint8_t *output)
+{
+  sl_status_t status        = SL_STATUS_FAIL;
+  sl_wifi_buffer_t *buffer  = NULL;
+  sl_si91x_packet_t *packet = NULL;
+
+  status = sl_si91x_driver_wait_for_command_buffer(SI91X_COMMON_CMD_QUEUE,
+                                                   packet_id,
+                                                   SL_SI91X_WAIT_FOR_RESPONSE(32000),
+                                                   &buffer);
+  if (status == SL_STATUS_OK) {
+    packet = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+
+    SL_ASSERT(packet->length == config->msg_length + SL_SI91X_TAG_SIZE);
+#ifdef SLI_SI917B0
+    if (config->gcm_mode != SL_SI91X_GCM_MODE) { // CMAC mode
+      memcpy(output, packet->data, SL_SI91X_TAG_SIZE);
+    } else
+#endif
+    {
+      memcpy(output, packet->data, packet->length);
+    }
   }
-  free(request);
   if (buffer != NULL)
     sl_si91x_host_free_buffer(buffer);
 
   return status;
 }
 
+static sl_status_t sli_si91x_gcm_pending(sl_si91x_gcm_config_t *config,
+                                         uint16_t chunk_length,
+                                         uint8_t gcm_flags,
+                                         uint8_t *output)
+{
+  uint16_t packet_id = 0;
+  sl_status_t status = sli_si91x_gcm_queue(config, chunk_length, gcm_flags, &packet_id);
+  VERIFY_STATUS_AND_RETURN(status);
+  return sli_si91x_gcm_collect(config, packet_id, output);
+}
+
 #else
 static sl_status_t sli_si91x_gcm_side_band(sl_si91x_gcm_config_t *config, uint8_t *output)
 {
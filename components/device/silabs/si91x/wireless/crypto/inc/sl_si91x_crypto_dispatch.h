@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * @file  sl_si91x_crypto_dispatch.h
+ * @brief Size based routing of PSA crypto operations between the NWP and software
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include "sl_status.h"
+#include <stddef.h>
+
+/******************************************************
+ *                    Constants
+ ******************************************************/
+// Operations on fewer bytes than the threshold of their class are left to the PSA core's builtin software
+// implementation. A threshold of 0 sends every operation of the class to the NWP.
+#ifndef SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_CIPHER
+#define SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_CIPHER 0
+#endif
+
+#ifndef SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_AEAD
+#define SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_AEAD 0
+#endif
+
+#ifndef SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_MAC
+#define SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_MAC 0
+#endif
+
+#ifndef SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_HASH
+#define SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_HASH 0
+#endif
+
+// Operations timed per backend and message length during calibration
+#ifndef SL_SI91X_CRYPTO_CALIBRATION_ROUNDS
+#define SL_SI91X_CRYPTO_CALIBRATION_ROUNDS 8
+#endif
+
+// Longest message length tried during calibration; lengths are doubled from 16 bytes up to this one
+#ifndef SL_SI91X_CRYPTO_CALIBRATION_MAX_LENGTH
+#define SL_SI91X_CRYPTO_CALIBRATION_MAX_LENGTH 1024
+#endif
+
+/// Classes of PSA crypto operations with a separate software threshold
+typedef enum {
+  SL_SI91X_CRYPTO_OPERATION_CIPHER = 0, ///< AES ECB, CBC and CTR, threshold applies to the message length
+  SL_SI91X_CRYPTO_OPERATION_AEAD,       ///< AES CCM and GCM, threshold applies to the message and additional data
+  SL_SI91X_CRYPTO_OPERATION_MAC,        ///< HMAC and CMAC, threshold applies to the message length
+  SL_SI91X_CRYPTO_OPERATION_HASH,       ///< SHA, threshold applies to the message length
+  SL_SI91X_CRYPTO_OPERATION_COUNT       ///< Number of operation classes
+} sl_si91x_crypto_operation_t;
+
+/******************************************************
+ *                Function Declarations
+*******************************************************/
+/*==============================================*/
+/**
+ * @brief
+ *   Set the message length below which operations of a class run in software.
+ * @param[in] operation
+ *   Operation class, one of @ref sl_si91x_crypto_operation_t.
+ * @param[in] threshold
+ *   Operations on fewer bytes than this are left to the PSA core's builtin software implementation. 0 sends every
+ *   operation to the NWP.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ * @note
+ *   The software path relies on the PSA core falling back to its builtin implementation when the NWP driver declines
+ *   an operation, so the matching MBEDTLS_PSA_BUILTIN_ALG_xxx implementations must be compiled in. Wrapped keys can
+ *   only be used by the NWP and are never routed to software.
+ */
+sl_status_t sl_si91x_crypto_set_software_threshold(sl_si91x_crypto_operation_t operation, size_t threshold);
+
+/*==============================================*/
+/**
+ * @brief
+ *   Get the message length below which operations of a class run in software.
+ * @param[in] operation
+ *   Operation class, one of @ref sl_si91x_crypto_operation_t.
+ * @return
+ *   Threshold in bytes, 0 if every operation of the class runs on the NWP.
+ */
+size_t sl_si91x_crypto_get_software_threshold(sl_si91x_crypto_operation_t operation);
+
+/*==============================================*/
+/**
+ * @brief
+ *   Measure the message length at which the NWP becomes faster than software for an operation class, and use it as
+ *   the class's software threshold.
+ * @param[in] operation
+ *   Operation class, one of @ref sl_si91x_crypto_operation_t. The class is timed with AES-128 ECB, AES-128 CCM (or
+ *   GCM), HMAC-SHA256 and SHA-256 respectively.
+ * @param[out] threshold
+ *   Threshold that was measured and applied, may be NULL.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ *   SL_STATUS_NOT_SUPPORTED, with the threshold set to 0, if the PSA core has no software implementation to fall
+ *   back to.
+ * @note
+ *   Calibration temporarily forces the class onto each backend in turn, so it should run once at startup, after
+ *   psa_crypto_init() and before other threads use the class. It takes
+ *   2 x SL_SI91X_CRYPTO_CALIBRATION_ROUNDS operations per message length tried.
+ */
+sl_status_t sl_si91x_crypto_calibrate_software_threshold(sl_si91x_crypto_operation_t operation, size_t *threshold);
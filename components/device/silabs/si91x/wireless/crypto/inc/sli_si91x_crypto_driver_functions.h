@@ -33,7 +33,9 @@
 #include "psa/crypto.h"
 #include "sl_status.h"
 #include "sl_si91x_crypto.h"
+#include "sl_si91x_crypto_dispatch.h"
 #include "sli_psa_driver_features.h"
+#include <stdbool.h>
 
 #ifdef SLI_CIPHER_DEVICE_SI91X
 #include "sl_si91x_psa_aes.h"
@@ -66,3 +68,11 @@
  *                Function Declarations
 *******************************************************/
 psa_status_t convert_si91x_error_code_to_psa_status(sl_status_t si91x_status);
+
+// Returns true if an operation of length bytes should be declined so that the PSA core runs it in software. Messages
+// shorter than the threshold of their operation class, see sl_si91x_crypto_set_software_threshold(), finish sooner
+// in software than in a round trip to the NWP. Operations on wrapped keys always go to the NWP, which alone can
+// unwrap them.
+bool sli_si91x_crypto_use_software(sl_si91x_crypto_operation_t operation,
+                                   const psa_key_attributes_t *attributes,
+                                   size_t length);
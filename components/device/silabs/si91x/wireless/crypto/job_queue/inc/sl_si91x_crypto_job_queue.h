@@ -0,0 +1,167 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief SL SI91X asynchronous AES, GCM and CCM job queue header file
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#pragma once
+#include "sl_si91x_aes.h"
+#include "sl_si91x_gcm.h"
+#include "sl_si91x_ccm.h"
+#include "sl_status.h"
+#include <stdint.h>
+
+/******************************************************
+ *                    Constants
+ ******************************************************/
+// Number of jobs the worker keeps queued in the driver while it waits for the oldest response. The driver sends the
+// network processor one common command at a time, so queued jobs only save the host handoff between two jobs.
+#ifndef SL_SI91X_CRYPTO_JOB_PIPELINE_DEPTH
+#define SL_SI91X_CRYPTO_JOB_PIPELINE_DEPTH 4
+#endif
+
+// Stack size of the worker thread, which also runs the job callbacks
+#ifndef SL_SI91X_CRYPTO_JOB_THREAD_STACK_SIZE
+#define SL_SI91X_CRYPTO_JOB_THREAD_STACK_SIZE 1536
+#endif
+
+#ifndef SL_SI91X_CRYPTO_JOB_THREAD_PRIORITY
+#define SL_SI91X_CRYPTO_JOB_THREAD_PRIORITY osPriorityNormal
+#endif
+
+// Number of most recent job latencies the percentiles of @ref sl_si91x_crypto_job_statistics_t are taken over
+#ifndef SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES
+#define SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES 64
+#endif
+
+/******************************************************
+ *                   Type Definitions
+ ******************************************************/
+/// Operation a job runs
+typedef enum {
+  SL_SI91X_CRYPTO_JOB_AES = 0, ///< @ref sl_si91x_aes with config.aes
+  SL_SI91X_CRYPTO_JOB_GCM,     ///< @ref sl_si91x_gcm with config.gcm
+  SL_SI91X_CRYPTO_JOB_CCM      ///< @ref sl_si91x_ccm with config.ccm
+} sl_si91x_crypto_job_type_t;
+
+typedef struct sl_si91x_crypto_job_s sl_si91x_crypto_job_t;
+
+/***************************************************************************/ /**
+ * @brief
+ *   Called on the job queue thread when a job completes.
+ * @details
+ *   The job queue thread may still hold the AES, GCM and CCM engine semaphores for the jobs behind this one, so the
+ *   callback must not call the blocking crypto APIs such as @ref sl_si91x_aes, @ref sl_si91x_gcm or
+ *   @ref sl_si91x_ccm; they would wait on the thread that runs the callback and never return. Submitting another job
+ *   with @ref sl_si91x_crypto_job_submit is allowed.
+ * @param[in] job
+ *   Completed job; its memory is owned by the caller again.
+ * @param[in] status
+ *   Result of the operation, as the blocking API would have returned it.
+ ******************************************************************************/
+typedef void (*sl_si91x_crypto_job_callback_t)(sl_si91x_crypto_job_t *job, sl_status_t status);
+
+/// Encryption or decryption job. The job, its configuration and every buffer it points to are owned by the job queue
+/// from @ref sl_si91x_crypto_job_submit until its callback is called.
+struct sl_si91x_crypto_job_s {
+  sl_si91x_crypto_job_type_t type; ///< Operation to run
+  union {
+    sl_si91x_aes_config_t aes; ///< Configuration of an AES job
+    sl_si91x_gcm_config_t gcm; ///< Configuration of a GCM job
+    sl_si91x_ccm_config_t ccm; ///< Configuration of a CCM job
+  } config;
+  uint8_t *output;                         ///< Output buffer, sized as for the blocking API
+  sl_si91x_crypto_job_callback_t callback; ///< Completion callback
+  void *context;                           ///< Caller context, not used by the job queue
+
+  // Fields below are private to the job queue
+  sl_si91x_crypto_job_t *next;
+  uint32_t submit_time;
+  uint16_t packet_id;
+};
+
+/// Job queue counters, see @ref sl_si91x_crypto_job_get_statistics
+typedef struct {
+  uint32_t completed;      ///< Jobs completed, successfully or not
+  uint32_t failed;         ///< Jobs completed with an error
+  uint32_t pipelined;      ///< Jobs sent as a single queued command rather than through the blocking API
+  uint32_t bytes;          ///< Message bytes of the completed jobs
+  uint32_t max_in_flight;  ///< Largest number of jobs queued in the driver at once
+  uint32_t latency_p50_us; ///< Median time from submission to callback of the most recent jobs
+  uint32_t latency_p90_us; ///< 90th percentile time from submission to callback of the most recent jobs
+  uint32_t latency_p99_us; ///< 99th percentile time from submission to callback of the most recent jobs
+  uint32_t latency_max_us; ///< Longest time from submission to callback of the most recent jobs
+} sl_si91x_crypto_job_statistics_t;
+
+/******************************************************
+ *                Function Declarations
+*******************************************************/
+/**
+ * @addtogroup CRYPTO_JOB_QUEUE_FUNCTIONS
+ * @{
+ */
+
+/***************************************************************************/ /**
+ * @brief
+ *   Create the job queue and the thread that runs it. Calling it again has no effect.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_crypto_job_queue_init(void);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Submit a job. Jobs run in submission order. A message that fits in one command, up to
+ *   SL_SI91X_MAX_DATA_SIZE_IN_BYTES (SL_SI91X_MAX_DATA_SIZE_IN_BYTES_FOR_CCM for CCM), is queued in the driver
+ *   while earlier jobs are still in progress, and sent as soon as the network processor answers the one before it.
+ *   Longer messages go through the blocking API once the jobs before them have completed.
+ * @param[in] job
+ *   Job to run, with type, config, output and callback filled in.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ *   On success the callback is called exactly once; on failure it is not called.
+ * @note
+ *   While the queue has commands queued in the driver it holds the AES, GCM and CCM semaphores of the types it runs,
+ *   so blocking calls from other threads wait until the pipeline drains.
+ ******************************************************************************/
+sl_status_t sl_si91x_crypto_job_submit(sl_si91x_crypto_job_t *job);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Read the job queue counters and the latency percentiles of the most recent jobs.
+ * @param[out] statistics
+ *   Counters.
+ ******************************************************************************/
+void sl_si91x_crypto_job_get_statistics(sl_si91x_crypto_job_statistics_t *statistics);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Clear the job queue counters and latency samples.
+ ******************************************************************************/
+void sl_si91x_crypto_job_reset_statistics(void);
+
+/** @} */
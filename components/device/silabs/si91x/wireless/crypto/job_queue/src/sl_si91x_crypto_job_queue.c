@@ -0,0 +1,410 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief SL SI91X asynchronous AES, GCM and CCM job queue source file
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include "sl_si91x_crypto_job_queue.h"
+#include "sl_si91x_crypto.h"
+#include "sl_constants.h"
+#include "sl_si91x_driver.h"
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+#include "sl_si91x_crypto_thread.h"
+#endif
+#include "cmsis_os2.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define SLI_SI91X_CRYPTO_JOB_SUBMITTED 0x1
+
+static osThreadId_t job_thread;
+static osMutexId_t job_lock; // Protects the submitted jobs and the statistics
+
+// Submitted jobs not yet taken by the worker
+static sl_si91x_crypto_job_t *submitted_head;
+static sl_si91x_crypto_job_t *submitted_tail;
+
+// Jobs queued in the driver, oldest first; only used by the worker
+static sl_si91x_crypto_job_t *in_flight_head;
+static sl_si91x_crypto_job_t *in_flight_tail;
+static uint32_t in_flight_count;
+static uint8_t engines_claimed; // Bit mask of the job types whose semaphore the worker holds
+
+static sl_si91x_crypto_job_statistics_t job_statistics;
+static uint32_t latency_samples[SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES]; // In system timer ticks
+static uint32_t latency_sample_count;
+
+static uint16_t sli_si91x_job_msg_length(const sl_si91x_crypto_job_t *job)
+{
+  switch (job->type) {
+    case SL_SI91X_CRYPTO_JOB_AES:
+      return job->config.aes.msg_length;
+    case SL_SI91X_CRYPTO_JOB_GCM:
+      return job->config.gcm.msg_length;
+    default:
+      return job->config.ccm.msg_length;
+  }
+}
+
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+static osSemaphoreId_t *sli_si91x_job_engine(sl_si91x_crypto_job_type_t type)
+{
+  switch (type) {
+    case SL_SI91X_CRYPTO_JOB_AES:
+      return &crypto_aes_mutex;
+    case SL_SI91X_CRYPTO_JOB_GCM:
+      return &crypto_gcm_mutex;
+    default:
+      return &crypto_ccm_mutex;
+  }
+}
+#endif
+
+// Queued jobs must not interleave with the chunks of a blocking call from another thread
+static void sli_si91x_job_claim_engine(sl_si91x_crypto_job_type_t type)
+{
+  if (engines_claimed & (1 << type)) {
+    return;
+  }
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+  osSemaphoreId_t *mutex = sli_si91x_job_engine(type);
+  if (*mutex == NULL) {
+    *mutex = sl_si91x_crypto_threadsafety_init(*mutex);
+  }
+  mutex_result = sl_si91x_crypto_mutex_acquire(*mutex);
+#endif
+  engines_claimed |= (uint8_t)(1 << type);
+}
+
+static void sli_si91x_job_release_engines(void)
+{
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+  for (int type = SL_SI91X_CRYPTO_JOB_AES; type <= SL_SI91X_CRYPTO_JOB_CCM; type++) {
+    if (engines_claimed & (1 << type)) {
+      mutex_result = sl_si91x_crypto_mutex_release(*sli_si91x_job_engine((sl_si91x_crypto_job_type_t)type));
+    }
+  }
+#endif
+  engines_claimed = 0;
+}
+
+static sl_si91x_crypto_job_t *sli_si91x_job_take_submitted(void)
+{
+  osMutexAcquire(job_lock, osWaitForever);
+  sl_si91x_crypto_job_t *job = submitted_head;
+  if (job != NULL) {
+    submitted_head = job->next;
+    if (submitted_head == NULL) {
+      submitted_tail = NULL;
+    }
+    job->next = NULL;
+  }
+  osMutexRelease(job_lock);
+  return job;
+}
+
+static void sli_si91x_job_complete(sl_si91x_crypto_job_t *job, sl_status_t status, bool pipelined)
+{
+  uint32_t latency = osKernelGetSysTimerCount() - job->submit_time;
+
+  osMutexAcquire(job_lock, osWaitForever);
+  job_statistics.completed++;
+  if (status != SL_STATUS_OK) {
+    job_statistics.failed++;
+  }
+  if (pipelined) {
+    job_statistics.pipelined++;
+  }
+  job_statistics.bytes += sli_si91x_job_msg_length(job);
+  latency_samples[latency_sample_count % SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES] = latency;
+  latency_sample_count++;
+  osMutexRelease(job_lock);
+
+  job->callback(job, status);
+}
+
+// Runs a job through the blocking API, which takes the engine semaphore itself and splits long messages into chunks
+static sl_status_t sli_si91x_job_run_blocking(sl_si91x_crypto_job_t *job)
+{
+  switch (job->type) {
+    case SL_SI91X_CRYPTO_JOB_AES:
+      return sl_si91x_aes(&job->config.aes, job->output);
+    case SL_SI91X_CRYPTO_JOB_GCM:
+      return sl_si91x_gcm(&job->config.gcm, job->output);
+    default:
+      return sl_si91x_ccm(&job->config.ccm, job->output);
+  }
+}
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+static bool sli_si91x_job_fits_one_command(const sl_si91x_crypto_job_t *job)
+{
+  uint16_t max_length =
+    (job->type == SL_SI91X_CRYPTO_JOB_CCM) ? SL_SI91X_MAX_DATA_SIZE_IN_BYTES_FOR_CCM : SL_SI91X_MAX_DATA_SIZE_IN_BYTES;
+  return sli_si91x_job_msg_length(job) <= max_length;
+}
+
+static sl_status_t sli_si91x_job_queue_command(sl_si91x_crypto_job_t *job)
+{
+  switch (job->type) {
+    case SL_SI91X_CRYPTO_JOB_AES:
+      return sli_si91x_aes_queue(&job->config.aes,
+                                 job->config.aes.msg_length,
+                                 FIRST_CHUNK | LAST_CHUNK,
+                                 &job->packet_id);
+    case SL_SI91X_CRYPTO_JOB_GCM:
+      return sli_si91x_gcm_queue(&job->config.gcm,
+                                 job->config.gcm.msg_length,
+                                 FIRST_CHUNK | LAST_CHUNK,
+                                 &job->packet_id);
+    default:
+      return sli_si91x_ccm_queue(&job->config.ccm,
+                                 job->config.ccm.msg_length,
+                                 FIRST_CHUNK | LAST_CHUNK,
+                                 &job->packet_id);
+  }
+}
+
+static sl_status_t sli_si91x_job_collect(sl_si91x_crypto_job_t *job)
+{
+  sl_status_t status;
+
+  switch (job->type) {
+    case SL_SI91X_CRYPTO_JOB_AES:
+      return sli_si91x_aes_collect(job->packet_id, job->output);
+    case SL_SI91X_CRYPTO_JOB_GCM:
+      return sli_si91x_gcm_collect(&job->config.gcm, job->packet_id, job->output);
+    default:
+      status = sli_si91x_ccm_collect(&job->config.ccm, job->packet_id, job->output);
+      // Copy the tag to the tag_buffer, as sl_si91x_ccm() does
+      if ((status == SL_STATUS_OK) && (job->config.ccm.encrypt_decrypt == SL_SI91X_CCM_ENCRYPT)) {
+        memcpy(job->config.ccm.tag, job->output + job->config.ccm.msg_length, job->config.ccm.tag_length);
+      }
+      return status;
+  }
+}
+
+// Waits for the response to the oldest queued job; the driver sends the next one as soon as it arrives
+static void sli_si91x_job_collect_oldest(void)
+{
+  sl_si91x_crypto_job_t *job = in_flight_head;
+
+  in_flight_head = job->next;
+  if (in_flight_head == NULL) {
+    in_flight_tail = NULL;
+  }
+  job->next = NULL;
+  in_flight_count--;
+
+  sli_si91x_job_complete(job, sli_si91x_job_collect(job), true);
+}
+#endif
+
+static void sli_si91x_crypto_job_thread(void *argument)
+{
+  UNUSED_PARAMETER(argument);
+
+  while (1) {
+    sl_si91x_crypto_job_t *job;
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+    // Keep the pipeline full
+    while ((in_flight_count < SL_SI91X_CRYPTO_JOB_PIPELINE_DEPTH) && ((job = sli_si91x_job_take_submitted()) != NULL)) {
+      if (!sli_si91x_job_fits_one_command(job)) {
+        // Jobs complete in submission order, and the blocking API needs the engine semaphores the pipeline holds
+        while (in_flight_count > 0) {
+          sli_si91x_job_collect_oldest();
+        }
+        sli_si91x_job_release_engines();
+        sli_si91x_job_complete(job, sli_si91x_job_run_blocking(job), false);
+        continue;
+      }
+
+      sli_si91x_job_claim_engine(job->type);
+      sl_status_t status = sli_si91x_job_queue_command(job);
+      if (status != SL_STATUS_OK) {
+        // The jobs queued before this one complete first
+        while (in_flight_count > 0) {
+          sli_si91x_job_collect_oldest();
+        }
+        sli_si91x_job_complete(job, status, false);
+        continue;
+      }
+
+      if (in_flight_tail != NULL) {
+        in_flight_tail->next = job;
+      } else {
+        in_flight_head = job;
+      }
+      in_flight_tail = job;
+      in_flight_count++;
+      osMutexAcquire(job_lock, osWaitForever);
+      if (in_flight_count > job_statistics.max_in_flight) {
+        job_statistics.max_in_flight = in_flight_count;
+      }
+      osMutexRelease(job_lock);
+    }
+
+    if (in_flight_count > 0) {
+      sli_si91x_job_collect_oldest();
+      continue;
+    }
+
+    // Let blocking callers from other threads in while the queue is idle
+    sli_si91x_job_release_engines();
+#else
+    // Side band requests are handed to the network processor by reference, one at a time
+    while ((job = sli_si91x_job_take_submitted()) != NULL) {
+      sli_si91x_job_complete(job, sli_si91x_job_run_blocking(job), false);
+    }
+#endif
+
+    osThreadFlagsWait(SLI_SI91X_CRYPTO_JOB_SUBMITTED, osFlagsWaitAny, osWaitForever);
+  }
+}
+
+sl_status_t sl_si91x_crypto_job_queue_init(void)
+{
+  if (job_thread != NULL) {
+    return SL_STATUS_OK;
+  }
+
+  job_lock = osMutexNew(NULL);
+  if (job_lock == NULL) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+
+  const osThreadAttr_t attr = {
+    .name       = "si91x_crypto_job",
+    .priority   = SL_SI91X_CRYPTO_JOB_THREAD_PRIORITY,
+    .stack_mem  = 0,
+    .stack_size = SL_SI91X_CRYPTO_JOB_THREAD_STACK_SIZE,
+    .cb_mem     = 0,
+    .cb_size    = 0,
+    .attr_bits  = 0u,
+    .tz_module  = 0u,
+  };
+  job_thread = osThreadNew(sli_si91x_crypto_job_thread, NULL, &attr);
+  if (job_thread == NULL) {
+    osMutexDelete(job_lock);
+    job_lock = NULL;
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_crypto_job_submit(sl_si91x_crypto_job_t *job)
+{
+  SL_VERIFY_POINTER_OR_RETURN(job, SL_STATUS_NULL_POINTER);
+
+  if (job_thread == NULL) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  if ((job->callback == NULL) || (job->output == NULL) || (job->type > SL_SI91X_CRYPTO_JOB_CCM)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  // Checks sl_si91x_aes() would otherwise make on the job queue thread
+  if ((job->type == SL_SI91X_CRYPTO_JOB_AES)
+      && ((job->config.aes.msg == NULL) || (job->config.aes.msg_length % SL_SI91X_AES_BLOCK_SIZE)
+          || (((job->config.aes.aes_mode == SL_SI91X_AES_CBC) || (job->config.aes.aes_mode == SL_SI91X_AES_CTR))
+              && (job->config.aes.iv == NULL)))) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  job->next        = NULL;
+  job->submit_time = osKernelGetSysTimerCount();
+
+  osMutexAcquire(job_lock, osWaitForever);
+  if (submitted_tail != NULL) {
+    submitted_tail->next = job;
+  } else {
+    submitted_head = job;
+  }
+  submitted_tail = job;
+  osMutexRelease(job_lock);
+
+  osThreadFlagsSet(job_thread, SLI_SI91X_CRYPTO_JOB_SUBMITTED);
+  return SL_STATUS_OK;
+}
+
+// Nearest-rank percentile of sorted samples, in microseconds
+static uint32_t sli_si91x_job_percentile_us(const uint32_t *sorted, uint32_t count, uint32_t percent)
+{
+  uint32_t rank = (count * percent + 99) / 100;
+  if (rank == 0) {
+    return 0;
+  }
+  return (uint32_t)(((uint64_t)sorted[rank - 1] * 1000000) / osKernelGetSysTimerFreq());
+}
+
+void sl_si91x_crypto_job_get_statistics(sl_si91x_crypto_job_statistics_t *statistics)
+{
+  uint32_t samples[SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES];
+  uint32_t count;
+
+  if (statistics == NULL) {
+    return;
+  }
+  if (job_lock == NULL) {
+    memset(statistics, 0, sizeof(*statistics));
+    return;
+  }
+
+  osMutexAcquire(job_lock, osWaitForever);
+  *statistics = job_statistics;
+  count = (latency_sample_count < SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES) ? latency_sample_count
+                                                                        : SL_SI91X_CRYPTO_JOB_LATENCY_SAMPLES;
+  memcpy(samples, latency_samples, count * sizeof(samples[0]));
+  osMutexRelease(job_lock);
+
+  // Insertion sort; the sample window is small
+  for (uint32_t i = 1; i < count; i++) {
+    uint32_t sample = samples[i];
+    uint32_t j      = i;
+    while ((j > 0) && (samples[j - 1] > sample)) {
+      samples[j] = samples[j - 1];
+      j--;
+    }
+    samples[j] = sample;
+  }
+
+  statistics->latency_p50_us = sli_si91x_job_percentile_us(samples, count, 50);
+  statistics->latency_p90_us = sli_si91x_job_percentile_us(samples, count, 90);
+  statistics->latency_p99_us = sli_si91x_job_percentile_us(samples, count, 99);
+  statistics->latency_max_us = sli_si91x_job_percentile_us(samples, count, 100);
+}
+
+void sl_si91x_crypto_job_reset_statistics(void)
+{
+  if (job_lock == NULL) {
+    return;
+  }
+  osMutexAcquire(job_lock, osWaitForever);
+  memset(&job_statistics, 0, sizeof(job_statistics));
+  latency_sample_count = 0;
+  osMutexRelease(job_lock);
+}
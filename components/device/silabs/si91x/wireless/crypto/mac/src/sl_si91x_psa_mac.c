@@ -107,6 +107,10 @@ psa_status_t sli_si91x_crypto_mac_compute(const psa_key_attributes_t *attributes
     return PSA_ERROR_INVALID_ARGUMENT;
   }
 
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_MAC, attributes, input_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
   psa_status_t status;
   int32_t si91x_status;
 
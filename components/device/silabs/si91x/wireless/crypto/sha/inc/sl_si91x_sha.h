@@ -54,6 +54,18 @@ typedef enum {
   SL_SI91x_SHA_224_DIGEST_LEN = 28
 } sl_si91x_sha_length_t;
 
+/// Context of a SHA computation fed in parts. It is owned by the caller and its fields are private to the SHA API.
+typedef struct {
+  sl_wifi_buffer_t *buffer;        ///< Command frame collecting the next chunk of the message, NULL if none
+  sl_si91x_sha_request_t *request; ///< SHA request inside the command frame
+  uint32_t length;                 ///< Length of the message submitted to the network processor so far
+  uint32_t message_length;         ///< Total length of the message
+  uint16_t packet_id;              ///< Packet ID of the chunk being processed by the network processor
+  uint8_t sha_mode;                ///< SHA mode, 0 if the context is not initialized
+  bool in_flight;                  ///< A chunk is being processed by the network processor
+  bool engine_claimed;             ///< The context holds the SHA engine of the network processor
+} sl_si91x_sha_context_t;
+
 /** @} */
 
 // -----------------------------------------------------------------------------
@@ -75,7 +87,7 @@ typedef enum {
  * - 4 – For SHA512 
  * - 5– For SHA224 
  * @param[in]  msg        - Pointer to message
- * @param[in]  msg_length - Total message length
+ * @param[in]  msg_length - Total message length, at most UINT16_MAX
  * @param[out]  digest    - Output parameter to hold computed digest from SHA
  *
  * @return The following values are returned:
@@ -85,7 +97,74 @@ typedef enum {
  * @note Refer Error Codes section for above error codes \ref error-codes.
  *
  */
-sl_status_t sl_si91x_sha(uint8_t sha_mode, uint8_t *msg, uint16_t msg_length, uint8_t *digest);
+sl_status_t sl_si91x_sha(uint8_t sha_mode, uint8_t *msg, uint32_t msg_length, uint8_t *digest);
+
+#ifndef SL_SI91X_SIDE_BAND_CRYPTO
+/*==============================================*/
+/**
+ * @brief      Start a SHA computation whose message is given in parts with @ref sl_si91x_sha_update.
+ * @param[out] context    - Context of the computation, owned by the caller until @ref sl_si91x_sha_finish or
+ *                          @ref sl_si91x_sha_abort returns
+ * @param[in]  sha_mode   - SHA mode of type @ref sl_si91x_crypto_sha_mode_t
+ * @param[in]  message_length - Total length of the message, at most UINT16_MAX
+ *
+ * @return The following values are returned:
+ * -     0              - Success 
+ * -            Non-Zero Value - Failure
+ *
+ * @note The network processor takes the total message length with every chunk, so it must be known up front.
+ *       Longer messages, and parts that do not add up to it, are rejected with SL_STATUS_INVALID_PARAMETER.
+ * @note Refer Error Codes section for above error codes \ref error-codes.
+ *
+ */
+sl_status_t sl_si91x_sha_init(sl_si91x_sha_context_t *context, uint8_t sha_mode, uint32_t message_length);
+
+/*==============================================*/
+/**
+ * @brief      Add the next part of the message to a SHA computation. This is a blocking API.
+ *             The message is sent to the network processor in chunks of SL_SI91X_MAX_DATA_SIZE_IN_BYTES, collected
+ *             directly in driver command frames. A full chunk is queued as soon as more data follows it, and the
+ *             response to the previous chunk is only waited for after that, so the network processor always has the
+ *             next chunk ready.
+ * @param[in]  context    - Context initialized with @ref sl_si91x_sha_init
+ * @param[in]  msg        - Pointer to the part of the message
+ * @param[in]  msg_length - Length of the part of the message
+ *
+ * @return The following values are returned:
+ * -     0              - Success 
+ * -            Non-Zero Value - Failure. The computation is aborted.
+ *
+ * @note The network processor keeps a single running digest. A computation holds the SHA engine from its first
+ *       queued chunk until it is finished or aborted, and other computations wait for it before queuing their own.
+ *       Computations of messages shorter than one chunk only hold the engine inside @ref sl_si91x_sha_finish.
+ * @note Refer Error Codes section for above error codes \ref error-codes.
+ *
+ */
+sl_status_t sl_si91x_sha_update(sl_si91x_sha_context_t *context, const uint8_t *msg, uint32_t msg_length);
+
+/*==============================================*/
+/**
+ * @brief      Complete a SHA computation and read its digest. This is a blocking API.
+ * @param[in]  context    - Context initialized with @ref sl_si91x_sha_init. It must be initialized again before reuse.
+ * @param[out] digest     - Output parameter to hold computed digest from SHA
+ *
+ * @return The following values are returned:
+ * -     0              - Success 
+ * -            Non-Zero Value - Failure
+ *
+ * @note Refer Error Codes section for above error codes \ref error-codes.
+ *
+ */
+sl_status_t sl_si91x_sha_finish(sl_si91x_sha_context_t *context, uint8_t *digest);
+
+/*==============================================*/
+/**
+ * @brief      Abandon a SHA computation and release the command frame and the SHA engine it holds.
+ * @param[in]  context    - Context initialized with @ref sl_si91x_sha_init
+ *
+ */
+void sl_si91x_sha_abort(sl_si91x_sha_context_t *context);
+#endif
 
 /** @} */
 #endif /* SL_SI91X_SHA_H */
@@ -37,6 +37,10 @@ psa_status_t sli_si91x_crypto_hash_compute(psa_algorithm_t alg,
     return PSA_ERROR_INVALID_ARGUMENT;
   }
 
+  if (sli_si91x_crypto_use_software(SL_SI91X_CRYPTO_OPERATION_HASH, NULL, input_length)) {
+    return PSA_ERROR_NOT_SUPPORTED;
+  }
+
   switch (alg) {
 #if defined(PSA_WANT_ALG_SHA_1)
     case PSA_ALG_SHA_1:
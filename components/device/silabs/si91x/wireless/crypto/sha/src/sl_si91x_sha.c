@@ -34,83 +34,234 @@ static const uint8_t sha_digest_len_table[] = { [SL_SI91x_SHA_1]   = SL_SI91x_SH
                                                 [SL_SI91x_SHA_512] = SL_SI91x_SHA_512_DIGEST_LEN,
                                                 [SL_SI91x_SHA_224] = SL_SI91x_SHA_224_DIGEST_LEN };
 
-static sl_status_t sli_si91x_sha_pending(uint8_t sha_mode,
-                                         uint8_t *msg,
-                                         uint16_t msg_length,
-                                         uint16_t chunk_len,
-                                         uint8_t pending_flag,
-                                         uint8_t *digest)
+// The network processor keeps a single running digest, so a message of several chunks holds the SHA engine from its
+// first chunk to its last
+static void sli_si91x_sha_claim_engine(sl_si91x_sha_context_t *context)
 {
-  // Input pointer check
-  if ((msg == NULL) && (msg_length != 0)) {
-    return SL_STATUS_INVALID_PARAMETER;
+  if (!context->engine_claimed) {
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+    if (crypto_sha_mutex == NULL) {
+      crypto_sha_mutex = sl_si91x_crypto_threadsafety_init(crypto_sha_mutex);
+    }
+    mutex_result = sl_si91x_crypto_mutex_acquire(crypto_sha_mutex);
+#endif
+    context->engine_claimed = true;
   }
-  sl_status_t status = SL_STATUS_OK;
-  SL_PRINTF(SL_SHA_PEN_ENTRY, CRYPTO, LOG_INFO);
-  uint16_t send_size = 0;
-  sl_wifi_buffer_t *buffer;
+}
+
+// Waits for the response to a chunk and copies the digest it carries if requested
+static sl_status_t sli_si91x_sha_wait(uint16_t packet_id, uint8_t sha_mode, uint8_t *digest)
+{
+  sl_status_t status       = SL_STATUS_OK;
+  sl_wifi_buffer_t *buffer = NULL;
   sl_si91x_packet_t *packet;
-  sl_si91x_sha_request_t *request = (sl_si91x_sha_request_t *)malloc(sizeof(sl_si91x_sha_request_t));
 
-  SL_VERIFY_POINTER_OR_RETURN(request, SL_STATUS_ALLOCATION_FAILED);
+  status = sl_si91x_driver_wait_for_command_buffer(SI91X_COMMON_CMD_QUEUE,
+                                                   packet_id,
+                                                   SL_SI91X_WAIT_FOR_RESPONSE(32000),
+                                                   (digest != NULL) ? &buffer : NULL);
+  if ((status == SL_STATUS_OK) && (digest != NULL)) {
+    packet = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+    SL_ASSERT(packet->length == sha_digest_len_table[sha_mode]);
+    memcpy(digest, packet->data, sha_digest_len_table[sha_mode]);
+  }
+  if (buffer != NULL) {
+    sl_si91x_host_free_buffer(buffer);
+  }
+  return status;
+}
 
-  memset(request, 0, sizeof(sl_si91x_sha_request_t));
+// Allocates the command frame that collects the next chunk of the message
+static sl_status_t sli_si91x_sha_allocate(sl_si91x_sha_context_t *context)
+{
+  sl_status_t status = sl_si91x_driver_allocate_command_buffer(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
+                                                               sizeof(sl_si91x_sha_request_t),
+                                                               &context->buffer,
+                                                               (void **)&context->request);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  memset(context->request, 0, sizeof(sl_si91x_sha_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES);
 
   // Fill Algorithm type SHA - 4
-  request->algorithm_type = SHA;
+  context->request->algorithm_type     = SHA;
+  context->request->algorithm_sub_type = context->sha_mode;
+  return SL_STATUS_OK;
+}
 
-  request->algorithm_sub_type = sha_mode;
+// Queues the collected chunk, then waits for the response to the previous one while the new one is pending
+static sl_status_t sli_si91x_sha_submit(sl_si91x_sha_context_t *context, uint8_t sha_flags)
+{
+  sl_si91x_sha_request_t *request = context->request;
+  sl_si91x_packet_t *packet       = sl_si91x_host_get_buffer_data(context->buffer, 0, NULL);
+  bool previous_in_flight         = context->in_flight;
+  uint16_t previous_packet_id     = context->packet_id;
+  uint16_t packet_id              = 0;
+  sl_status_t status              = SL_STATUS_OK;
+
+  sli_si91x_sha_claim_engine(context);
 
   // Fill sha_flags BIT(0) - 1st chunk BIT(2) - Last chunk
-  request->sha_flags = pending_flag;
+  request->sha_flags = sha_flags;
+
+  // Fill total msg length; sl_si91x_sha_init() has checked that it fits the 16-bit field
+  context->length += request->current_chunk_length;
+  request->total_msg_length = (uint16_t)context->message_length;
+
+  packet->length = (sizeof(sl_si91x_sha_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES + request->current_chunk_length)
+                   & 0xFFF;
+
+  // Ownership of the frame passes to the driver
+  status = sl_si91x_driver_queue_command_buffer(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
+                                                SI91X_COMMON_CMD_QUEUE,
+                                                context->buffer,
+                                                SL_SI91X_WAIT_FOR_RESPONSE(32000),
+                                                &packet_id);
+  context->buffer  = NULL;
+  context->request = NULL;
+  VERIFY_STATUS_AND_RETURN(status);
 
-  // Fill total msg length
-  request->total_msg_length = msg_length;
+  context->packet_id = packet_id;
+  context->in_flight = true;
+  if (previous_in_flight) {
+    status = sli_si91x_sha_wait(previous_packet_id, context->sha_mode, NULL);
+  }
+  return status;
+}
 
-  // Fill current chunk length
-  request->current_chunk_length = chunk_len;
+// Releases everything a context holds; the context must be initialized again before reuse
+static void sli_si91x_sha_release(sl_si91x_sha_context_t *context)
+{
+  if (context->in_flight) {
+    sli_si91x_sha_wait(context->packet_id, context->sha_mode, NULL);
+    context->in_flight = false;
+  }
+  if (context->buffer != NULL) {
+    sl_si91x_host_free_buffer(context->buffer);
+    context->buffer  = NULL;
+    context->request = NULL;
+  }
+  if (context->engine_claimed) {
+#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
+    mutex_result = sl_si91x_crypto_mutex_release(crypto_sha_mutex);
+#endif
+    context->engine_claimed = false;
+  }
+  context->sha_mode = 0;
+}
 
-  // Memset before filling
-  memset(&request->msg[0], 0, SL_SI91X_MAX_DATA_SIZE_IN_BYTES);
+sl_status_t sl_si91x_sha_init(sl_si91x_sha_context_t *context, uint8_t sha_mode, uint32_t message_length)
+{
+  SL_VERIFY_POINTER_OR_RETURN(context, SL_STATUS_NULL_POINTER);
 
-  // Copy Data
-  memcpy(&request->msg[0], msg, chunk_len);
+  // Every chunk carries the total message length in a 16-bit field
+  if ((sha_mode < SL_SI91x_SHA_1) || (sha_mode > SL_SI91x_SHA_224) || (message_length > UINT16_MAX)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
 
-  send_size = sizeof(sl_si91x_sha_request_t) - SL_SI91X_MAX_DATA_SIZE_IN_BYTES + chunk_len;
+  memset(context, 0, sizeof(sl_si91x_sha_context_t));
+  context->sha_mode       = sha_mode;
+  context->message_length = message_length;
+  return SL_STATUS_OK;
+}
 
-  status = sl_si91x_driver_send_command(RSI_COMMON_REQ_ENCRYPT_CRYPTO,
-                                        SI91X_COMMON_CMD_QUEUE,
-                                        request,
-                                        send_size,
-                                        SL_SI91X_WAIT_FOR_RESPONSE(32000),
-                                        NULL,
-                                        &buffer);
-  if (status != SL_STATUS_OK) {
-    free(request);
-    if (buffer != NULL)
-      sl_si91x_host_free_buffer(buffer);
+sl_status_t sl_si91x_sha_update(sl_si91x_sha_context_t *context, const uint8_t *msg, uint32_t msg_length)
+{
+  sl_status_t status = SL_STATUS_OK;
+  uint16_t chunk_len = 0;
+
+  SL_VERIFY_POINTER_OR_RETURN(context, SL_STATUS_NULL_POINTER);
+
+  // Input pointer check
+  if ((context->sha_mode == 0) || ((msg == NULL) && (msg_length != 0))) {
+    return SL_STATUS_INVALID_PARAMETER;
   }
-  VERIFY_STATUS_AND_RETURN(status);
 
-  packet = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+  // The parts may not add up to more than the total length given to sl_si91x_sha_init()
+  uint32_t collected = context->length + ((context->request != NULL) ? context->request->current_chunk_length : 0);
+  if (msg_length > (context->message_length - collected)) {
+    sli_si91x_sha_release(context);
+    return SL_STATUS_INVALID_PARAMETER;
+  }
 
-  if (pending_flag == (LAST_CHUNK | FIRST_CHUNK) || pending_flag == LAST_CHUNK) {
-    SL_ASSERT(packet->length == sha_digest_len_table[sha_mode]);
+  while (msg_length > 0) {
+    if ((context->request != NULL) && (context->request->current_chunk_length == SL_SI91X_MAX_DATA_SIZE_IN_BYTES)) {
+      // A full chunk followed by more data is not the last one
+      status = sli_si91x_sha_submit(context, (context->length == 0) ? FIRST_CHUNK : MIDDLE_CHUNK);
+      if (status != SL_STATUS_OK) {
+        SL_PRINTF(SL_SHA_CHUNK_LENGTH_MSG_ERROR, CRYPTO, LOG_ERROR, "status: %4x", status);
+        sli_si91x_sha_release(context);
+        return status;
+      }
+    }
+    if (context->buffer == NULL) {
+      status = sli_si91x_sha_allocate(context);
+      if (status != SL_STATUS_OK) {
+        sli_si91x_sha_release(context);
+        return status;
+      }
+    }
+
+    chunk_len = SL_SI91X_MAX_DATA_SIZE_IN_BYTES - context->request->current_chunk_length;
+    if (chunk_len > msg_length) {
+      chunk_len = (uint16_t)msg_length;
+    }
+    memcpy(&context->request->msg[context->request->current_chunk_length], msg, chunk_len);
+    context->request->current_chunk_length += chunk_len;
+    msg += chunk_len;
+    msg_length -= chunk_len;
   }
-  memcpy(digest, packet->data, sha_digest_len_table[sha_mode]);
+  return SL_STATUS_OK;
+}
 
-  free(request);
-  if (buffer != NULL)
-    sl_si91x_host_free_buffer(buffer);
+sl_status_t sl_si91x_sha_finish(sl_si91x_sha_context_t *context, uint8_t *digest)
+{
+  sl_status_t status = SL_STATUS_OK;
+
+  SL_VERIFY_POINTER_OR_RETURN(context, SL_STATUS_NULL_POINTER);
 
+  if ((context->sha_mode == 0) || (digest == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // The parts must add up to the total length given to sl_si91x_sha_init()
+  uint32_t collected = context->length + ((context->request != NULL) ? context->request->current_chunk_length : 0);
+  if (collected != context->message_length) {
+    sli_si91x_sha_release(context);
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // An empty message is sent as a single empty chunk
+  if (context->buffer == NULL) {
+    status = sli_si91x_sha_allocate(context);
+  }
+
+  if (status == SL_STATUS_OK) {
+    status = sli_si91x_sha_submit(context, (context->length == 0) ? (LAST_CHUNK | FIRST_CHUNK) : LAST_CHUNK);
+  }
+  if (status == SL_STATUS_OK) {
+    context->in_flight = false;
+    status             = sli_si91x_sha_wait(context->packet_id, context->sha_mode, digest);
+  }
+  if (status != SL_STATUS_OK) {
+    SL_PRINTF(SL_SHA_CHUNK_LENGTH_MSG_ERROR, CRYPTO, LOG_ERROR, "status: %4x", status);
+  }
+
+  sli_si91x_sha_release(context);
   return status;
 }
 
+void sl_si91x_sha_abort(sl_si91x_sha_context_t *context)
+{
+  if (context != NULL) {
+    sli_si91x_sha_release(context);
+  }
+}
+
 #else
-static sl_status_t sli_si91x_sha_side_band(uint8_t sha_mode, uint8_t *msg, uint16_t msg_length, uint8_t *digest)
+static sl_status_t sli_si91x_sha_side_band(uint8_t sha_mode, uint8_t *msg, uint32_t msg_length, uint8_t *digest)
 {
-  // Input pointer check
-  if (msg == NULL) {
+  // Input pointer check; the side band request carries a 16-bit message length
+  if ((msg == NULL) || (msg_length > UINT16_MAX)) {
     return SL_STATUS_INVALID_PARAMETER;
   }
   sl_status_t status              = SL_STATUS_OK;
@@ -146,85 +297,33 @@ static sl_status_t sli_si91x_sha_side_band(uint8_t sha_mode, uint8_t *msg, uint1
 }
 #endif
 
-sl_status_t sl_si91x_sha(uint8_t sha_mode, uint8_t *msg, uint16_t msg_length, uint8_t *digest)
+sl_status_t sl_si91x_sha(uint8_t sha_mode, uint8_t *msg, uint32_t msg_length, uint8_t *digest)
 {
   sl_status_t status = SL_STATUS_OK;
   SL_PRINTF(SL_SHA_ENTRY, CRYPTO, LOG_INFO);
 
+#ifdef SL_SI91X_SIDE_BAND_CRYPTO
 #if defined(SLI_MULTITHREAD_DEVICE_SI91X)
   if (crypto_sha_mutex == NULL) {
     crypto_sha_mutex = sl_si91x_crypto_threadsafety_init(crypto_sha_mutex);
   }
   mutex_result = sl_si91x_crypto_mutex_acquire(crypto_sha_mutex);
 #endif
-
-#ifdef SL_SI91X_SIDE_BAND_CRYPTO
   status = sli_si91x_sha_side_band(sha_mode, msg, msg_length, digest);
-  return status;
-#else
-  uint16_t total_len = 0;
-  uint16_t chunk_len = 0;
-  uint16_t offset    = 0;
-  uint8_t sha_flags  = 0;
-
-  total_len = msg_length;
-  if (total_len != 0) {
-    while (total_len) {
-      // Check total length
-      if (total_len > SL_SI91X_MAX_DATA_SIZE_IN_BYTES) {
-        chunk_len = SL_SI91X_MAX_DATA_SIZE_IN_BYTES;
-        if (offset == 0) {
-          // Make sha_flag as first chunk
-          sha_flags |= FIRST_CHUNK;
-        } else {
-          // Make sha_flag as Middle chunk
-          sha_flags = MIDDLE_CHUNK;
-        }
-      } else {
-        chunk_len = total_len;
-
-        // Make sha_flag as Last chunk
-        sha_flags = LAST_CHUNK;
-        if (offset == 0) {
-          /* If the total length is less than 1400 and offset is zero,
-             make sha_flag as both first chunk as well as last chunk*/
-          sha_flags |= FIRST_CHUNK;
-        }
-      }
-
-      // Send the current chunk length message
-      status = sli_si91x_sha_pending(sha_mode, msg, msg_length, chunk_len, sha_flags, digest);
-
-      if (status != SL_STATUS_OK) {
-        SL_PRINTF(SL_SHA_CHUNK_LENGTH_MSG_ERROR, CRYPTO, LOG_ERROR, "status: %4x", status);
 #if defined(SLI_MULTITHREAD_DEVICE_SI91X)
-        mutex_result = sl_si91x_crypto_mutex_release(crypto_sha_mutex);
+  mutex_result = sl_si91x_crypto_mutex_release(crypto_sha_mutex);
 #endif
-        return status;
-      }
+  return status;
+#else
+  sl_si91x_sha_context_t context;
 
-      // Increment the offset value
-      offset += chunk_len;
-      msg += chunk_len;
+  status = sl_si91x_sha_init(&context, sha_mode, msg_length);
+  VERIFY_STATUS_AND_RETURN(status);
 
-      // Decrement the total message length
-      total_len -= chunk_len;
-    }
-  } else {
-    sha_flags = LAST_CHUNK | FIRST_CHUNK;
-    status    = sli_si91x_sha_pending(sha_mode, msg, msg_length, chunk_len, sha_flags, digest);
-    if (status != SL_STATUS_OK) {
-      SL_PRINTF(SL_SHA_CHUNK_LENGTH_MSG_ERROR, CRYPTO, LOG_ERROR, "status: %4x", status);
-#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
-      mutex_result = sl_si91x_crypto_mutex_release(crypto_sha_mutex);
-#endif
-      return status;
-    }
-  }
+  status = sl_si91x_sha_update(&context, msg, msg_length);
+  VERIFY_STATUS_AND_RETURN(status);
 
-#if defined(SLI_MULTITHREAD_DEVICE_SI91X)
-  mutex_result = sl_si91x_crypto_mutex_release(crypto_sha_mutex);
-#endif
+  status = sl_si91x_sha_finish(&context, digest);
 
   SL_PRINTF(SL_SHA_EXIT, CRYPTO, LOG_INFO, "status: %4x", status);
   return status;
@@ -0,0 +1,250 @@
+/*******************************************************************************
+ * @file  sl_si91x_crypto_dispatch.c
+ * @brief Size based routing of PSA crypto operations between the NWP and software
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+
+#include "sl_si91x_crypto_dispatch.h"
+#include "sli_si91x_crypto_driver_functions.h"
+#include "cmsis_os2.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLI_SI91X_CALIBRATION_MIN_LENGTH 16
+#define SLI_SI91X_CALIBRATION_TAG_LENGTH 16
+#define SLI_SI91X_CALIBRATION_NONCE_SIZE 12
+
+// Runs one operation of a class on length bytes of buffer, writing its output after the input
+typedef psa_status_t (*sli_si91x_crypto_benchmark_t)(psa_key_id_t key, uint8_t *buffer, size_t length);
+
+static size_t software_threshold[SL_SI91X_CRYPTO_OPERATION_COUNT] = {
+  [SL_SI91X_CRYPTO_OPERATION_CIPHER] = SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_CIPHER,
+  [SL_SI91X_CRYPTO_OPERATION_AEAD]   = SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_AEAD,
+  [SL_SI91X_CRYPTO_OPERATION_MAC]    = SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_MAC,
+  [SL_SI91X_CRYPTO_OPERATION_HASH]   = SL_SI91X_CRYPTO_SOFTWARE_THRESHOLD_HASH,
+};
+
+bool sli_si91x_crypto_use_software(sl_si91x_crypto_operation_t operation,
+                                   const psa_key_attributes_t *attributes,
+                                   size_t length)
+{
+  if (length >= software_threshold[operation]) {
+    return false;
+  }
+  // Wrapped keys can only be unwrapped by the NWP
+  if ((attributes != NULL) && (PSA_KEY_LIFETIME_GET_LOCATION(psa_get_key_lifetime(attributes)) != 0)) {
+    return false;
+  }
+  return true;
+}
+
+sl_status_t sl_si91x_crypto_set_software_threshold(sl_si91x_crypto_operation_t operation, size_t threshold)
+{
+  if (operation >= SL_SI91X_CRYPTO_OPERATION_COUNT) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  software_threshold[operation] = threshold;
+  return SL_STATUS_OK;
+}
+
+size_t sl_si91x_crypto_get_software_threshold(sl_si91x_crypto_operation_t operation)
+{
+  if (operation >= SL_SI91X_CRYPTO_OPERATION_COUNT) {
+    return 0;
+  }
+  return software_threshold[operation];
+}
+
+#if defined(PSA_WANT_ALG_ECB_NO_PADDING) && defined(PSA_WANT_KEY_TYPE_AES)
+static psa_status_t sli_si91x_benchmark_cipher(psa_key_id_t key, uint8_t *buffer, size_t length)
+{
+  size_t output_length;
+  // ECB needs no IV, so the RNG does not add to the measured time
+  return psa_cipher_encrypt(key, PSA_ALG_ECB_NO_PADDING, buffer, length, buffer + length, length, &output_length);
+}
+#endif
+
+#if (defined(PSA_WANT_ALG_CCM) || defined(PSA_WANT_ALG_GCM)) && defined(PSA_WANT_KEY_TYPE_AES)
+#if defined(PSA_WANT_ALG_CCM)
+#define SLI_SI91X_CALIBRATION_AEAD_ALG PSA_ALG_CCM
+#else
+#define SLI_SI91X_CALIBRATION_AEAD_ALG PSA_ALG_GCM
+#endif
+
+static psa_status_t sli_si91x_benchmark_aead(psa_key_id_t key, uint8_t *buffer, size_t length)
+{
+  static const uint8_t nonce[SLI_SI91X_CALIBRATION_NONCE_SIZE] = { 0 };
+  size_t output_length;
+  return psa_aead_encrypt(key,
+                          SLI_SI91X_CALIBRATION_AEAD_ALG,
+                          nonce,
+                          sizeof(nonce),
+                          NULL,
+                          0,
+                          buffer,
+                          length,
+                          buffer + length,
+                          length + SLI_SI91X_CALIBRATION_TAG_LENGTH,
+                          &output_length);
+}
+#endif
+
+#if defined(PSA_WANT_ALG_HMAC) && defined(PSA_WANT_ALG_SHA_256)
+static psa_status_t sli_si91x_benchmark_mac(psa_key_id_t key, uint8_t *buffer, size_t length)
+{
+  size_t output_length;
+  return psa_mac_compute(key,
+                         PSA_ALG_HMAC(PSA_ALG_SHA_256),
+                         buffer,
+                         length,
+                         buffer + length,
+                         PSA_HASH_LENGTH(PSA_ALG_SHA_256),
+                         &output_length);
+}
+#endif
+
+#if defined(PSA_WANT_ALG_SHA_256)
+static psa_status_t sli_si91x_benchmark_hash(psa_key_id_t key, uint8_t *buffer, size_t length)
+{
+  size_t output_length;
+  (void)key;
+  return psa_hash_compute(PSA_ALG_SHA_256,
+                          buffer,
+                          length,
+                          buffer + length,
+                          PSA_HASH_LENGTH(PSA_ALG_SHA_256),
+                          &output_length);
+}
+#endif
+
+// Times SL_SI91X_CRYPTO_CALIBRATION_ROUNDS operations with the class forced onto one backend
+static uint32_t sli_si91x_crypto_time(sl_si91x_crypto_operation_t operation,
+                                      size_t threshold,
+                                      sli_si91x_crypto_benchmark_t benchmark,
+                                      psa_key_id_t key,
+                                      uint8_t *buffer,
+                                      size_t length,
+                                      psa_status_t *status)
+{
+  software_threshold[operation] = threshold;
+
+  uint32_t start = osKernelGetSysTimerCount();
+  for (uint32_t i = 0; i < SL_SI91X_CRYPTO_CALIBRATION_ROUNDS; i++) {
+    *status = benchmark(key, buffer, length);
+    if (*status != PSA_SUCCESS) {
+      break;
+    }
+  }
+  return osKernelGetSysTimerCount() - start;
+}
+
+sl_status_t sl_si91x_crypto_calibrate_software_threshold(sl_si91x_crypto_operation_t operation, size_t *threshold)
+{
+  sli_si91x_crypto_benchmark_t benchmark = NULL;
+  psa_key_attributes_t attributes        = PSA_KEY_ATTRIBUTES_INIT;
+  psa_key_id_t key                       = 0;
+  uint8_t key_data[32]                   = { 0 };
+  size_t key_length                      = 0;
+
+  switch (operation) {
+#if defined(PSA_WANT_ALG_ECB_NO_PADDING) && defined(PSA_WANT_KEY_TYPE_AES)
+    case SL_SI91X_CRYPTO_OPERATION_CIPHER:
+      benchmark = sli_si91x_benchmark_cipher;
+      psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+      psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT);
+      psa_set_key_algorithm(&attributes, PSA_ALG_ECB_NO_PADDING);
+      key_length = 16;
+      break;
+#endif
+#if (defined(PSA_WANT_ALG_CCM) || defined(PSA_WANT_ALG_GCM)) && defined(PSA_WANT_KEY_TYPE_AES)
+    case SL_SI91X_CRYPTO_OPERATION_AEAD:
+      benchmark = sli_si91x_benchmark_aead;
+      psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+      psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT);
+      psa_set_key_algorithm(&attributes, SLI_SI91X_CALIBRATION_AEAD_ALG);
+      key_length = 16;
+      break;
+#endif
+#if defined(PSA_WANT_ALG_HMAC) && defined(PSA_WANT_ALG_SHA_256)
+    case SL_SI91X_CRYPTO_OPERATION_MAC:
+      benchmark = sli_si91x_benchmark_mac;
+      psa_set_key_type(&attributes, PSA_KEY_TYPE_HMAC);
+      psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_SIGN_MESSAGE);
+      psa_set_key_algorithm(&attributes, PSA_ALG_HMAC(PSA_ALG_SHA_256));
+      key_length = 32;
+      break;
+#endif
+#if defined(PSA_WANT_ALG_SHA_256)
+    case SL_SI91X_CRYPTO_OPERATION_HASH:
+      benchmark = sli_si91x_benchmark_hash;
+      break;
+#endif
+    default:
+      break;
+  }
+  if (benchmark == NULL) {
+    return (operation >= SL_SI91X_CRYPTO_OPERATION_COUNT) ? SL_STATUS_INVALID_PARAMETER : SL_STATUS_NOT_SUPPORTED;
+  }
+
+  // Input followed by room for the output and an AEAD tag
+  uint8_t *buffer =
+    (uint8_t *)calloc(1, 2 * (SL_SI91X_CRYPTO_CALIBRATION_MAX_LENGTH + SLI_SI91X_CALIBRATION_TAG_LENGTH));
+  if (buffer == NULL) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  if ((key_length != 0) && (psa_import_key(&attributes, key_data, key_length, &key) != PSA_SUCCESS)) {
+    free(buffer);
+    return SL_STATUS_FAIL;
+  }
+
+  sl_status_t result = SL_STATUS_OK;
+  size_t crossover   = 0;
+  for (size_t length = SLI_SI91X_CALIBRATION_MIN_LENGTH; length <= SL_SI91X_CRYPTO_CALIBRATION_MAX_LENGTH;
+       length *= 2) {
+    psa_status_t status;
+    uint32_t software_time = sli_si91x_crypto_time(operation, SIZE_MAX, benchmark, key, buffer, length, &status);
+    if (status == PSA_ERROR_NOT_SUPPORTED) {
+      // The PSA core has no builtin implementation to fall back to
+      crossover = 0;
+      result    = SL_STATUS_NOT_SUPPORTED;
+      break;
+    }
+    if (status != PSA_SUCCESS) {
+      result = SL_STATUS_FAIL;
+      break;
+    }
+    uint32_t hardware_time = sli_si91x_crypto_time(operation, 0, benchmark, key, buffer, length, &status);
+    if (status != PSA_SUCCESS) {
+      result = SL_STATUS_FAIL;
+      break;
+    }
+    if (hardware_time <= software_time) {
+      break;
+    }
+    // Software is still faster at this length
+    crossover = length + 1;
+  }
+
+  software_threshold[operation] = crossover;
+  if (threshold != NULL) {
+    *threshold = crossover;
+  }
+
+  if (key != 0) {
+    psa_destroy_key(key);
+  }
+  free(buffer);
+  return result;
+}
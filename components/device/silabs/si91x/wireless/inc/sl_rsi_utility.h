@@ -77,6 +77,15 @@ typedef union {
 /// \details Mutex ID identifies the mutex.
 typedef void *osMutexId_t;
 
+// Number of synchronous commands per command queue that can wait for their response through a completion slot.
+// Additional concurrent waiters fall back to scanning the response queue.
+#ifndef SL_SI91X_RESPONSE_SLOTS_PER_QUEUE
+#define SL_SI91X_RESPONSE_SLOTS_PER_QUEUE 8
+#endif
+
+// Defining SL_SI91X_LOCK_FREE_QUEUES replaces the mutex on the socket data queue and the asynchronous event queues
+// with a lock-free multi-producer, single-consumer list. queued_packet_count is then updated atomically. Producers
+// that pass an atomic action still serialize on the queue mutex; the consumer never does.
 // Structure to represent a packet queue
 typedef struct {
   sl_wifi_buffer_t *head;
@@ -86,6 +95,86 @@ typedef struct {
   uint32_t queued_packet_count;
 } si91x_packet_queue_t;
 
+/// Number of wait time bins in @ref sl_si91x_buffer_statistics_t
+#define SL_SI91X_BUFFER_WAIT_HISTOGRAM_BINS 8
+
+// Structure to represent the allocation statistics of a buffer type
+typedef struct {
+  uint32_t allocations;        // Number of successful allocations
+  uint32_t failed_allocations; // Number of allocations that failed or timed out
+  uint8_t in_use;              // Number of buffers currently allocated
+  uint8_t high_water_mark;     // Maximum number of buffers allocated at the same time
+  uint32_t wait_histogram[SL_SI91X_BUFFER_WAIT_HISTOGRAM_BINS]; // Successful allocations by wait time: no wait,
+                                                                // up to 1, 2, 4, ... ms, longer than that
+} sl_si91x_buffer_statistics_t;
+
+// Maximum number of socket data frames the bus thread writes back to back before it services RX and the command
+// queues again. It also bounds how many data frames senders may have queued for the bus thread at once.
+#ifndef SL_SI91X_TX_BATCH_MAX_FRAMES
+#define SL_SI91X_TX_BATCH_MAX_FRAMES 4
+#endif
+
+// Maximum number of frame bytes written in one socket data burst. The frame that crosses the limit ends the burst.
+#ifndef SL_SI91X_TX_BATCH_MAX_BYTES
+#define SL_SI91X_TX_BATCH_MAX_BYTES 4096
+#endif
+
+// Ticks the bus thread waits for another socket data frame once the data queue runs empty in the middle of a burst.
+// RX and the command queues are not serviced while it waits, so the default of 0 ends the burst immediately.
+#ifndef SL_SI91X_TX_BATCH_LINGER_TICKS
+#define SL_SI91X_TX_BATCH_LINGER_TICKS 0
+#endif
+
+// Maximum number of received frames socket receive rings may keep while their readers catch up. At the limit the bus
+// thread stops reading frames, which pushes back on the network processor. Command responses and events wait too,
+// so keep it below the RX buffer quota.
+#ifndef SL_SI91X_MAX_HELD_RX_FRAMES
+#define SL_SI91X_MAX_HELD_RX_FRAMES 4
+#endif
+
+/// Number of bins in @ref sl_si91x_tx_batch_statistics_t
+#define SL_SI91X_TX_BATCH_HISTOGRAM_BINS 8
+
+// Structure to represent the socket data burst statistics of the bus thread
+typedef struct {
+  uint32_t bursts; // Number of socket data bursts written
+  uint32_t frames; // Number of socket data frames written
+  uint32_t bytes;  // Number of socket data frame bytes written
+  uint32_t frames_per_burst[SL_SI91X_TX_BATCH_HISTOGRAM_BINS]; // Bursts by frame count: 1, 2, ... frames, the last
+                                                               // bin also counts longer bursts
+} sl_si91x_tx_batch_statistics_t;
+
+// Bytes credited to a TX queue per deficit round robin round when no schedule is configured for it
+#ifndef SL_SI91X_TX_SCHEDULER_DEFAULT_QUANTUM
+#define SL_SI91X_TX_SCHEDULER_DEFAULT_QUANTUM 1600
+#endif
+
+// Default strict priority class of the command queues and of the socket data queue. Lower classes are served first.
+#ifndef SL_SI91X_TX_SCHEDULER_COMMAND_PRIORITY
+#define SL_SI91X_TX_SCHEDULER_COMMAND_PRIORITY 0
+#endif
+#ifndef SL_SI91X_TX_SCHEDULER_DATA_PRIORITY
+#define SL_SI91X_TX_SCHEDULER_DATA_PRIORITY 1
+#endif
+
+// Structure to represent how the bus thread schedules a TX queue
+typedef struct {
+  uint8_t priority; // Strict priority class; a queue is only served when no queue of a lower class is ready
+  uint16_t quantum; // Bytes credited per deficit round robin round among the ready queues of the same class
+} sl_si91x_tx_queue_schedule_t;
+
+/// Number of wait time bins in @ref sl_si91x_tx_queue_statistics_t
+#define SL_SI91X_TX_QUEUE_WAIT_HISTOGRAM_BINS 8
+
+// Structure to represent the TX scheduling statistics of a queue
+typedef struct {
+  uint32_t services;    // Number of times the bus thread wrote from the queue (a socket data burst counts once)
+  uint32_t bytes;       // Number of frame bytes written from the queue
+  uint32_t max_wait_ms; // Longest time the queue was ready before the bus thread served it
+  uint32_t wait_histogram[SL_SI91X_TX_QUEUE_WAIT_HISTOGRAM_BINS]; // Services by wait time: no wait,
+                                                                  // up to 1, 2, 4, ... ms, longer than that
+} sl_si91x_tx_queue_statistics_t;
+
 typedef uint32_t sl_si91x_host_timestamp_t;
 
 typedef void (*sl_si91x_host_atomic_action_function_t)(void *user_data);
@@ -289,6 +378,22 @@ void *sl_si91x_host_get_buffer_data(
   uint16_t *data_length); /*Function used to obtain pointer to a specified location in the buffer*/
 void sl_si91x_host_free_buffer(
   sl_wifi_buffer_t *buffer); /*Function used to deallocate the memory associated with buffer*/
+sl_status_t sl_si91x_host_get_buffer_statistics(
+  sl_wifi_buffer_type_t type,
+  sl_si91x_buffer_statistics_t *statistics); /*Function used to read the allocation statistics of a buffer type*/
+void sl_si91x_host_reset_buffer_statistics(void); /*Function used to clear the allocation statistics of all buffer types*/
+void sl_si91x_host_get_tx_batch_statistics(
+  sl_si91x_tx_batch_statistics_t *statistics); /*Function used to read the socket data burst statistics*/
+void sl_si91x_host_reset_tx_batch_statistics(void); /*Function used to clear the socket data burst statistics*/
+void sli_si91x_host_hold_rx_frame(void); /*Function used to count a received frame kept past its dispatch*/
+void sli_si91x_host_release_rx_frame(void); /*Function used to count the release of a kept frame*/
+sl_status_t sl_si91x_host_set_tx_queue_schedule(
+  sl_si91x_queue_type_t queue,
+  const sl_si91x_tx_queue_schedule_t *schedule); /*Function used to set the priority class and quantum of a TX queue*/
+sl_status_t sl_si91x_host_get_tx_queue_statistics(
+  sl_si91x_queue_type_t queue,
+  sl_si91x_tx_queue_statistics_t *statistics); /*Function used to read the scheduling statistics of a TX queue*/
+void sl_si91x_host_reset_tx_queue_statistics(void); /*Function used to clear the scheduling statistics of all TX queues*/
 // ---------------
 
 sl_status_t sl_si91x_host_add_to_queue(
@@ -323,6 +428,15 @@ uint32_t sl_si91x_host_queue_status(
 uint32_t sl_si91x_host_get_queue_packet_count(
   sl_si91x_queue_type_t queue); /*Function used to get the number of packets in the queue*/
 
+/* Functions used to deliver a synchronous response directly to the thread waiting on its packet ID */
+sl_status_t sli_si91x_response_slot_arm(sl_si91x_queue_type_t queue, uint16_t packet_id);
+void sli_si91x_response_slot_disarm(sl_si91x_queue_type_t queue, uint16_t packet_id);
+sl_status_t sli_si91x_response_slot_wait(sl_si91x_queue_type_t queue,
+                                         uint16_t packet_id,
+                                         uint32_t timeout,
+                                         sl_wifi_buffer_t **buffer);
+void sli_si91x_clear_events_if_queue_empty(sl_si91x_queue_type_t queue, uint32_t event_mask);
+
 // These aren't host APIs. These should go into a wifi bus API header
 sl_status_t sl_si91x_bus_read_memory(
   uint32_t addr,
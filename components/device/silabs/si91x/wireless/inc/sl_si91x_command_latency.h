@@ -0,0 +1,132 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Per-command lifecycle tracing and latency histograms for the Si91x driver
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#pragma once
+#include "sl_status.h"
+#include <stdint.h>
+
+// Command lifecycle tracing is compiled in only when SL_SI91X_COMMAND_LATENCY_TRACE is defined
+
+// Number of lifecycle records kept in the trace ring; older records are overwritten
+#ifndef SL_SI91X_COMMAND_TRACE_RING_SIZE
+#define SL_SI91X_COMMAND_TRACE_RING_SIZE 64
+#endif
+
+// Number of commands that can be tracked between being queued and their waiter resuming
+#ifndef SL_SI91X_COMMAND_TRACE_IN_FLIGHT
+#define SL_SI91X_COMMAND_TRACE_IN_FLIGHT 16
+#endif
+
+// Number of distinct command IDs for which latency histograms are kept
+#ifndef SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS
+#define SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS 24
+#endif
+
+/// Number of bins in each histogram of @ref sl_si91x_command_latency_t
+#define SL_SI91X_COMMAND_LATENCY_HISTOGRAM_BINS 8
+
+// Lifecycle stages of a command
+typedef enum {
+  SL_SI91X_COMMAND_STAGE_ENQUEUED, // Added to its TX queue by the calling thread
+  SL_SI91X_COMMAND_STAGE_WRITTEN,  // Written to the bus by the bus thread
+  SL_SI91X_COMMAND_STAGE_RESPONSE, // Response received from the network processor
+  SL_SI91X_COMMAND_STAGE_WOKEN,    // Calling thread resumed with the response
+  SL_SI91X_COMMAND_STAGE_COUNT
+} sl_si91x_command_stage_t;
+
+// Latency intervals of a command
+typedef enum {
+  SL_SI91X_COMMAND_LATENCY_QUEUED,   // From enqueued to written
+  SL_SI91X_COMMAND_LATENCY_DEVICE,   // From written to response
+  SL_SI91X_COMMAND_LATENCY_DELIVERY, // From response to the waiter resuming
+  SL_SI91X_COMMAND_LATENCY_TOTAL,    // From enqueued to the waiter resuming
+  SL_SI91X_COMMAND_LATENCY_COUNT
+} sl_si91x_command_latency_interval_t;
+
+// Structure to represent one record of the command trace ring
+typedef struct {
+  uint32_t sequence;  // Position of the record in the trace, 0 if the slot was never written
+  uint32_t tick;      // Kernel tick count at which the stage was reached
+  uint16_t command;   // Command ID
+  uint16_t packet_id; // Driver packet ID of the command
+  uint8_t queue;      // Command queue, one of the sl_si91x_command_type_t values
+  uint8_t stage;      // One of the sl_si91x_command_stage_t values
+} sl_si91x_command_trace_record_t;
+
+// Structure to represent the latency histograms of a command ID
+typedef struct {
+  uint16_t command;                                // Command ID
+  uint32_t count;                                  // Number of completed commands
+  uint32_t max_ms[SL_SI91X_COMMAND_LATENCY_COUNT]; // Longest latency of each interval
+  // Commands by latency of each interval: 0, up to 1, 2, 4, ... ms, longer than that
+  uint32_t histogram[SL_SI91X_COMMAND_LATENCY_COUNT][SL_SI91X_COMMAND_LATENCY_HISTOGRAM_BINS];
+} sl_si91x_command_latency_t;
+
+/***************************************************************************/ /**
+ * @brief
+ *   Read the latency histograms of every traced command ID.
+ * @param[out] latencies
+ *   Array that receives the histograms.
+ * @param[in] max_count
+ *   Number of entries in latencies.
+ * @return
+ *   Number of entries written to latencies.
+ ******************************************************************************/
+uint32_t sl_si91x_get_command_latencies(sl_si91x_command_latency_t *latencies, uint32_t max_count);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Copy the most recent command lifecycle records, oldest first.
+ * @param[out] records
+ *   Array that receives the records.
+ * @param[in] max_count
+ *   Number of entries in records.
+ * @return
+ *   Number of entries written to records.
+ ******************************************************************************/
+uint32_t sl_si91x_get_command_trace(sl_si91x_command_trace_record_t *records, uint32_t max_count);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Clear the command latency histograms and the trace ring.
+ ******************************************************************************/
+void sl_si91x_reset_command_latency(void);
+
+// Records that a command reached a lifecycle stage. A command ID of 0 is taken from the tracked command.
+void sli_si91x_command_trace_record(uint8_t queue,
+                                    uint16_t packet_id,
+                                    uint16_t command,
+                                    sl_si91x_command_stage_t stage);
+
+#ifdef SL_SI91X_COMMAND_LATENCY_TRACE
+#define SLI_SI91X_COMMAND_TRACE(queue, packet_id, command, stage) \
+  sli_si91x_command_trace_record((uint8_t)(queue), (packet_id), (command), (stage))
+#else
+#define SLI_SI91X_COMMAND_TRACE(queue, packet_id, command, stage)
+#endif
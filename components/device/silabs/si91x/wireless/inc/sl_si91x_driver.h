@@ -71,6 +71,12 @@ typedef enum { SL_NCP_NORMAL_POWER_MODE, SL_NCP_LOW_POWER_MODE, SL_NCP_ULTRA_LOW
 
 typedef struct sl_si91x_power_configuration sl_si91x_power_configuration_t;
 
+/// Segment of socket payload for gather sends
+typedef struct {
+  const void *data; ///< Start of the segment
+  uint32_t length;  ///< Length of the segment in bytes
+} sl_si91x_data_segment_t;
+
 /***************************************************************************/ /**
  * @brief
  *   Initialize the driver.
@@ -125,6 +131,97 @@ sl_status_t sl_si91x_driver_send_command(uint32_t command,
                                          void *sdk_context,
                                          sl_wifi_buffer_t **data_buffer);
 
+/***************************************************************************/ /**
+ * @brief
+ *   Allocate a command frame so that the command request can be built in place.
+ * @param[in] command
+ *   Command type to be sent to TA firmware.
+ * @param[in] data_length
+ *   Length of the command request.
+ * @param[out] buffer
+ *   Command frame buffer. Must be passed to @ref sl_si91x_driver_send_command_buffer or freed with sl_si91x_host_free_buffer.
+ * @param[out] data
+ *   Location inside the frame where data_length bytes of command request are to be written.
+ * @pre Pre-conditions:
+ * - 
+ *   @ref sl_si91x_driver_init should be called before this API.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_allocate_command_buffer(uint32_t command,
+                                                    uint32_t data_length,
+                                                    sl_wifi_buffer_t **buffer,
+                                                    void **data);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Send a command frame obtained from @ref sl_si91x_driver_allocate_command_buffer.
+ * @param[in] command
+ *   Command type to be sent to TA firmware.
+ * @param[in] queue_type
+ *   @ref sl_si91x_queue_type_t Queue type to be used to send the command on.
+ * @param[in] buffer
+ *   Command frame buffer. Ownership passes to the driver, regardless of the return value.
+ * @param[in] wait_period
+ *   @ref sl_si91x_wait_period_t Timeout for the command response.
+ * @param[in] sdk_context
+ *   Pointer to the context.
+ * @param[in] data_buffer
+ *   Pointer to a data buffer pointer for the response data to be returned in.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_send_command_buffer(uint32_t command,
+                                                sl_si91x_queue_type_t queue_type,
+                                                sl_wifi_buffer_t *buffer,
+                                                sl_si91x_wait_period_t wait_period,
+                                                void *sdk_context,
+                                                sl_wifi_buffer_t **data_buffer);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Queue a command frame obtained from @ref sl_si91x_driver_allocate_command_buffer without waiting for its response.
+ *   Several commands can be queued this way, so that the bus thread writes each one as soon as the network processor
+ *   takes it; their responses are collected with @ref sl_si91x_driver_wait_for_command_buffer.
+ * @param[in] command
+ *   Command type to be sent to TA firmware.
+ * @param[in] queue_type
+ *   @ref sl_si91x_queue_type_t Queue type to be used to send the command on.
+ * @param[in] buffer
+ *   Command frame buffer. Ownership passes to the driver, regardless of the return value.
+ * @param[in] wait_period
+ *   @ref sl_si91x_wait_period_t Timeout for the command response. SL_SI91X_RETURN_IMMEDIATELY is not allowed.
+ * @param[out] packet_id
+ *   Packet ID to pass to @ref sl_si91x_driver_wait_for_command_buffer.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_queue_command_buffer(uint32_t command,
+                                                 sl_si91x_queue_type_t queue_type,
+                                                 sl_wifi_buffer_t *buffer,
+                                                 sl_si91x_wait_period_t wait_period,
+                                                 uint16_t *packet_id);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Wait for the response of a command queued with @ref sl_si91x_driver_queue_command_buffer.
+ *   Every queued command must be waited for exactly once.
+ * @param[in] queue_type
+ *   @ref sl_si91x_queue_type_t Queue type the command was queued on.
+ * @param[in] packet_id
+ *   Packet ID returned by @ref sl_si91x_driver_queue_command_buffer.
+ * @param[in] wait_period
+ *   @ref sl_si91x_wait_period_t Timeout for the command response.
+ * @param[out] data_buffer
+ *   Pointer to a data buffer pointer for the response data to be returned in, or NULL to discard the response data.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_wait_for_command_buffer(sl_si91x_queue_type_t queue_type,
+                                                    uint16_t packet_id,
+                                                    sl_si91x_wait_period_t wait_period,
+                                                    sl_wifi_buffer_t **data_buffer);
+
 /***************************************************************************/ /**
  * @brief
  *   Register a function and optional argument for scan results callback.
@@ -198,6 +295,71 @@ sl_status_t sl_si91x_driver_send_socket_data(const sl_si91x_socket_send_request_
                                              const void *data,
                                              uint32_t wait_time);
 
+/***************************************************************************/ /**
+ * @brief
+ *   Send socket data gathered from multiple segments in a single TX frame.
+ * @param[in] request
+ *   @ref sl_si91x_socket_send_request_t Pointer to socket command packet. The length field must equal the sum of the segment lengths.
+ * @param[in] segments
+ *   Array of @ref sl_si91x_data_segment_t describing the payload.
+ * @param[in] segment_count
+ *   Number of entries in segments.
+ * @param[in] wait_time
+ *   Timeout  for the command response.
+ * @pre Pre-conditions:
+ * - 
+ *   @ref sl_si91x_driver_init should be called before this API.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ * @note
+ *   Each segment is copied once, directly into the frame handed to the bus.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_send_socket_data_vector(const sl_si91x_socket_send_request_t *request,
+                                                    const sl_si91x_data_segment_t *segments,
+                                                    uint32_t segment_count,
+                                                    uint32_t wait_time);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Allocate a TX frame for socket data so that the payload can be written in place.
+ * @param[in] request
+ *   @ref sl_si91x_socket_send_request_t Pointer to socket command packet. The length field sets the payload size.
+ * @param[out] buffer
+ *   TX frame buffer. Must be passed to @ref sl_si91x_driver_send_socket_data_buffer or @ref sl_si91x_driver_free_socket_data_buffer.
+ * @param[out] payload
+ *   Location inside the frame where request->length bytes of payload are to be written.
+ * @pre Pre-conditions:
+ * - 
+ *   @ref sl_si91x_driver_init should be called before this API.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ * @note
+ *   The frame holds a TX buffer until it is sent or freed, so it should be filled and sent promptly.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_allocate_socket_data_buffer(const sl_si91x_socket_send_request_t *request,
+                                                        sl_wifi_buffer_t **buffer,
+                                                        void **payload);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Send a TX frame obtained from @ref sl_si91x_driver_allocate_socket_data_buffer.
+ * @param[in] buffer
+ *   TX frame buffer. Ownership passes to the driver, regardless of the return value.
+ * @param[in] wait_time
+ *   Timeout  for the command response.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_send_socket_data_buffer(sl_wifi_buffer_t *buffer, uint32_t wait_time);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Release a TX frame obtained from @ref sl_si91x_driver_allocate_socket_data_buffer without sending it.
+ * @param[in] buffer
+ *   TX frame buffer.
+ ******************************************************************************/
+void sl_si91x_driver_free_socket_data_buffer(sl_wifi_buffer_t *buffer);
+
 /***************************************************************************/ /**
  * @brief
  *   Send a Bluetooth command.
@@ -485,6 +647,38 @@ sl_status_t sl_si91x_driver_raw_send_command(uint8_t command,
                                              uint32_t data_length,
                                              uint32_t wait_time);
 
+/***************************************************************************/ /**
+ * @brief
+ *   Allocate a raw frame so that its data can be written in place, for example gathered from several fragments.
+ * @param[in] command
+ *   Command type to be sent.
+ * @param[in] data_length
+ *   Length of the frame data.
+ * @param[out] buffer
+ *   Raw frame buffer. Must be passed to @ref sl_si91x_driver_send_raw_buffer or freed with sl_si91x_host_free_buffer.
+ * @param[out] data
+ *   Location inside the frame where data_length bytes of frame data are to be written.
+ * @pre Pre-conditions:
+ * - 
+ *   @ref sl_si91x_driver_init should be called before this API.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_allocate_raw_buffer(uint8_t command,
+                                                uint32_t data_length,
+                                                sl_wifi_buffer_t **buffer,
+                                                void **data);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Send a raw frame obtained from @ref sl_si91x_driver_allocate_raw_buffer.
+ * @param[in] buffer
+ *   Raw frame buffer. Ownership passes to the driver, regardless of the return value.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_driver_send_raw_buffer(sl_wifi_buffer_t *buffer);
+
 /***************************************************************************/ /**
  * @brief
  *   Register a event handler for network events.
@@ -87,6 +87,8 @@ void sl_si91x_host_enable_high_speed_bus();
  * @param buffer 
  *  pointer to a structure of type [sl_wifi_buffer_t](../wiseconnect-api-reference-guide-wi-fi/sl-wifi-buffer-t) containing the data frame to be processed.
  * @return sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details. 
+ *  SL_STATUS_IN_PROGRESS means the implementation keeps the buffer and frees it with sl_si91x_host_free_buffer once
+ *  it is done with the frame; for any other value the driver frees the buffer when the function returns.
  */
 sl_status_t sl_si91x_host_process_data_frame(sl_wifi_interface_t interface, sl_wifi_buffer_t *buffer);
 
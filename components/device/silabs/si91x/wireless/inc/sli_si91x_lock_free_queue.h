@@ -0,0 +1,98 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Intrusive lock-free multi-producer, single-consumer queue of the Si91x driver
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#pragma once
+#include "sl_slist.h"
+#include <stddef.h>
+
+// Intrusive multi-producer, single-consumer queue. Producers publish a node by swapping the tail and linking the
+// previous tail to it; only the consumer moves the head. The stub node keeps the list non-empty, so neither side
+// ever needs to look at the other's pointer to decide whether the queue is empty.
+typedef struct {
+  sl_slist_node_t *head;
+  sl_slist_node_t *tail;
+  sl_slist_node_t stub;
+} sli_si91x_lock_free_queue_t;
+
+static inline void sli_si91x_lock_free_queue_init(sli_si91x_lock_free_queue_t *lf_queue)
+{
+  lf_queue->stub.node = NULL;
+  lf_queue->head      = &lf_queue->stub;
+  lf_queue->tail      = &lf_queue->stub;
+}
+
+// Appends a node; safe to call from any number of threads at once
+static inline void sli_si91x_lock_free_link(sli_si91x_lock_free_queue_t *lf_queue, sl_slist_node_t *node)
+{
+  sl_slist_node_t *previous;
+
+  __atomic_store_n(&node->node, NULL, __ATOMIC_RELAXED);
+  previous = __atomic_exchange_n(&lf_queue->tail, node, __ATOMIC_ACQ_REL);
+  // Between the exchange and this store the consumer sees the list cut short at 'previous'; it stops there
+  __atomic_store_n(&previous->node, node, __ATOMIC_RELEASE);
+}
+
+// Removes the oldest node; only the single consumer may call it. Returns NULL if the queue is empty, and also if the
+// oldest node's producer has claimed the tail but not linked it yet, in which case a later call returns the node.
+static inline sl_slist_node_t *sli_si91x_lock_free_unlink(sli_si91x_lock_free_queue_t *lf_queue)
+{
+  sl_slist_node_t *head = lf_queue->head;
+  sl_slist_node_t *next = __atomic_load_n(&head->node, __ATOMIC_ACQUIRE);
+
+  if (head == &lf_queue->stub) {
+    if (NULL == next) {
+      return NULL;
+    }
+    lf_queue->head = next;
+    head           = next;
+    next           = __atomic_load_n(&head->node, __ATOMIC_ACQUIRE);
+  }
+
+  if (NULL != next) {
+    lf_queue->head = next;
+    head->node     = NULL;
+    return head;
+  }
+
+  if (head != __atomic_load_n(&lf_queue->tail, __ATOMIC_ACQUIRE)) {
+    // A producer has claimed the tail but not yet linked it
+    return NULL;
+  }
+
+  // 'head' is the last node; put the stub behind it so the node can be detached
+  sli_si91x_lock_free_link(lf_queue, &lf_queue->stub);
+  next = __atomic_load_n(&head->node, __ATOMIC_ACQUIRE);
+  if (NULL != next) {
+    lf_queue->head = next;
+    head->node     = NULL;
+    return head;
+  }
+
+  return NULL;
+}
@@ -31,6 +31,7 @@
 #include "sl_status.h"
 #include "sl_wifi_host_interface.h"
 #include "sl_si91x_host_interface.h"
+#include "sl_rsi_utility.h"
 #include "sl_constants.h"
 #include "cmsis_os2.h"
 #include "em_core.h"
@@ -43,14 +44,19 @@ static const sl_wifi_buffer_configuration_t *configuration;
 void *allocated_wifi_buffer                   = NULL;
 static uint8_t buffer_allocation[BUFFER_TYPE] = { 0, 0, 0, 0 };
 static uint8_t quota[BUFFER_TYPE];
+// Counting semaphores holding the free quota of each buffer type. Threads waiting for a buffer block on them
+// and are released by sl_si91x_host_free_buffer() in priority order, FIFO among threads of equal priority.
+static osSemaphoreId_t quota_semaphore[BUFFER_TYPE];
+static sl_si91x_buffer_statistics_t buffer_statistics[BUFFER_TYPE];
 
 /*---------------Static Function Declaration---------------------------------------*/
 static void sl_si91x_convert_config_structure_to_array(const sl_wifi_buffer_configuration_t *config);
 static sl_status_t sl_si91x_check_for_valid_config(const sl_wifi_buffer_configuration_t *config);
 static void sl_si91x_buffer_type_deallocation(sl_wifi_buffer_type_t type);
 static void sl_si91x_buffer_type_allocation(sl_wifi_buffer_type_t type);
-static sl_status_t sl_si91x_check_for_buffer_availability(sl_wifi_buffer_type_t type);
 static bool sl_si91x_check_for_buffer_empty(void);
+static void sl_si91x_delete_quota_semaphores(void);
+static void sl_si91x_update_buffer_statistics(sl_wifi_buffer_type_t type, bool allocated, uint32_t wait_ticks);
 /*---------------------------------------------------------------------------------*/
 
 sl_status_t sl_si91x_host_init_buffer_manager(const sl_wifi_buffer_configuration_t *config)
@@ -62,12 +68,23 @@ sl_status_t sl_si91x_host_init_buffer_manager(const sl_wifi_buffer_configuration
   VERIFY_STATUS_AND_RETURN(result);
   configuration     = config;
   void *pool_buffer = configuration->buffer_memory;
+  for (int i = 0; i < BUFFER_TYPE; i++) {
+    if (quota[i] == 0) {
+      continue;
+    }
+    quota_semaphore[i] = osSemaphoreNew(quota[i], quota[i], NULL);
+    if (quota_semaphore[i] == NULL) {
+      sl_si91x_delete_quota_semaphores();
+      return SL_STATUS_ALLOCATION_FAILED;
+    }
+  }
   uint8_t block_count =
     configuration->tx_buffer_quota + configuration->rx_buffer_quota + configuration->control_buffer_quota;
   uint32_t buffer_size = configuration->block_size * block_count;
   if (configuration->buffer_memory == NULL) {
     allocated_wifi_buffer = malloc(buffer_size);
     if (allocated_wifi_buffer == NULL) {
+      sl_si91x_delete_quota_semaphores();
       return SL_STATUS_ALLOCATION_FAILED;
     }
     pool_buffer = allocated_wifi_buffer;
@@ -90,6 +107,7 @@ sl_status_t sl_si91x_host_deinit_buffer_manager(void)
     allocated_wifi_buffer = NULL;
   }
   memset(&mem_pool, 0, sizeof(mem_pool));
+  sl_si91x_delete_quota_semaphores();
   return SL_STATUS_OK;
 }
 
@@ -100,27 +118,35 @@ sl_status_t sl_si91x_host_allocate_buffer(sl_wifi_buffer_t **buffer,
 {
 
   UNUSED_PARAMETER(buffer_size);
-  sl_status_t result;
-  do {
-    // Ensuring that buffers are allocated as per the quota set.
-    result = sl_si91x_check_for_buffer_availability(type);
-  } while (result == SL_STATUS_FULL);
-  uint32_t start = osKernelGetTickCount();
-  do {
-    *buffer = sli_mem_pool_alloc(&mem_pool);
-    if (*buffer != NULL) {
-      break;
-    } else {
-      osDelay(1);
-    }
-  } while ((osKernelGetTickCount() - start) < wait_duration_ms);
+  uint32_t start   = osKernelGetTickCount();
+  uint32_t timeout = wait_duration_ms;
+
+  *buffer = NULL;
+  if ((type >= BUFFER_TYPE) || (quota_semaphore[type] == NULL)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (timeout != osWaitForever) {
+    timeout = (uint32_t)(((uint64_t)wait_duration_ms * osKernelGetTickFreq()) / 1000);
+  }
+
+  // Ensuring that buffers are allocated as per the quota set, blocking until a buffer of this type is freed.
+  if (osSemaphoreAcquire(quota_semaphore[type], timeout) != osOK) {
+    sl_si91x_update_buffer_statistics(type, false, osKernelGetTickCount() - start);
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
 
+  // The pool holds the sum of all quotas, so a block is available once quota is granted
+  *buffer = sli_mem_pool_alloc(&mem_pool);
   if (*buffer == NULL) {
+    osSemaphoreRelease(quota_semaphore[type]);
+    sl_si91x_update_buffer_statistics(type, false, osKernelGetTickCount() - start);
     return SL_STATUS_ALLOCATION_FAILED;
   }
   (*buffer)->type = type;
   // Increasing the count of current allocation of a buffer type
   sl_si91x_buffer_type_allocation(type);
+  sl_si91x_update_buffer_statistics(type, true, osKernelGetTickCount() - start);
   (*buffer)->node.node = NULL;
   (*buffer)->length    = configuration->block_size - sizeof(sl_wifi_buffer_t);
   return SL_STATUS_OK;
@@ -139,32 +165,48 @@ void *sl_si91x_host_get_buffer_data(sl_wifi_buffer_t *buffer, uint16_t offset, u
 
 void sl_si91x_host_free_buffer(sl_wifi_buffer_t *buffer)
 {
+  sl_wifi_buffer_type_t type = buffer->type;
+
   sli_mem_pool_free(&mem_pool, buffer);
   // Decreasing the count of the current allocation of the buffer type
-  sl_si91x_buffer_type_deallocation(buffer->type);
+  sl_si91x_buffer_type_deallocation(type);
+  // Returning the quota wakes up the longest waiting allocator of this buffer type
+  osSemaphoreRelease(quota_semaphore[type]);
 }
 
-static void sl_si91x_convert_config_structure_to_array(const sl_wifi_buffer_configuration_t *config)
+sl_status_t sl_si91x_host_get_buffer_statistics(sl_wifi_buffer_type_t type, sl_si91x_buffer_statistics_t *statistics)
 {
+  SL_VERIFY_POINTER_OR_RETURN(statistics, SL_STATUS_NULL_POINTER);
+  if (type >= BUFFER_TYPE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
 
-  quota[SL_WIFI_CONTROL_BUFFER]  = config->control_buffer_quota;
-  quota[SL_WIFI_RX_FRAME_BUFFER] = config->rx_buffer_quota;
-  quota[SL_WIFI_TX_FRAME_BUFFER] = config->tx_buffer_quota;
-  return;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  *statistics        = buffer_statistics[type];
+  statistics->in_use = buffer_allocation[type];
+  CORE_EXIT_CRITICAL();
+  return SL_STATUS_OK;
 }
 
-//This functions checks whether buffers are available as per quota !!
-
-static sl_status_t sl_si91x_check_for_buffer_availability(sl_wifi_buffer_type_t type)
+void sl_si91x_host_reset_buffer_statistics(void)
 {
   CORE_DECLARE_IRQ_STATE;
   CORE_ENTER_CRITICAL();
-  if (buffer_allocation[type] < quota[type]) {
-    CORE_EXIT_CRITICAL();
-    return SL_STATUS_OK;
+  memset(buffer_statistics, 0, sizeof(buffer_statistics));
+  for (int i = 0; i < BUFFER_TYPE; i++) {
+    buffer_statistics[i].high_water_mark = buffer_allocation[i];
   }
   CORE_EXIT_CRITICAL();
-  return SL_STATUS_FULL;
+}
+
+static void sl_si91x_convert_config_structure_to_array(const sl_wifi_buffer_configuration_t *config)
+{
+
+  quota[SL_WIFI_CONTROL_BUFFER]  = config->control_buffer_quota;
+  quota[SL_WIFI_RX_FRAME_BUFFER] = config->rx_buffer_quota;
+  quota[SL_WIFI_TX_FRAME_BUFFER] = config->tx_buffer_quota;
+  return;
 }
 
 static sl_status_t sl_si91x_check_for_valid_config(const sl_wifi_buffer_configuration_t *config)
@@ -199,6 +241,43 @@ static void sl_si91x_buffer_type_deallocation(sl_wifi_buffer_type_t type)
   return;
 }
 
+static void sl_si91x_delete_quota_semaphores(void)
+{
+  for (int i = 0; i < BUFFER_TYPE; i++) {
+    if (quota_semaphore[i] != NULL) {
+      osSemaphoreDelete(quota_semaphore[i]);
+      quota_semaphore[i] = NULL;
+    }
+  }
+}
+
+static void sl_si91x_update_buffer_statistics(sl_wifi_buffer_type_t type, bool allocated, uint32_t wait_ticks)
+{
+  uint32_t wait_ms = (uint32_t)(((uint64_t)wait_ticks * 1000) / osKernelGetTickFreq());
+  uint8_t bin      = 0;
+
+  // Bin 0 counts allocations that did not wait, bin n waits of up to 2^(n-1) ms and the last bin all longer waits
+  if (wait_ticks != 0) {
+    bin = 1;
+    while ((bin < (SL_SI91X_BUFFER_WAIT_HISTOGRAM_BINS - 1)) && (wait_ms > (1UL << (bin - 1)))) {
+      bin++;
+    }
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  if (allocated) {
+    buffer_statistics[type].allocations++;
+    buffer_statistics[type].wait_histogram[bin]++;
+    if (buffer_allocation[type] > buffer_statistics[type].high_water_mark) {
+      buffer_statistics[type].high_water_mark = buffer_allocation[type];
+    }
+  } else {
+    buffer_statistics[type].failed_allocations++;
+  }
+  CORE_EXIT_CRITICAL();
+}
+
 static bool sl_si91x_check_for_buffer_empty(void)
 {
   CORE_DECLARE_IRQ_STATE;
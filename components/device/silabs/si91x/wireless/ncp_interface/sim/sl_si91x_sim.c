@@ -0,0 +1,386 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Software model of the Si91x network processor behind the NCP bus interface
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include "sl_si91x_sim.h"
+#include "sl_si91x_status.h"
+#include "sl_si91x_types.h"
+#include "sl_si91x_constants.h"
+#include "sl_si91x_driver.h"
+#include "sl_si91x_host_interface.h"
+#include "sl_status.h"
+#include "sl_constants.h"
+#include "sl_rsi_utility.h"
+#include "cmsis_os2.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Maximum number of frames the simulated network processor holds back before the host sees them
+#ifndef SL_SI91X_SIM_MAX_PENDING_FRAMES
+#define SL_SI91X_SIM_MAX_PENDING_FRAMES 32
+#endif
+
+#define FRAME_SIZE 1600
+
+// Thread flag raised when a frame is scheduled
+#define SLI_SI91X_SIM_FRAME_SCHEDULED 0x1
+
+// Frame waiting for its delivery time
+typedef struct {
+  sl_wifi_buffer_t *buffer;
+  uint32_t due_tick;
+} sli_si91x_sim_pending_frame_t;
+
+static osThreadId_t sim_thread = NULL;
+static osMutexId_t sim_mutex   = NULL;
+
+// Pending frames, ordered by delivery time; frames due at the same time keep their scheduling order
+static sli_si91x_sim_pending_frame_t pending_frames[SL_SI91X_SIM_MAX_PENDING_FRAMES];
+static uint32_t pending_frame_count = 0;
+
+static sl_si91x_sim_configuration_t sim_configuration = { .command_latency_ms  = SL_SI91X_SIM_COMMAND_LATENCY_MS,
+                                                          .bus_throughput_kbps = SL_SI91X_SIM_BUS_THROUGHPUT_KBPS,
+                                                          .socket_loopback     = true };
+static sl_si91x_sim_frame_handler_t sim_frame_handler = NULL;
+static sl_si91x_sim_statistics_t sim_statistics;
+
+// Tick count at which the modelled bus finishes the last transfer
+static uint32_t bus_free_tick = 0;
+
+/************************************************************************************
+ ******************************** Static Functions *********************************
+************************************************************************************/
+static uint32_t sli_si91x_sim_ms_to_ticks(uint32_t milliseconds)
+{
+  return (uint32_t)(((uint64_t)milliseconds * osKernelGetTickFreq() + 999) / 1000);
+}
+
+// Queues a frame for delivery to the host at due_tick
+static sl_status_t sli_si91x_sim_schedule_frame(uint8_t queue_id,
+                                                uint16_t frame_type,
+                                                uint16_t frame_status,
+                                                const void *payload,
+                                                uint16_t length,
+                                                uint32_t due_tick)
+{
+  sl_wifi_buffer_t *buffer;
+  sl_si91x_packet_t *packet;
+  sl_status_t status;
+  uint32_t index;
+
+  if ((length > (FRAME_SIZE - RSI_FRAME_DESC_LEN)) || ((payload == NULL) && (length != 0))) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = sl_si91x_host_allocate_buffer(&buffer, SL_WIFI_RX_FRAME_BUFFER, RSI_FRAME_DESC_LEN + length, 1000);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  packet = (sl_si91x_packet_t *)sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+  memset(packet->desc, 0, sizeof(packet->desc));
+  packet->length = length & 0xFFF;
+  packet->desc[1] |= (uint8_t)(queue_id << 4);
+  packet->command  = frame_type;
+  packet->desc[12] = (uint8_t)(frame_status & 0xFF);
+  packet->desc[13] = (uint8_t)(frame_status >> 8);
+  if (length != 0) {
+    memcpy(packet->data, payload, length);
+  }
+
+  osMutexAcquire(sim_mutex, osWaitForever);
+  if (pending_frame_count == SL_SI91X_SIM_MAX_PENDING_FRAMES) {
+    osMutexRelease(sim_mutex);
+    sl_si91x_host_free_buffer(buffer);
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  // Insert behind every frame due no later than this one
+  index = pending_frame_count;
+  while ((index > 0) && ((int32_t)(pending_frames[index - 1].due_tick - due_tick) > 0)) {
+    pending_frames[index] = pending_frames[index - 1];
+    index--;
+  }
+  pending_frames[index].buffer   = buffer;
+  pending_frames[index].due_tick = due_tick;
+  pending_frame_count++;
+  osMutexRelease(sim_mutex);
+
+  osThreadFlagsSet(sim_thread, SLI_SI91X_SIM_FRAME_SCHEDULED);
+  return SL_STATUS_OK;
+}
+
+// Delivers pending frames to the bus RX queue once they are due, the way the bus RX interrupt does on hardware
+static void sli_si91x_sim_thread(void *args)
+{
+  UNUSED_PARAMETER(args);
+  uint32_t timeout = osWaitForever;
+
+  while (1) {
+    bool delivered = false;
+
+    osThreadFlagsWait(SLI_SI91X_SIM_FRAME_SCHEDULED, osFlagsWaitAny, timeout);
+    timeout = osWaitForever;
+
+    osMutexAcquire(sim_mutex, osWaitForever);
+    while (pending_frame_count > 0) {
+      int32_t remaining = (int32_t)(pending_frames[0].due_tick - osKernelGetTickCount());
+      if (remaining > 0) {
+        timeout = (uint32_t)remaining;
+        break;
+      }
+
+      const sl_si91x_packet_t *packet =
+        (const sl_si91x_packet_t *)sl_si91x_host_get_buffer_data(pending_frames[0].buffer, 0, NULL);
+      sim_statistics.rx_frames++;
+      sim_statistics.rx_bytes += RSI_FRAME_DESC_LEN + (packet->length & 0xFFF);
+      sl_si91x_host_add_to_queue(CCP_M4_TA_RX_QUEUE, pending_frames[0].buffer);
+      delivered = true;
+
+      pending_frame_count--;
+      memmove(&pending_frames[0], &pending_frames[1], pending_frame_count * sizeof(pending_frames[0]));
+    }
+    osMutexRelease(sim_mutex);
+
+    if (delivered) {
+      sl_si91x_host_set_bus_event(SL_SI91X_NCP_HOST_BUS_RX_EVENT);
+    }
+  }
+}
+
+/************************************************************************************
+ ******************************** Public Functions *********************************
+************************************************************************************/
+sl_status_t sl_si91x_bus_init(void)
+{
+  SL_DEBUG_LOG("Bus Init startup\n");
+
+  if (NULL == sim_mutex) {
+    sim_mutex = osMutexNew(NULL);
+    if (NULL == sim_mutex) {
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  if (NULL == sim_thread) {
+    const osThreadAttr_t attr = {
+      .name       = "si91x_sim",
+      .priority   = osPriorityRealtime2,
+      .stack_mem  = 0,
+      .stack_size = 1024,
+      .cb_mem     = 0,
+      .cb_size    = 0,
+      .attr_bits  = 0u,
+      .tz_module  = 0u,
+    };
+    sim_thread = osThreadNew(sli_si91x_sim_thread, NULL, &attr);
+    if (NULL == sim_thread) {
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  // Drop whatever a previous session left behind
+  osMutexAcquire(sim_mutex, osWaitForever);
+  for (uint32_t i = 0; i < pending_frame_count; i++) {
+    sl_si91x_host_free_buffer(pending_frames[i].buffer);
+  }
+  pending_frame_count = 0;
+  bus_free_tick       = osKernelGetTickCount();
+  osMutexRelease(sim_mutex);
+
+  SL_DEBUG_LOG("Bus Init Done\n");
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_bus_write_memory(uint32_t addr, uint16_t length, const uint8_t *buffer)
+{
+  UNUSED_PARAMETER(addr);
+  UNUSED_PARAMETER(length);
+  UNUSED_PARAMETER(buffer);
+  return SL_STATUS_WIFI_UNSUPPORTED;
+}
+
+sl_status_t sl_si91x_bus_read_memory(uint32_t addr, uint16_t length, uint8_t *buffer)
+{
+  UNUSED_PARAMETER(addr);
+  UNUSED_PARAMETER(length);
+  UNUSED_PARAMETER(buffer);
+  return SL_STATUS_WIFI_UNSUPPORTED;
+}
+
+sl_status_t sl_si91x_bus_write_register(uint8_t address, uint8_t register_size, uint16_t data)
+{
+  UNUSED_PARAMETER(address);
+  UNUSED_PARAMETER(register_size);
+  UNUSED_PARAMETER(data);
+  return SL_STATUS_WIFI_UNSUPPORTED;
+}
+
+sl_status_t sl_si91x_bus_read_register(uint8_t address, uint8_t register_size, uint16_t *output)
+{
+  UNUSED_PARAMETER(address);
+  UNUSED_PARAMETER(register_size);
+  UNUSED_PARAMETER(output);
+  return SL_STATUS_WIFI_UNSUPPORTED;
+}
+
+sl_status_t sl_si91x_bus_write_frame(sl_si91x_packet_t *packet, const uint8_t *payloadparam, uint16_t size_param)
+{
+  UNUSED_PARAMETER(payloadparam);
+  sl_si91x_sim_configuration_t configuration;
+  sl_si91x_sim_frame_handler_t handler;
+  uint32_t frame_bytes = RSI_FRAME_DESC_LEN + size_param;
+  uint32_t now         = osKernelGetTickCount();
+  uint32_t transfer_ticks;
+  uint32_t done_tick;
+  uint8_t queue_id = (packet->desc[1] >> 4);
+
+  osMutexAcquire(sim_mutex, osWaitForever);
+  configuration = sim_configuration;
+  handler       = sim_frame_handler;
+  sim_statistics.tx_frames++;
+  sim_statistics.tx_bytes += frame_bytes;
+
+  // The transfer starts when the bus is free and takes as long as the modelled throughput allows
+  transfer_ticks = 0;
+  if (configuration.bus_throughput_kbps != 0) {
+    transfer_ticks = (uint32_t)(((uint64_t)frame_bytes * 8 * osKernelGetTickFreq())
+                                / ((uint64_t)configuration.bus_throughput_kbps * 1000));
+  }
+  done_tick     = (((int32_t)(bus_free_tick - now) > 0) ? bus_free_tick : now) + transfer_ticks;
+  bus_free_tick = done_tick;
+  osMutexRelease(sim_mutex);
+
+  // Like a real bus transfer, the write blocks the bus thread until the frame is on the other side
+  if ((int32_t)(done_tick - now) > 0) {
+    osDelay(done_tick - now);
+  }
+
+  if ((handler != NULL) && (handler(packet, size_param) == SL_STATUS_OK)) {
+    return SL_STATUS_OK;
+  }
+
+  if (queue_id == RSI_WLAN_DATA_Q) {
+    if (!configuration.socket_loopback) {
+      return SL_STATUS_OK;
+    }
+    // The socket send request header has the layout of the receive metadata, so the frame goes back as is
+    return sli_si91x_sim_schedule_frame(RSI_WLAN_DATA_Q, RSI_RECEIVE_RAW_DATA, 0, packet->data, size_param, done_tick);
+  }
+
+  return sli_si91x_sim_schedule_frame(queue_id,
+                                      packet->command,
+                                      0,
+                                      NULL,
+                                      0,
+                                      done_tick + sli_si91x_sim_ms_to_ticks(configuration.command_latency_ms));
+}
+
+sl_status_t sl_si91x_bus_read_frame(sl_wifi_buffer_t **buffer)
+{
+  sl_status_t status;
+
+  status = sl_si91x_host_remove_from_queue(CCP_M4_TA_RX_QUEUE, buffer);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  return SL_STATUS_OK;
+}
+
+// Function for reading the interrupt status
+sl_status_t sl_si91x_bus_read_interrupt_status(uint16_t *interrupt_status)
+{
+  *interrupt_status = (0 != sl_si91x_host_queue_status(CCP_M4_TA_RX_QUEUE)) ? RSI_RX_PKT_PENDING : 0;
+  return SL_STATUS_OK;
+}
+
+sl_status_t si91x_bootup_firmware(const uint8_t select_option)
+{
+  UNUSED_PARAMETER(select_option);
+  SL_DEBUG_LOG("Bootup startup\n");
+
+  // The simulated firmware is running as soon as the bus is up; announce it the way the device does
+  return sli_si91x_sim_schedule_frame(RSI_WLAN_MGMT_Q, RSI_COMMON_RSP_CARDREADY, 0, NULL, 0, osKernelGetTickCount());
+}
+
+sl_status_t sl_si91x_bus_rx_irq_handler(void)
+{
+  // Frames are delivered by the simulator thread, there is no bus interrupt
+  return SL_STATUS_OK;
+}
+
+void sl_si91x_bus_rx_done_handler(void)
+{
+  return;
+}
+
+void sl_si91x_ulp_wakeup_init(void)
+{
+  return;
+}
+
+void sl_si91x_sim_set_configuration(const sl_si91x_sim_configuration_t *configuration)
+{
+  if ((configuration == NULL) || (sim_mutex == NULL)) {
+    return;
+  }
+  osMutexAcquire(sim_mutex, osWaitForever);
+  sim_configuration = *configuration;
+  osMutexRelease(sim_mutex);
+}
+
+void sl_si91x_sim_set_frame_handler(sl_si91x_sim_frame_handler_t handler)
+{
+  sim_frame_handler = handler;
+}
+
+sl_status_t sl_si91x_sim_inject_frame(uint8_t queue_id,
+                                      uint16_t frame_type,
+                                      uint16_t frame_status,
+                                      const void *payload,
+                                      uint16_t length,
+                                      uint32_t delay_ms)
+{
+  if ((sim_mutex == NULL) || (sim_thread == NULL)) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  return sli_si91x_sim_schedule_frame(queue_id,
+                                      frame_type,
+                                      frame_status,
+                                      payload,
+                                      length,
+                                      osKernelGetTickCount() + sli_si91x_sim_ms_to_ticks(delay_ms));
+}
+
+void sl_si91x_sim_get_statistics(sl_si91x_sim_statistics_t *statistics)
+{
+  if ((statistics == NULL) || (sim_mutex == NULL)) {
+    return;
+  }
+  osMutexAcquire(sim_mutex, osWaitForever);
+  *statistics = sim_statistics;
+  osMutexRelease(sim_mutex);
+}
@@ -0,0 +1,122 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Software model of the Si91x network processor behind the NCP bus interface
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#pragma once
+#include "sl_si91x_types.h"
+#include "sl_status.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Time between a command frame reaching the simulated network processor and its response
+#ifndef SL_SI91X_SIM_COMMAND_LATENCY_MS
+#define SL_SI91X_SIM_COMMAND_LATENCY_MS 1
+#endif
+
+// Modelled bus throughput in kilobits per second, 0 for a bus without transfer time
+#ifndef SL_SI91X_SIM_BUS_THROUGHPUT_KBPS
+#define SL_SI91X_SIM_BUS_THROUGHPUT_KBPS 20000
+#endif
+
+// Structure to represent the behavior of the simulated network processor
+typedef struct {
+  uint32_t command_latency_ms;  // Time between a command frame and its response
+  uint32_t bus_throughput_kbps; // Modelled bus throughput, 0 for a bus without transfer time
+  bool socket_loopback; // Return socket data frames as data received on the same socket instead of discarding them
+} sl_si91x_sim_configuration_t;
+
+// Structure to represent the frame counters of the simulated network processor
+typedef struct {
+  uint32_t tx_frames; // Frames written by the host
+  uint32_t tx_bytes;  // Frame bytes written by the host
+  uint32_t rx_frames; // Frames delivered to the host
+  uint32_t rx_bytes;  // Frame bytes delivered to the host
+} sl_si91x_sim_statistics_t;
+
+/***************************************************************************/ /**
+ * @brief
+ *   Handler called for every frame the host writes to the simulated network processor.
+ * @param[in] packet
+ *   Frame descriptor and payload.
+ * @param[in] length
+ *   Payload length in bytes.
+ * @return
+ *   SL_STATUS_OK if the handler took care of the frame, any other value to let the simulator apply its default
+ *   behavior: a successful response with the same frame type for commands, loopback or discard for socket data.
+ ******************************************************************************/
+typedef sl_status_t (*sl_si91x_sim_frame_handler_t)(const sl_si91x_packet_t *packet, uint16_t length);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Change the behavior of the simulated network processor.
+ * @param[in] configuration
+ *   New configuration, applied to frames written from now on.
+ ******************************************************************************/
+void sl_si91x_sim_set_configuration(const sl_si91x_sim_configuration_t *configuration);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Register a handler that scripts the responses of the simulated network processor.
+ * @param[in] handler
+ *   Frame handler, or NULL to restore the default behavior.
+ ******************************************************************************/
+void sl_si91x_sim_set_frame_handler(sl_si91x_sim_frame_handler_t handler);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Schedule a frame from the simulated network processor to the host, for example a response built by a frame
+ *   handler or an asynchronous event.
+ * @param[in] queue_id
+ *   Firmware queue the frame arrives on, for example RSI_WLAN_MGMT_Q or RSI_WLAN_DATA_Q.
+ * @param[in] frame_type
+ *   Frame type, written to the frame descriptor.
+ * @param[in] frame_status
+ *   Frame status, written to the frame descriptor.
+ * @param[in] payload
+ *   Frame payload, may be NULL if length is 0.
+ * @param[in] length
+ *   Payload length in bytes.
+ * @param[in] delay_ms
+ *   Time after which the host sees the frame.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ ******************************************************************************/
+sl_status_t sl_si91x_sim_inject_frame(uint8_t queue_id,
+                                      uint16_t frame_type,
+                                      uint16_t frame_status,
+                                      const void *payload,
+                                      uint16_t length,
+                                      uint32_t delay_ms);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Read the frame counters of the simulated network processor.
+ * @param[out] statistics
+ *   Frame counters.
+ ******************************************************************************/
+void sl_si91x_sim_get_statistics(sl_si91x_sim_statistics_t *statistics);
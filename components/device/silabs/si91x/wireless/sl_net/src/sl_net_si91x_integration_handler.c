@@ -173,6 +173,13 @@ void sl_net_si91x_event_dispatch_handler(sli_si91x_queue_packet_t *data, sl_si91
     uint16_t si91x_event_status      = get_si91x_frame_status(raw_rx_packet);
 
     sl_status_t event_status = convert_and_save_firmware_status(si91x_event_status);
+
+    // A socket receive ring whose reader is behind keeps the frame and frees it later
+    if ((packet->command == RSI_RECEIVE_RAW_DATA)
+        && (sli_si91x_socket_rx_ring_hold_frame(data->host_packet, raw_rx_packet) == SL_STATUS_IN_PROGRESS)) {
+      data->host_packet = NULL;
+      return;
+    }
     si91x_socket_event_handler(event_status, (sl_si91x_socket_context_t *)data->sdk_context, raw_rx_packet);
   }
 #endif
@@ -65,6 +65,14 @@
 
 #define MAX_RETRANSMISSION_TIME_VALUE 32
 
+// Upper bound accepted for the SO_RX_RING_SIZE socket option, in bytes
+#ifndef SI91X_SOCKET_RX_RING_MAX_SIZE
+#define SI91X_SOCKET_RX_RING_MAX_SIZE (16 * 1024)
+#endif
+
+// Lower bound accepted for the SO_RX_RING_SIZE socket option, in bytes. Every received frame must fit in an empty ring.
+#define SI91X_SOCKET_RX_RING_MIN_SIZE 2048
+
 /**
  * @addtogroup SI91X_SOCKET_OPTION_NAME SiWx91x Socket Option Name
  * @ingroup SI91X_SOCKET_FUNCTIONS
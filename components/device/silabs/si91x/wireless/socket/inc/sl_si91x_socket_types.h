@@ -23,6 +23,7 @@
 #include "socket.h"
 #include "select.h"
 #include "sl_si91x_protocol_types.h"
+#include "sl_wifi_host_interface.h"
 
 /**
  * @addtogroup SI91X_SOCKET_FUNCTIONS
@@ -153,6 +154,22 @@ typedef struct {
   uint8_t value[]; ///< Data
 } si91x_socket_type_length_value_t;
 
+/// Internal si91x host-side receive ring, used when a socket is configured with @ref SO_RX_RING_SIZE
+typedef struct {
+  uint8_t *buffer;                   ///< Ring storage
+  uint32_t size;                     ///< Capacity of the ring in bytes
+  uint32_t head;                     ///< Write offset, advanced by the receive callback or the reader moving held frames
+  uint32_t tail;                     ///< Read offset, only advanced by the reader
+  volatile uint32_t used;            ///< Number of bytes currently held in the ring
+  uint32_t dropped_bytes;            ///< Datagram bytes discarded because the ring was full
+  bool stream;                       ///< Ring of a SOCK_STREAM socket
+  sl_wifi_buffer_t *held_head;       ///< Oldest received stream frame waiting for space in the ring
+  sl_wifi_buffer_t *held_tail;       ///< Newest received stream frame waiting for space in the ring
+  volatile uint32_t callbacks;       ///< Receive callbacks currently using the ring
+  osEventFlagsId_t events;           ///< Data-available, space-available and closed events
+  sl_si91x_socket_metadata_t source; ///< Source of the most recent stream segment
+} si91x_socket_rx_ring_t;
+
 /// Internal si91x socket handle
 typedef struct {
   int32_t id;                                               ///< Socket ID
@@ -184,6 +201,8 @@ typedef struct {
   osEventFlagsId_t socket_events;                        ///< Event Flags for sockets
   int32_t client_id;                                     ///< Client Socket Id for accept
   uint8_t socket_bitmap;                                 ///< Socket Bitmap
+  uint32_t rx_ring_size;                                 ///< Requested host-side receive ring size, 0 if disabled
+  si91x_socket_rx_ring_t *rx_ring;                       ///< Host-side receive ring
 } si91x_socket_t;
 
 /// SiWx91x select context
@@ -156,6 +156,46 @@ sl_status_t add_server_name_indication_extension(si91x_server_name_indication_ex
 
 sl_status_t create_and_send_socket_request(int socketIdIndex, int type, const int *backlog);
 
+/**
+ * A internal function to allocate the host-side receive ring of a socket.
+ * @param socket Socket whose rx_ring_size has been configured.
+ * @return SL_STATUS_OK on success, SL_STATUS_ALLOCATION_FAILED if memory could not be allocated.
+ */
+sl_status_t sli_si91x_socket_rx_ring_create(si91x_socket_t *socket);
+
+/**
+ * A internal function to release the host-side receive ring of a socket, if any.
+ * @param socket Socket owning the ring.
+ */
+void sli_si91x_socket_rx_ring_delete(si91x_socket_t *socket);
+
+/**
+ * A internal function to read buffered data from the host-side receive ring of a socket.
+ * @param socket Socket owning the ring.
+ * @param buffer Destination buffer.
+ * @param length Size of the destination buffer.
+ * @param flags Combination of MSG_PEEK, MSG_WAITALL and MSG_DONTWAIT.
+ * @param source Filled with the source address of the returned data. Can be NULL.
+ * @param bytes_read Number of bytes copied into the buffer.
+ * @return SL_STATUS_OK on success, SL_STATUS_WOULD_BLOCK if no data is available with MSG_DONTWAIT,
+ * SL_STATUS_TIMEOUT if the socket read timeout expired, SL_STATUS_NOT_AVAILABLE if the connection was closed.
+ */
+sl_status_t sli_si91x_socket_rx_ring_read(si91x_socket_t *socket,
+                                          uint8_t *buffer,
+                                          size_t length,
+                                          int flags,
+                                          sl_si91x_socket_metadata_t *source,
+                                          size_t *bytes_read);
+
+/**
+ * A internal function to keep a received stream frame that does not fit in the receive ring of its socket. The frame
+ * is moved into the ring once the reader has made room, which holds back the network processor meanwhile.
+ * @param buffer Driver RX buffer holding the frame.
+ * @param packet Frame in the buffer.
+ * @return SL_STATUS_IN_PROGRESS if the ring took the buffer, SL_STATUS_OK if the frame is to be dispatched as usual.
+ */
+sl_status_t sli_si91x_socket_rx_ring_hold_frame(sl_wifi_buffer_t *buffer, const sl_si91x_packet_t *packet);
+
 int sli_si91x_shutdown(int socket, int how);
 
 int sli_si91x_connect(int socket, const struct sockaddr *addr, socklen_t addr_len);
@@ -25,6 +25,8 @@
 #include "sl_si91x_socket_constants.h"
 #include "sl_si91x_host_interface.h"
 #include "sl_rsi_utility.h"
+#include "em_core.h"
+#include <stdlib.h>
 #include <string.h>
 
 /******************************************************
@@ -33,6 +35,10 @@
 #define SLI_SI91X_SOCKET_ACCEPT_SUCCESS_EVENT (1 << 0)
 #define SLI_SI91X_SOCKET_ACCEPT_FAILURE_EVENT (1 << 1)
 
+#define SLI_SI91X_SOCKET_RX_RING_DATA_EVENT   (1 << 0)
+#define SLI_SI91X_SOCKET_RX_RING_SPACE_EVENT  (1 << 1)
+#define SLI_SI91X_SOCKET_RX_RING_CLOSED_EVENT (1 << 2)
+
 /******************************************************
  *               Variable Definitions
  ******************************************************/
@@ -174,6 +180,8 @@ void reset_socket_state(int socket)
       sli_si91x_sockets[socket]->socket_events = NULL;
     }
 
+    sli_si91x_socket_rx_ring_delete(sli_si91x_sockets[socket]);
+
     free(sli_si91x_sockets[socket]);
     sli_si91x_sockets[socket] = NULL;
   }
@@ -181,6 +189,392 @@ void reset_socket_state(int socket)
   return;
 }
 
+// Copy data into the receive ring starting at the given offset, wrapping around the end of the storage
+static uint32_t sli_si91x_socket_rx_ring_copy_in(si91x_socket_rx_ring_t *ring,
+                                                 uint32_t offset,
+                                                 const uint8_t *data,
+                                                 uint32_t length)
+{
+  uint32_t first_chunk = ring->size - offset;
+
+  if (length <= first_chunk) {
+    memcpy(&ring->buffer[offset], data, length);
+  } else {
+    memcpy(&ring->buffer[offset], data, first_chunk);
+    memcpy(ring->buffer, data + first_chunk, length - first_chunk);
+  }
+
+  return (offset + length) % ring->size;
+}
+
+// Copy data out of the receive ring starting at the given offset, wrapping around the end of the storage
+static uint32_t sli_si91x_socket_rx_ring_copy_out(const si91x_socket_rx_ring_t *ring,
+                                                  uint32_t offset,
+                                                  uint8_t *data,
+                                                  uint32_t length)
+{
+  uint32_t first_chunk = ring->size - offset;
+
+  if (length <= first_chunk) {
+    memcpy(data, &ring->buffer[offset], length);
+  } else {
+    memcpy(data, &ring->buffer[offset], first_chunk);
+    memcpy(data + first_chunk, ring->buffer, length - first_chunk);
+  }
+
+  return (offset + length) % ring->size;
+}
+
+// Publish bytes written by the receive callback to the reader
+static void sli_si91x_socket_rx_ring_commit(si91x_socket_rx_ring_t *ring, uint32_t length)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  ring->used += length;
+  CORE_EXIT_CRITICAL();
+
+  osEventFlagsSet(ring->events, SLI_SI91X_SOCKET_RX_RING_DATA_EVENT);
+}
+
+// Move held stream frames into the ring, oldest first, as far as they fit. Runs on the reader.
+static void sli_si91x_socket_rx_ring_move_held(si91x_socket_rx_ring_t *ring)
+{
+  sl_wifi_buffer_t *buffer                   = NULL;
+  const sl_si91x_packet_t *packet            = NULL;
+  const sl_si91x_socket_metadata_t *metadata = NULL;
+
+  CORE_DECLARE_IRQ_STATE;
+  while (1) {
+    CORE_ENTER_CRITICAL();
+    buffer = ring->held_head;
+    CORE_EXIT_CRITICAL();
+    if (buffer == NULL) {
+      return;
+    }
+
+    packet   = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+    metadata = (const sl_si91x_socket_metadata_t *)packet->data;
+    if ((ring->size - ring->used) < metadata->length) {
+      return;
+    }
+
+    // The frame stays at the head of the list while it is copied, so newer frames keep queuing behind it
+    ring->source = *metadata;
+    ring->head   = sli_si91x_socket_rx_ring_copy_in(ring, ring->head, packet->data + metadata->offset, metadata->length);
+    sli_si91x_socket_rx_ring_commit(ring, metadata->length);
+
+    CORE_ENTER_CRITICAL();
+    ring->held_head = (sl_wifi_buffer_t *)buffer->node.node;
+    if (ring->held_head == NULL) {
+      ring->held_tail = NULL;
+    }
+    CORE_EXIT_CRITICAL();
+
+    sl_si91x_host_free_buffer(buffer);
+    sli_si91x_host_release_rx_frame();
+  }
+}
+
+// Release bytes consumed by the reader back to the receive callback
+static void sli_si91x_socket_rx_ring_consume(si91x_socket_rx_ring_t *ring, uint32_t length)
+{
+  ring->tail = (ring->tail + length) % ring->size;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  ring->used -= length;
+  CORE_EXIT_CRITICAL();
+
+  if (ring->stream) {
+    sli_si91x_socket_rx_ring_move_held(ring);
+  }
+  osEventFlagsSet(ring->events, SLI_SI91X_SOCKET_RX_RING_SPACE_EVENT);
+}
+
+sl_status_t sli_si91x_socket_rx_ring_hold_frame(sl_wifi_buffer_t *buffer, const sl_si91x_packet_t *packet)
+{
+  const sl_si91x_socket_metadata_t *metadata = (const sl_si91x_socket_metadata_t *)packet->data;
+  si91x_socket_rx_ring_t *ring               = NULL;
+  bool held                                  = false;
+
+  for (uint8_t index = 0; index < NUMBER_OF_SOCKETS; index++) {
+    const si91x_socket_t *socket = sli_si91x_sockets[index];
+    if ((socket == NULL) || (socket->id != metadata->socket_id) || (socket->type != SOCK_STREAM)) {
+      continue;
+    }
+
+    // Once a frame is held, the frames after it are held too, so the stream stays in order
+    CORE_DECLARE_IRQ_STATE;
+    CORE_ENTER_CRITICAL();
+    ring = socket->rx_ring;
+    if ((ring != NULL) && ((ring->held_head != NULL) || ((ring->size - ring->used) < metadata->length))) {
+      buffer->node.node = NULL;
+      if (ring->held_tail != NULL) {
+        ring->held_tail->node.node = &buffer->node;
+      } else {
+        ring->held_head = buffer;
+      }
+      ring->held_tail = buffer;
+      held            = true;
+    }
+    CORE_EXIT_CRITICAL();
+    break;
+  }
+
+  if (!held) {
+    return SL_STATUS_OK;
+  }
+  sli_si91x_host_hold_rx_frame();
+  return SL_STATUS_IN_PROGRESS;
+}
+
+// Receive callback attached to sockets configured with a host-side receive ring. It runs on the thread that dispatches
+// received frames, so it never blocks. Stream frames that do not fit never get here: they are held by
+// sli_si91x_socket_rx_ring_hold_frame() until the reader makes room. Datagrams that do not fit are dropped and
+// counted, as the sender is not flow controlled.
+static void sli_si91x_socket_rx_ring_receive_callback(uint32_t socket,
+                                                      uint8_t *buffer,
+                                                      uint32_t length,
+                                                      const sl_si91x_socket_metadata_t *firmware_socket_response)
+{
+  const si91x_socket_t *si91x_socket = get_si91x_socket((int)socket);
+  si91x_socket_rx_ring_t *ring       = NULL;
+
+  if (si91x_socket == NULL) {
+    return;
+  }
+
+  // Register with the ring so that sli_si91x_socket_rx_ring_delete() waits for this callback
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  ring = si91x_socket->rx_ring;
+  if (ring != NULL) {
+    ring->callbacks++;
+  }
+  CORE_EXIT_CRITICAL();
+  if (ring == NULL) {
+    return;
+  }
+
+  if (!ring->stream) {
+    sl_si91x_socket_metadata_t record = *firmware_socket_response;
+
+    // Each datagram is stored as its metadata followed by the payload, so that boundaries and source are preserved
+    if ((ring->size - ring->used) < (sizeof(record) + length)) {
+      ring->dropped_bytes += length;
+    } else {
+      record.length = length;
+      record.offset = sizeof(record);
+      ring->head    = sli_si91x_socket_rx_ring_copy_in(ring, ring->head, (const uint8_t *)&record, sizeof(record));
+      ring->head    = sli_si91x_socket_rx_ring_copy_in(ring, ring->head, buffer, length);
+      sli_si91x_socket_rx_ring_commit(ring, sizeof(record) + length);
+    }
+  } else if ((ring->size - ring->used) >= length) {
+    ring->source = *firmware_socket_response;
+    ring->head   = sli_si91x_socket_rx_ring_copy_in(ring, ring->head, buffer, length);
+    sli_si91x_socket_rx_ring_commit(ring, length);
+  }
+
+  CORE_ENTER_CRITICAL();
+  ring->callbacks--;
+  CORE_EXIT_CRITICAL();
+}
+
+// Wait until the receive ring holds more than 'threshold' bytes
+static sl_status_t sli_si91x_socket_rx_ring_wait(const si91x_socket_t *socket,
+                                                 uint32_t threshold,
+                                                 int flags,
+                                                 uint32_t start_tick,
+                                                 uint32_t timeout)
+{
+  const si91x_socket_rx_ring_t *ring = socket->rx_ring;
+  uint32_t remaining                 = timeout;
+  uint32_t elapsed                   = 0;
+  uint32_t events                    = 0;
+
+  while (ring->used <= threshold) {
+    if (socket->state == DISCONNECTED) {
+      return SL_STATUS_NOT_AVAILABLE;
+    }
+    if (flags & MSG_DONTWAIT) {
+      return SL_STATUS_WOULD_BLOCK;
+    }
+
+    if (timeout != osWaitForever) {
+      elapsed = osKernelGetTickCount() - start_tick;
+      if (elapsed >= timeout) {
+        return SL_STATUS_TIMEOUT;
+      }
+      remaining = timeout - elapsed;
+    }
+
+    events = osEventFlagsWait(ring->events,
+                              SLI_SI91X_SOCKET_RX_RING_DATA_EVENT | SLI_SI91X_SOCKET_RX_RING_CLOSED_EVENT,
+                              osFlagsWaitAny,
+                              remaining);
+    if (events == (uint32_t)osFlagsErrorTimeout) {
+      return SL_STATUS_TIMEOUT;
+    } else if (events & osFlagsError) {
+      return SL_STATUS_FAIL;
+    }
+  }
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t sli_si91x_socket_rx_ring_create(si91x_socket_t *socket)
+{
+  si91x_socket_rx_ring_t *ring = NULL;
+
+  if ((socket == NULL) || (socket->rx_ring_size == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (socket->rx_ring != NULL) {
+    return SL_STATUS_OK;
+  }
+
+  ring = malloc(sizeof(si91x_socket_rx_ring_t));
+  if (ring == NULL) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  memset(ring, 0, sizeof(si91x_socket_rx_ring_t));
+
+  ring->size   = socket->rx_ring_size;
+  ring->stream = (socket->type == SOCK_STREAM);
+  ring->buffer = malloc(ring->size);
+  ring->events = osEventFlagsNew(NULL);
+  if ((ring->buffer == NULL) || (ring->events == NULL)) {
+    if (ring->events != NULL) {
+      osEventFlagsDelete(ring->events);
+    }
+    free(ring->buffer);
+    free(ring);
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+
+  socket->rx_ring = ring;
+  return SL_STATUS_OK;
+}
+
+void sli_si91x_socket_rx_ring_delete(si91x_socket_t *socket)
+{
+  si91x_socket_rx_ring_t *ring = NULL;
+
+  if (socket == NULL) {
+    return;
+  }
+
+  // Detach the ring so that no new receive callback can pick it up, then wait for those already using it
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  ring            = socket->rx_ring;
+  socket->rx_ring = NULL;
+  CORE_EXIT_CRITICAL();
+  if (ring == NULL) {
+    return;
+  }
+  while (ring->callbacks != 0) {
+    osDelay(1);
+  }
+
+  // Return the frames still waiting for space to the driver
+  while (ring->held_head != NULL) {
+    sl_wifi_buffer_t *buffer = ring->held_head;
+    ring->held_head          = (sl_wifi_buffer_t *)buffer->node.node;
+    sl_si91x_host_free_buffer(buffer);
+    sli_si91x_host_release_rx_frame();
+  }
+
+  osEventFlagsDelete(ring->events);
+  free(ring->buffer);
+  free(ring);
+}
+
+sl_status_t sli_si91x_socket_rx_ring_read(si91x_socket_t *socket,
+                                          uint8_t *buffer,
+                                          size_t length,
+                                          int flags,
+                                          sl_si91x_socket_metadata_t *source,
+                                          size_t *bytes_read)
+{
+  si91x_socket_rx_ring_t *ring = socket->rx_ring;
+  sl_status_t status           = SL_STATUS_OK;
+  uint32_t start_tick          = osKernelGetTickCount();
+  uint32_t timeout             = osWaitForever;
+  uint32_t offset              = 0;
+  uint32_t available           = 0;
+  uint32_t chunk               = 0;
+  size_t copied                = 0;
+
+  *bytes_read = 0;
+
+  // A read timeout of zero blocks until data arrives, matching the firmware behaviour
+  if (socket->read_timeout != 0) {
+    timeout = (uint32_t)(((uint64_t)socket->read_timeout * osKernelGetTickFreq()) / 1000);
+  }
+
+  if (socket->type != SOCK_STREAM) {
+    sl_si91x_socket_metadata_t record = { 0 };
+
+    status = sli_si91x_socket_rx_ring_wait(socket, 0, flags, start_tick, timeout);
+    if (status != SL_STATUS_OK) {
+      return status;
+    }
+
+    // Datagrams are returned one at a time; any part that does not fit in the buffer is discarded
+    offset = sli_si91x_socket_rx_ring_copy_out(ring, ring->tail, (uint8_t *)&record, sizeof(record));
+    chunk  = (record.length < length) ? record.length : (uint32_t)length;
+    sli_si91x_socket_rx_ring_copy_out(ring, offset, buffer, chunk);
+
+    if (source != NULL) {
+      *source = record;
+    }
+    if (!(flags & MSG_PEEK)) {
+      sli_si91x_socket_rx_ring_consume(ring, sizeof(record) + record.length);
+    }
+
+    *bytes_read = chunk;
+    return SL_STATUS_OK;
+  }
+
+  while (copied < length) {
+    // A peek leaves previously copied bytes in the ring, so wait for data beyond them
+    status = sli_si91x_socket_rx_ring_wait(socket,
+                                           (flags & MSG_PEEK) ? (uint32_t)copied : 0,
+                                           flags,
+                                           start_tick,
+                                           timeout);
+    if (status != SL_STATUS_OK) {
+      break;
+    }
+
+    available = ring->used - ((flags & MSG_PEEK) ? (uint32_t)copied : 0);
+    chunk     = ((length - copied) < available) ? (uint32_t)(length - copied) : available;
+
+    if (flags & MSG_PEEK) {
+      sli_si91x_socket_rx_ring_copy_out(ring, (ring->tail + (uint32_t)copied) % ring->size, buffer + copied, chunk);
+    } else {
+      sli_si91x_socket_rx_ring_copy_out(ring, ring->tail, buffer + copied, chunk);
+      sli_si91x_socket_rx_ring_consume(ring, chunk);
+    }
+    copied += chunk;
+
+    if (!(flags & MSG_WAITALL)) {
+      break;
+    }
+  }
+
+  if (copied == 0) {
+    return status;
+  }
+
+  if (source != NULL) {
+    *source = ring->source;
+  }
+  *bytes_read = copied;
+  return SL_STATUS_OK;
+}
+
 // Get the SI91X socket with the specified index, if it is valid and not in RESET state
 si91x_socket_t *get_si91x_socket(int socket)
 {
@@ -395,6 +789,16 @@ sl_status_t create_and_send_socket_request(int socketIdIndex, int type, const in
     socket_create_request.max_count = 0;
   }
 
+  // Sockets with a host-side receive ring get data pushed by the firmware instead of issuing read requests.
+  // Listening sockets only pass the mode on; each accepted socket owns its ring.
+  if ((si91x_bsd_socket->rx_ring_size != 0) && (si91x_bsd_socket->recv_data_callback == NULL)) {
+    if (type != SI91X_SOCKET_TCP_SERVER) {
+      status = sli_si91x_socket_rx_ring_create(si91x_bsd_socket);
+      VERIFY_STATUS_AND_RETURN(status);
+    }
+    si91x_bsd_socket->recv_data_callback = sli_si91x_socket_rx_ring_receive_callback;
+  }
+
   if (si91x_bsd_socket->recv_data_callback == NULL) {
     socket_create_request.socket_bitmap |= SI91X_SOCKET_FEAT_SYNCHRONOUS;
   }
@@ -654,6 +1058,9 @@ sl_status_t si91x_socket_event_handler(sl_status_t status,
         continue;
 
       socket->state = DISCONNECTED;
+      if (socket->rx_ring != NULL) {
+        osEventFlagsSet(socket->rx_ring->events, SLI_SI91X_SOCKET_RX_RING_CLOSED_EVENT);
+      }
       /* Flush the pending tx request packets from the socket command queue */
       sl_si91x_host_flush_nodes_from_queue(SI91X_SOCKET_CMD_QUEUE,
                                            remote_socket_closure,
@@ -36,6 +36,8 @@
 #include "sl_constants.h"
 #include "sl_wifi_types.h"
 #include "sl_rsi_utility.h"
+#include "sl_si91x_command_latency.h"
+#include "sli_si91x_lock_free_queue.h"
 #include <string.h>
 #include "cmsis_os2.h" // CMSIS RTOS2
 #include "sl_si91x_types.h"
@@ -59,6 +61,21 @@ osMutexId_t side_band_crypto_mutex = 0;
 
 si91x_packet_queue_t cmd_queues[SI91X_QUEUE_MAX];
 
+// Completion slot through which the bus thread hands a response directly to the thread waiting for it
+typedef struct {
+  osSemaphoreId_t completion;
+  sl_wifi_buffer_t *response;
+  uint16_t packet_id;
+  bool armed;
+} sli_si91x_response_slot_t;
+
+// Slots are indexed by command queue and packet ID, so a response finds its waiter without scanning
+static sli_si91x_response_slot_t response_slots[SI91X_CMD_MAX][SL_SI91X_RESPONSE_SLOTS_PER_QUEUE];
+
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+static sli_si91x_lock_free_queue_t lock_free_queues[SI91X_QUEUE_MAX];
+#endif
+
 static bool sli_si91x_packet_status = 0;
 
 extern bool device_initialized;
@@ -654,6 +671,18 @@ sl_status_t sl_si91x_platform_init(void)
     cmd_queues[i].mutex               = osMutexNew(NULL);
     cmd_queues[i].flag                = (1 << i);
     cmd_queues[i].queued_packet_count = 0;
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+    sli_si91x_lock_free_queue_init(&lock_free_queues[i]);
+#endif
+  }
+
+  // Initialize response completion slots
+  for (int i = 0; i < SI91X_CMD_MAX; i++) {
+    for (int j = 0; j < SL_SI91X_RESPONSE_SLOTS_PER_QUEUE; j++) {
+      response_slots[i][j].completion = osSemaphoreNew(1, 0, NULL);
+      response_slots[i][j].response   = NULL;
+      response_slots[i][j].armed      = false;
+    }
   }
 
   // Create malloc/free mutex
@@ -708,6 +737,15 @@ sl_status_t sl_si91x_platform_deinit(void)
     cmd_queues[i].mutex = NULL;
   }
 
+  // Delete response completion slots
+  for (int i = 0; i < SI91X_CMD_MAX; i++) {
+    for (int j = 0; j < SL_SI91X_RESPONSE_SLOTS_PER_QUEUE; j++) {
+      osSemaphoreDelete(response_slots[i][j].completion);
+      response_slots[i][j].completion = NULL;
+      response_slots[i][j].armed      = false;
+    }
+  }
+
   // Delete malloc/free mutex
   osMutexDelete(malloc_free_mutex);
   malloc_free_mutex = NULL;
@@ -753,10 +791,129 @@ void sl_si91x_host_set_async_event(uint32_t event_mask)
   osEventFlagsSet(si91x_async_events, event_mask);
 }
 
+// Return the completion slot for a packet ID of a synchronous response queue, or NULL for other queues
+static sli_si91x_response_slot_t *sli_si91x_get_response_slot(sl_si91x_queue_type_t queue, uint16_t packet_id)
+{
+  if ((queue < SI91X_COMMON_RESPONSE_QUEUE) || (queue >= (SI91X_COMMON_RESPONSE_QUEUE + SI91X_CMD_MAX))) {
+    return NULL;
+  }
+
+  return &response_slots[queue - SI91X_COMMON_RESPONSE_QUEUE][packet_id % SL_SI91X_RESPONSE_SLOTS_PER_QUEUE];
+}
+
+sl_status_t sli_si91x_response_slot_arm(sl_si91x_queue_type_t queue, uint16_t packet_id)
+{
+  sli_si91x_response_slot_t *slot = sli_si91x_get_response_slot(queue, packet_id);
+  sl_status_t status              = SL_STATUS_BUSY;
+
+  if ((slot == NULL) || (slot->completion == NULL)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+  if (!slot->armed) {
+    // Drop a completion left over from a waiter that timed out just as its response arrived
+    osSemaphoreAcquire(slot->completion, 0);
+    slot->packet_id = packet_id;
+    slot->response  = NULL;
+    slot->armed     = true;
+    status          = SL_STATUS_OK;
+  }
+  osMutexRelease(cmd_queues[queue].mutex);
+
+  return status;
+}
+
+void sli_si91x_response_slot_disarm(sl_si91x_queue_type_t queue, uint16_t packet_id)
+{
+  sli_si91x_response_slot_t *slot = sli_si91x_get_response_slot(queue, packet_id);
+
+  if (slot == NULL) {
+    return;
+  }
+
+  osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+  if (slot->armed && (slot->packet_id == packet_id)) {
+    slot->armed = false;
+  }
+  osMutexRelease(cmd_queues[queue].mutex);
+}
+
+sl_status_t sli_si91x_response_slot_wait(sl_si91x_queue_type_t queue,
+                                         uint16_t packet_id,
+                                         uint32_t timeout,
+                                         sl_wifi_buffer_t **buffer)
+{
+  sli_si91x_response_slot_t *slot = sli_si91x_get_response_slot(queue, packet_id);
+  sl_status_t status              = SL_STATUS_TIMEOUT;
+
+  if (slot == NULL) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  osSemaphoreAcquire(slot->completion, timeout);
+
+  // Check under the queue lock so that a response delivered right at the timeout is not lost
+  osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+  if (slot->response != NULL) {
+    *buffer        = slot->response;
+    slot->response = NULL;
+    status         = SL_STATUS_OK;
+  }
+  slot->armed = false;
+  osMutexRelease(cmd_queues[queue].mutex);
+
+  return status;
+}
+
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+// Only queues with a single consumer and no arbitrary node removal or flushing bypass the queue mutex: socket data
+// (application threads to bus thread) and the asynchronous event queues (bus thread to event thread)
+static bool sli_si91x_is_lock_free_queue(sl_si91x_queue_type_t queue)
+{
+  return (queue == SI91X_SOCKET_DATA_QUEUE) || (queue == SI91X_WLAN_EVENT_QUEUE)
+         || (queue == SI91X_NETWORK_EVENT_QUEUE) || (queue == SI91X_SOCKET_EVENT_QUEUE);
+}
+
+static void sli_si91x_lock_free_push(sl_si91x_queue_type_t queue, sl_wifi_buffer_t *packet)
+{
+  sli_si91x_lock_free_link(&lock_free_queues[queue], &packet->node);
+  // The count is only raised once the packet is reachable, so a non-zero count never points past the list end
+  __atomic_add_fetch(&cmd_queues[queue].queued_packet_count, 1, __ATOMIC_RELEASE);
+}
+
+static sl_wifi_buffer_t *sli_si91x_lock_free_pop(sl_si91x_queue_type_t queue)
+{
+  return (sl_wifi_buffer_t *)sli_si91x_lock_free_unlink(&lock_free_queues[queue]);
+}
+#endif
+
 sl_status_t sl_si91x_host_add_to_queue(sl_si91x_queue_type_t queue, sl_wifi_buffer_t *buffer)
 {
   sl_wifi_buffer_t *packet = buffer;
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+  if (sli_si91x_is_lock_free_queue(queue)) {
+    sli_si91x_lock_free_push(queue, packet);
+    return SL_STATUS_OK;
+  }
+#endif
   osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+
+  // Hand a synchronous response straight to its waiter if one has armed a completion slot for it
+  if ((queue >= SI91X_COMMON_RESPONSE_QUEUE) && (queue < (SI91X_COMMON_RESPONSE_QUEUE + SI91X_CMD_MAX))) {
+    const sli_si91x_queue_packet_t *node = sl_si91x_host_get_buffer_data(packet, 0, NULL);
+    sli_si91x_response_slot_t *slot      = sli_si91x_get_response_slot(queue, node->packet_id);
+
+    SLI_SI91X_COMMAND_TRACE(queue - SI91X_COMMON_RESPONSE_QUEUE, node->packet_id, 0, SL_SI91X_COMMAND_STAGE_RESPONSE);
+
+    if (slot->armed && (slot->packet_id == node->packet_id) && (slot->response == NULL)) {
+      slot->response = packet;
+      osSemaphoreRelease(slot->completion);
+      osMutexRelease(cmd_queues[queue].mutex);
+      return SL_STATUS_OK;
+    }
+  }
+
   packet->node.node = NULL;
 
   if (cmd_queues[queue].tail == NULL) {
@@ -780,6 +937,22 @@ sl_status_t sl_si91x_host_add_to_queue_with_atomic_action(sl_si91x_queue_type_t
 {
   sl_wifi_buffer_t *packet = buffer;
 
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+  if (sli_si91x_is_lock_free_queue(queue)) {
+    // The consumer never takes the mutex, but producers with an action still do so that actions run one at a time
+    // and in enqueue order
+    if (NULL != handler) {
+      osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+      handler(user_data);
+      sli_si91x_lock_free_push(queue, packet);
+      osMutexRelease(cmd_queues[queue].mutex);
+    } else {
+      sli_si91x_lock_free_push(queue, packet);
+    }
+    return SL_STATUS_OK;
+  }
+#endif
+
   osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL); // Acquire the mutex with a specified timeout
   if (NULL != handler) {
     handler(user_data); // Perform an atomic action with user data
@@ -806,6 +979,19 @@ sl_status_t sl_si91x_host_add_to_queue_with_atomic_action(sl_si91x_queue_type_t
 sl_status_t sl_si91x_host_remove_from_queue(sl_si91x_queue_type_t queue, sl_wifi_buffer_t **buffer)
 {
   sl_wifi_buffer_t *packet = NULL;
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+  if (sli_si91x_is_lock_free_queue(queue)) {
+    packet = sli_si91x_lock_free_pop(queue);
+    // With a non-zero count, nothing reachable means a producer was preempted between claiming the tail and linking
+    // it. Report the queue empty instead of waiting here; the consumer retries once the producer signals its packet.
+    if (NULL == packet) {
+      return SL_STATUS_EMPTY;
+    }
+    __atomic_sub_fetch(&cmd_queues[queue].queued_packet_count, 1, __ATOMIC_RELAXED);
+    *buffer = packet;
+    return SL_STATUS_OK;
+  }
+#endif
   osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
 
   if (cmd_queues[queue].tail == NULL) {
@@ -1032,6 +1218,13 @@ uint32_t sl_si91x_host_queue_status(sl_si91x_queue_type_t queue)
 {
   uint32_t status = 0;
 
+#ifdef SL_SI91X_LOCK_FREE_QUEUES
+  if (sli_si91x_is_lock_free_queue(queue)) {
+    return (0 == __atomic_load_n(&cmd_queues[queue].queued_packet_count, __ATOMIC_ACQUIRE)) ? 0
+                                                                                           : cmd_queues[queue].flag;
+  }
+#endif
+
   osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL); // Acquire the mutex with an timeout
 
   // Check if the queue is empty based on the tail pointer
@@ -1075,6 +1268,16 @@ uint32_t si91x_host_wait_for_async_event(uint32_t event_mask, uint32_t timeout)
   return result;
 }
 
+void sli_si91x_clear_events_if_queue_empty(sl_si91x_queue_type_t queue, uint32_t event_mask)
+{
+  // The queue lock orders the check against producers, which set the event only after enqueueing
+  osMutexAcquire(cmd_queues[queue].mutex, 0xFFFFFFFFUL);
+  if (0 == cmd_queues[queue].queued_packet_count) {
+    si91x_host_clear_events(event_mask);
+  }
+  osMutexRelease(cmd_queues[queue].mutex);
+}
+
 uint32_t si91x_host_clear_events(uint32_t event_mask)
 {
   uint32_t result = osEventFlagsClear(si91x_events, event_mask);
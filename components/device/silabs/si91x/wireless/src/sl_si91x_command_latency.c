@@ -0,0 +1,226 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Per-command lifecycle tracing and latency histograms for the Si91x driver
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#include "sl_si91x_command_latency.h"
+#include "sl_si91x_types.h"
+#include "sl_constants.h"
+#include "cmsis_os2.h"
+#include "em_core.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Attempts to copy a trace record that a writer is in the middle of before giving up on it
+#define SLI_SI91X_COMMAND_TRACE_READ_RETRIES 4
+
+// Stage timestamps of a command between being queued and its waiter resuming
+typedef struct {
+  bool valid;
+  uint8_t queue;
+  uint16_t packet_id;
+  uint16_t command;
+  uint8_t reached; // Bit mask of the stages reached
+  uint32_t tick[SL_SI91X_COMMAND_STAGE_COUNT];
+} sli_si91x_command_in_flight_t;
+
+// Stages an interval of sl_si91x_command_latency_interval_t starts and ends at
+static const uint8_t interval_stages[SL_SI91X_COMMAND_LATENCY_COUNT][2] = {
+  [SL_SI91X_COMMAND_LATENCY_QUEUED]   = { SL_SI91X_COMMAND_STAGE_ENQUEUED, SL_SI91X_COMMAND_STAGE_WRITTEN },
+  [SL_SI91X_COMMAND_LATENCY_DEVICE]   = { SL_SI91X_COMMAND_STAGE_WRITTEN, SL_SI91X_COMMAND_STAGE_RESPONSE },
+  [SL_SI91X_COMMAND_LATENCY_DELIVERY] = { SL_SI91X_COMMAND_STAGE_RESPONSE, SL_SI91X_COMMAND_STAGE_WOKEN },
+  [SL_SI91X_COMMAND_LATENCY_TOTAL]    = { SL_SI91X_COMMAND_STAGE_ENQUEUED, SL_SI91X_COMMAND_STAGE_WOKEN },
+};
+
+// Trace ring; writers claim a slot by incrementing the head, so recording never blocks. The sequence of a record is 0
+// while it is being written, so a reader that sees the same sequence before and after copying it has a whole record.
+static sl_si91x_command_trace_record_t trace_ring[SL_SI91X_COMMAND_TRACE_RING_SIZE];
+static uint32_t trace_ring_head;
+
+// Commands in flight, indexed by queue and packet ID
+static sli_si91x_command_in_flight_t in_flight[SL_SI91X_COMMAND_TRACE_IN_FLIGHT];
+
+static sl_si91x_command_latency_t command_latency[SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS];
+static uint32_t command_latency_count;
+
+static uint8_t sli_si91x_latency_bin(uint32_t ticks, uint32_t milliseconds)
+{
+  uint8_t bin = 0;
+
+  // Bin 0 counts intervals shorter than a tick, bin n intervals of up to 2^(n-1) ms and the last bin all longer ones
+  if (ticks != 0) {
+    bin = 1;
+    while ((bin < (SL_SI91X_COMMAND_LATENCY_HISTOGRAM_BINS - 1)) && (milliseconds > (1UL << (bin - 1)))) {
+      bin++;
+    }
+  }
+  return bin;
+}
+
+// Folds the stage timestamps of a completed command into the histograms of its command ID; called in a critical section
+static void sli_si91x_command_latency_update(const sli_si91x_command_in_flight_t *entry)
+{
+  sl_si91x_command_latency_t *latency = NULL;
+
+  for (uint32_t i = 0; i < command_latency_count; i++) {
+    if (command_latency[i].command == entry->command) {
+      latency = &command_latency[i];
+      break;
+    }
+  }
+  if (latency == NULL) {
+    if (command_latency_count == SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS) {
+      return;
+    }
+    latency = &command_latency[command_latency_count++];
+    memset(latency, 0, sizeof(*latency));
+    latency->command = entry->command;
+  }
+
+  latency->count++;
+  for (int i = 0; i < SL_SI91X_COMMAND_LATENCY_COUNT; i++) {
+    uint8_t start = interval_stages[i][0];
+    uint8_t end   = interval_stages[i][1];
+    if ((entry->reached & ((1 << start) | (1 << end))) != ((1 << start) | (1 << end))) {
+      continue;
+    }
+    uint32_t ticks        = entry->tick[end] - entry->tick[start];
+    uint32_t milliseconds = (uint32_t)(((uint64_t)ticks * 1000) / osKernelGetTickFreq());
+    latency->histogram[i][sli_si91x_latency_bin(ticks, milliseconds)]++;
+    if (milliseconds > latency->max_ms[i]) {
+      latency->max_ms[i] = milliseconds;
+    }
+  }
+}
+
+void sli_si91x_command_trace_record(uint8_t queue, uint16_t packet_id, uint16_t command, sl_si91x_command_stage_t stage)
+{
+  uint32_t now                         = osKernelGetTickCount();
+  uint32_t slot                        = ((uint32_t)packet_id * SI91X_CMD_MAX + queue) % SL_SI91X_COMMAND_TRACE_IN_FLIGHT;
+  sli_si91x_command_in_flight_t *entry = &in_flight[slot];
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  if (stage == SL_SI91X_COMMAND_STAGE_ENQUEUED) {
+    // A command that never completed leaves a stale entry behind; the next command with the same slot reclaims it
+    memset(entry, 0, sizeof(*entry));
+    entry->valid     = true;
+    entry->queue     = queue;
+    entry->packet_id = packet_id;
+    entry->command   = command;
+  }
+  if (entry->valid && (entry->queue == queue) && (entry->packet_id == packet_id)) {
+    entry->tick[stage] = now;
+    entry->reached |= (uint8_t)(1 << stage);
+    if (command == 0) {
+      command = entry->command;
+    }
+    if (stage == SL_SI91X_COMMAND_STAGE_WOKEN) {
+      sli_si91x_command_latency_update(entry);
+      entry->valid = false;
+    }
+  }
+  CORE_EXIT_CRITICAL();
+
+  uint32_t sequence                       = __atomic_add_fetch(&trace_ring_head, 1, __ATOMIC_RELAXED);
+  sl_si91x_command_trace_record_t *record = &trace_ring[(sequence - 1) % SL_SI91X_COMMAND_TRACE_RING_SIZE];
+  __atomic_store_n(&record->sequence, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  record->tick      = now;
+  record->command   = command;
+  record->packet_id = packet_id;
+  record->queue     = queue;
+  record->stage     = (uint8_t)stage;
+  // Publish the record last, so a reader can tell a complete record from one being overwritten
+  __atomic_store_n(&record->sequence, sequence, __ATOMIC_RELEASE);
+}
+
+uint32_t sl_si91x_get_command_latencies(sl_si91x_command_latency_t *latencies, uint32_t max_count)
+{
+  uint32_t count;
+
+  if (latencies == NULL) {
+    return 0;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  count = (command_latency_count < max_count) ? command_latency_count : max_count;
+  memcpy(latencies, command_latency, count * sizeof(command_latency[0]));
+  CORE_EXIT_CRITICAL();
+  return count;
+}
+
+uint32_t sl_si91x_get_command_trace(sl_si91x_command_trace_record_t *records, uint32_t max_count)
+{
+  uint32_t head  = __atomic_load_n(&trace_ring_head, __ATOMIC_ACQUIRE);
+  uint32_t first = (head > SL_SI91X_COMMAND_TRACE_RING_SIZE) ? (head - SL_SI91X_COMMAND_TRACE_RING_SIZE) : 0;
+  uint32_t count = 0;
+
+  if (records == NULL) {
+    return 0;
+  }
+  if ((head - first) > max_count) {
+    first = head - max_count;
+  }
+
+  for (uint32_t sequence = first + 1; sequence <= head; sequence++) {
+    const sl_si91x_command_trace_record_t *record = &trace_ring[(sequence - 1) % SL_SI91X_COMMAND_TRACE_RING_SIZE];
+
+    for (uint32_t retry = 0; retry < SLI_SI91X_COMMAND_TRACE_READ_RETRIES; retry++) {
+      uint32_t before = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+      if (before == 0) {
+        // A writer is filling the slot
+        continue;
+      }
+      if (before != sequence) {
+        // Not written yet or already overwritten by a newer record
+        break;
+      }
+      records[count] = *record;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&record->sequence, __ATOMIC_RELAXED) == before) {
+        records[count].sequence = sequence;
+        count++;
+        break;
+      }
+    }
+  }
+  return count;
+}
+
+void sl_si91x_reset_command_latency(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  memset(command_latency, 0, sizeof(command_latency));
+  command_latency_count = 0;
+  memset(in_flight, 0, sizeof(in_flight));
+  memset(trace_ring, 0, sizeof(trace_ring));
+  trace_ring_head = 0;
+  CORE_EXIT_CRITICAL();
+}
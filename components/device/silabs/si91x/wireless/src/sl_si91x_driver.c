@@ -41,6 +41,7 @@
 #include <string.h>
 #include <assert.h>
 #include "sl_si91x_core_utilities.h"
+#include "sl_si91x_command_latency.h"
 #ifdef SLI_SI91X_MCU_INTERFACE
 #include "em_core.h"
 #include "sli_siwx917_soc.h"
@@ -118,6 +119,7 @@ typedef struct {
   uint16_t packet_id;
   sli_si91x_queue_packet_t *packet;
   void *payload;
+  uint16_t command; // Command ID traced as enqueued by sl_si91x_atomic_packet_id_allocator, 0 to skip tracing
 } sl_si91x_driver_context_t;
 
 static sl_si91x_timeout_t timeout_glbl = { .auth_assoc_timeout_value       = SL_WIFI_DEFAULT_AUTH_ASSOCIATION_TIMEOUT,
@@ -487,13 +489,12 @@ sl_status_t sl_si91x_driver_init(const sl_wifi_device_configuration_t *config, s
   VERIFY_STATUS_AND_RETURN(status);
 
 #ifndef SLI_SI91X_MCU_INTERFACE
-  // Create and release a semaphore for DATA TX
+  // Create a semaphore for DATA TX, with one token per frame the bus thread may write in a burst
   if (cmd_lock == NULL) {
-    cmd_lock = osSemaphoreNew(1, 0, NULL);
+    cmd_lock = osSemaphoreNew(SL_SI91X_TX_BATCH_MAX_FRAMES, SL_SI91X_TX_BATCH_MAX_FRAMES, NULL);
     if (cmd_lock == NULL) {
       return SL_STATUS_FAIL;
     }
-    osSemaphoreRelease(cmd_lock);
   }
 #endif
 
@@ -806,11 +807,34 @@ sl_status_t sl_si91x_driver_raw_send_command(uint8_t command,
 {
   UNUSED_PARAMETER(wait_time);
   sl_wifi_buffer_t *buffer;
+  void *frame_data;
+  sl_status_t status = SL_STATUS_OK;
+
+  status = sl_si91x_driver_allocate_raw_buffer(command, data_length, &buffer, &frame_data);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  // Copy the command data if available
+  if (data != NULL) {
+    memcpy(frame_data, data, data_length);
+  }
+
+  return sl_si91x_driver_send_raw_buffer(buffer);
+}
+
+sl_status_t sl_si91x_driver_allocate_raw_buffer(uint8_t command,
+                                                uint32_t data_length,
+                                                sl_wifi_buffer_t **buffer,
+                                                void **data)
+{
   sl_si91x_packet_t *packet;
   sl_status_t status = SL_STATUS_OK;
 
+  if ((buffer == NULL) || (data == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
   // Allocate a data buffer with space for the data and metadata
-  status = sl_si91x_allocate_data_buffer(&buffer,
+  status = sl_si91x_allocate_data_buffer(buffer,
                                          (void **)&packet,
                                          sizeof(sl_si91x_packet_t) + data_length,
                                          SL_WIFI_ALLOCATE_COMMAND_BUFFER_WAIT_TIME);
@@ -818,17 +842,26 @@ sl_status_t sl_si91x_driver_raw_send_command(uint8_t command,
 
   // If the packet is not allocated successfully, return an allocation failed error
   if (packet == NULL) {
+    sl_si91x_host_free_buffer(*buffer);
     return SL_STATUS_ALLOCATION_FAILED;
   }
 
-  // Clear the packet descriptor and copy the command data if available
+  // Clear the packet descriptor
   memset(packet->desc, 0, sizeof(packet->desc));
-  if (data != NULL) {
-    memcpy(packet->data, data, data_length);
-  }
   packet->length  = data_length & 0xFFF;
   packet->command = command;
 
+  // The caller writes the frame data in place, directly after the descriptor
+  *data = packet->data;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_driver_send_raw_buffer(sl_wifi_buffer_t *buffer)
+{
+  if (buffer == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
   //! Enter Critical Section
   __disable_irq();
 
@@ -855,15 +888,21 @@ static void sl_si91x_atomic_packet_id_allocator(void *user_data)
   // Increment the packet ID tracker, ensuring it wraps around at 16 bits
   *packet_id_tracker = (*packet_id_tracker + 1) & 0xFFFF;
 
+  // Traced while the queue is held, so the bus thread cannot record a later stage of the command first
+  if (context->command != 0) {
+    SLI_SI91X_COMMAND_TRACE(context->packet->command_type,
+                            context->packet_id,
+                            context->command,
+                            SL_SI91X_COMMAND_STAGE_ENQUEUED);
+  }
+
   return;
 }
 
-sl_status_t sl_si91x_driver_send_socket_data(const sl_si91x_socket_send_request_t *request,
-                                             const void *data,
-                                             uint32_t wait_time)
+sl_status_t sl_si91x_driver_allocate_socket_data_buffer(const sl_si91x_socket_send_request_t *request,
+                                                        sl_wifi_buffer_t **buffer,
+                                                        void **payload)
 {
-  UNUSED_PARAMETER(wait_time);
-  sl_wifi_buffer_t *buffer;
   sl_si91x_packet_t *packet;
   sl_si91x_socket_send_request_t *send;
 
@@ -871,29 +910,22 @@ sl_status_t sl_si91x_driver_send_socket_data(const sl_si91x_socket_send_request_
   uint16_t header_length = (request->data_offset - sizeof(sl_si91x_socket_send_request_t));
   uint32_t data_length   = request->length;
 
-  if (data == NULL) {
+  if ((buffer == NULL) || (payload == NULL)) {
     return SL_STATUS_NULL_POINTER;
   }
 
-#ifndef SLI_SI91X_MCU_INTERFACE
-  // lock before buffer allocation for DATA TX
-  if (osSemaphoreAcquire(cmd_lock, 1000) != osOK) {
-    BREAKPOINT();
-  }
-#endif
-
   // Allocate a buffer for the socket data with appropriate size
   status = sl_si91x_host_allocate_buffer(
-    &buffer,
+    buffer,
     SL_WIFI_TX_FRAME_BUFFER,
     sizeof(sl_si91x_packet_t) + sizeof(sl_si91x_socket_send_request_t) + header_length + data_length,
     SL_WIFI_ALLOCATE_COMMAND_BUFFER_WAIT_TIME);
-
   VERIFY_STATUS_AND_RETURN(status);
-  packet = sl_si91x_host_get_buffer_data(buffer, 0, NULL);
+  packet = sl_si91x_host_get_buffer_data(*buffer, 0, NULL);
 
   // If the packet is not allocated successfully, return an allocation failed error
   if (packet == NULL) {
+    sl_si91x_driver_free_socket_data_buffer(*buffer);
     return SL_STATUS_WIFI_BUFFER_ALLOC_FAIL;
   }
 
@@ -901,14 +933,98 @@ sl_status_t sl_si91x_driver_send_socket_data(const sl_si91x_socket_send_request_
 
   send = (sl_si91x_socket_send_request_t *)packet->data;
   memcpy(send, request, sizeof(sl_si91x_socket_send_request_t));
-  memcpy((send->send_buffer + header_length), data, data_length);
 
   // Fill frame type
   packet->length = (sizeof(sl_si91x_socket_send_request_t) + header_length + data_length) & 0xFFF;
 
+  // The caller writes the payload in place, directly after the request header
+  *payload = (send->send_buffer + header_length);
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_driver_send_socket_data_buffer(sl_wifi_buffer_t *buffer, uint32_t wait_time)
+{
+  if (buffer == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+#ifndef SLI_SI91X_MCU_INTERFACE
+  // Take a data TX token only around the handoff, the bus thread returns it once the frame is written
+  if (osSemaphoreAcquire(cmd_lock, 1000) != osOK) {
+    BREAKPOINT();
+  }
+#endif
+
+  // Ownership of the buffer passes to the bus thread, which frees it once the frame is written
   return sl_si91x_driver_send_data_packet(SI91X_SOCKET_DATA_QUEUE, buffer, wait_time);
 }
 
+void sl_si91x_driver_free_socket_data_buffer(sl_wifi_buffer_t *buffer)
+{
+  if (buffer == NULL) {
+    return;
+  }
+
+  sl_si91x_host_free_buffer(buffer);
+}
+
+sl_status_t sl_si91x_driver_send_socket_data(const sl_si91x_socket_send_request_t *request,
+                                             const void *data,
+                                             uint32_t wait_time)
+{
+  sl_wifi_buffer_t *buffer = NULL;
+  void *payload            = NULL;
+  sl_status_t status       = SL_STATUS_OK;
+
+  if (data == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  status = sl_si91x_driver_allocate_socket_data_buffer(request, &buffer, &payload);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  memcpy(payload, data, request->length);
+
+  return sl_si91x_driver_send_socket_data_buffer(buffer, wait_time);
+}
+
+sl_status_t sl_si91x_driver_send_socket_data_vector(const sl_si91x_socket_send_request_t *request,
+                                                    const sl_si91x_data_segment_t *segments,
+                                                    uint32_t segment_count,
+                                                    uint32_t wait_time)
+{
+  sl_wifi_buffer_t *buffer = NULL;
+  uint8_t *payload         = NULL;
+  uint32_t total_length    = 0;
+  sl_status_t status       = SL_STATUS_OK;
+
+  if ((segments == NULL) && (segment_count != 0)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  for (uint32_t index = 0; index < segment_count; index++) {
+    if ((segments[index].data == NULL) && (segments[index].length != 0)) {
+      return SL_STATUS_NULL_POINTER;
+    }
+    total_length += segments[index].length;
+  }
+  if (total_length != request->length) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  status = sl_si91x_driver_allocate_socket_data_buffer(request, &buffer, (void **)&payload);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  // Gather every segment straight into the TX frame instead of staging it in an intermediate buffer
+  for (uint32_t index = 0; index < segment_count; index++) {
+    memcpy(payload, segments[index].data, segments[index].length);
+    payload += segments[index].length;
+  }
+
+  return sl_si91x_driver_send_socket_data_buffer(buffer, wait_time);
+}
+
 sl_status_t sl_si91x_custom_driver_send_command(uint32_t command,
                                                 sl_si91x_queue_type_t queue_type,
                                                 const void *data,
@@ -957,7 +1073,7 @@ sl_status_t sl_si91x_driver_send_command(uint32_t command,
                                          sl_wifi_buffer_t **data_buffer)
 {
   sl_wifi_buffer_t *buffer;
-  sl_si91x_packet_t *packet;
+  void *request;
   sl_status_t status;
 
   // Check if the queue type is within valid range
@@ -965,22 +1081,65 @@ sl_status_t sl_si91x_driver_send_command(uint32_t command,
     return SL_STATUS_INVALID_INDEX;
   }
 
+  status = sl_si91x_driver_allocate_command_buffer(command, data_length, &buffer, &request);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  // Copy the command data if available
+  if (data != NULL) {
+    memcpy(request, data, data_length);
+  }
+
+  return sl_si91x_driver_send_command_packet(command, queue_type, buffer, wait_period, sdk_context, data_buffer);
+}
+
+sl_status_t sl_si91x_driver_allocate_command_buffer(uint32_t command,
+                                                    uint32_t data_length,
+                                                    sl_wifi_buffer_t **buffer,
+                                                    void **data)
+{
+  sl_si91x_packet_t *packet;
+  sl_status_t status;
+
+  if ((buffer == NULL) || (data == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
   // Allocate a buffer for the command with appropriate size
-  status = sl_si91x_allocate_command_buffer(&buffer,
+  status = sl_si91x_allocate_command_buffer(buffer,
                                             (void **)&packet,
                                             sizeof(sl_si91x_packet_t) + data_length,
                                             SL_WIFI_ALLOCATE_COMMAND_BUFFER_WAIT_TIME);
   VERIFY_STATUS_AND_RETURN(status);
 
-  // Clear the packet descriptor and copy the command data if available
+  // Clear the packet descriptor
   memset(packet->desc, 0, sizeof(packet->desc));
-  if (data != NULL) {
-    memcpy(packet->data, data, data_length);
-  }
 
   // Fill frame type
   packet->length  = data_length & 0xFFF;
   packet->command = (uint16_t)command;
+
+  // The caller writes the command request in place, directly after the descriptor
+  *data = packet->data;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_driver_send_command_buffer(uint32_t command,
+                                                sl_si91x_queue_type_t queue_type,
+                                                sl_wifi_buffer_t *buffer,
+                                                sl_si91x_wait_period_t wait_period,
+                                                void *sdk_context,
+                                                sl_wifi_buffer_t **data_buffer)
+{
+  if (buffer == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  // Check if the queue type is within valid range
+  if (queue_type >= (sl_si91x_queue_type_t)SI91X_CMD_MAX) {
+    sl_si91x_host_free_buffer(buffer);
+    return SL_STATUS_INVALID_INDEX;
+  }
+
   return sl_si91x_driver_send_command_packet(command, queue_type, buffer, wait_period, sdk_context, data_buffer);
 }
 
@@ -1113,6 +1272,23 @@ sl_status_t sl_si91x_driver_wait_for_response_packet(sl_si91x_queue_type_t queue
   uint32_t events = 0;
   uint32_t start  = 0;
 
+  // Set the packet ID to match for identification
+  context.packet_id = packet_id;
+
+  // Prefer a completion slot, so the bus thread wakes only this thread and no queue scan is needed
+  if (SL_STATUS_OK == sli_si91x_response_slot_arm(queue_type, packet_id)) {
+    // The response may already have been queued before the slot was armed
+    status =
+      sl_si91x_host_remove_node_from_queue(queue_type, packet_buffer, &context, si91x_packet_identification_function);
+    if (SL_STATUS_OK == status) {
+      sli_si91x_response_slot_disarm(queue_type, packet_id);
+    } else {
+      status = sli_si91x_response_slot_wait(queue_type, packet_id, wait_period, packet_buffer);
+    }
+    sli_si91x_clear_events_if_queue_empty(queue_type, event_mask);
+    return status;
+  }
+
   start = osKernelGetTickCount();
   while (true) {
     // Wait for specific events in the event mask with a timeout
@@ -1124,22 +1300,21 @@ sl_status_t sl_si91x_driver_wait_for_response_packet(sl_si91x_queue_type_t queue
       return SL_STATUS_TIMEOUT;
     }
 
-    // Set the packet ID to match for identification
-    context.packet_id = packet_id;
-
     // Attempt to remove a packet from the specified queue that matches the packet ID
     status =
       sl_si91x_host_remove_node_from_queue(queue_type, packet_buffer, &context, si91x_packet_identification_function);
 
     // If a matching packet is found, return success
     if (SL_STATUS_OK == status) {
-      if (0 == cmd_queues[queue_type].queued_packet_count) {
-        si91x_host_clear_events(event_mask);
-      }
+      sli_si91x_clear_events_if_queue_empty(queue_type, event_mask);
       return SL_STATUS_OK;
     }
     SL_DEBUG_LOG(ERROR_TAG, status);
 
+    // The event is left set while other threads' responses are queued; clear it once they are consumed so
+    // that this thread blocks instead of spinning
+    sli_si91x_clear_events_if_queue_empty(queue_type, event_mask);
+
     // Calculate the elapsed time if we are not waiting for ever and update the wait_period accordingly.
     if (osWaitForever != (uint32_t)wait_period) {
       uint32_t elapsed_time = sl_si91x_host_elapsed_time(start);
@@ -1154,22 +1329,20 @@ sl_status_t sl_si91x_driver_wait_for_response_packet(sl_si91x_queue_type_t queue
 
   return SL_STATUS_INVALID_STATE;
 }
-sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
-                                                sl_si91x_queue_type_t queue_type,
-                                                sl_wifi_buffer_t *buffer,
-                                                sl_si91x_wait_period_t wait_period,
-                                                void *sdk_context,
-                                                sl_wifi_buffer_t **data_buffer)
+// Adds a command packet to its TX queue and returns the packet ID its response is matched with
+static sl_status_t sli_si91x_driver_queue_command_packet(uint32_t command,
+                                                         sl_si91x_queue_type_t queue_type,
+                                                         sl_wifi_buffer_t *buffer,
+                                                         sl_si91x_wait_period_t wait_period,
+                                                         void *sdk_context,
+                                                         bool response_packet,
+                                                         uint16_t *packet_id)
 {
-  uint16_t firmware_status;
   sli_si91x_queue_packet_t *node = NULL;
   sl_status_t status;
   sl_wifi_buffer_t *packet;
-  sl_wifi_buffer_t *response;
   uint8_t flags                     = 0;
-  uint16_t data_length              = 0;
   sl_si91x_driver_context_t context = { 0 };
-  sl_si91x_wait_period_t wait_time  = 0;
 #ifdef SLI_SI91X_SOCKETS
   const sl_si91x_socket_context_t *socket_context_t = sdk_context;
 #endif
@@ -1199,7 +1372,7 @@ sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
     // If not an immediate return, set the SI91X_PACKET_RESPONSE_STATUS flag
     flags |= SI91X_PACKET_RESPONSE_STATUS;
     // Additionally, set the SI91X_PACKET_RESPONSE_PACKET flag if the SL_SI91X_WAIT_FOR_RESPONSE_BIT is set in wait_period
-    if (data_buffer != NULL) {
+    if (response_packet) {
       flags |= (((wait_period & SL_SI91X_WAIT_FOR_RESPONSE_BIT) != 0) ? SI91X_PACKET_RESPONSE_PACKET : 0);
     }
   }
@@ -1237,6 +1410,7 @@ sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
   // Configure the context for packet handling
   context.packet  = node;
   context.payload = &(queue_packet_id[queue_type]);
+  context.command = (uint16_t)command;
 
   //! Enter Critical Section
   __disable_irq();
@@ -1258,10 +1432,22 @@ sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
   //! Exit Critical Section
   __enable_irq();
 
-  // Check if the command should return immediately or wait for a response
-  if (wait_period == SL_SI91X_RETURN_IMMEDIATELY) {
-    return SL_STATUS_IN_PROGRESS;
-  }
+  *packet_id = context.packet_id;
+  return SL_STATUS_OK;
+}
+
+// Waits for the response of a command packet queued by sli_si91x_driver_queue_command_packet()
+static sl_status_t sli_si91x_driver_complete_command_packet(sl_si91x_queue_type_t queue_type,
+                                                            uint16_t packet_id,
+                                                            sl_si91x_wait_period_t wait_period,
+                                                            sl_wifi_buffer_t **data_buffer)
+{
+  uint16_t firmware_status;
+  sli_si91x_queue_packet_t *node = NULL;
+  sl_status_t status;
+  sl_wifi_buffer_t *response;
+  uint16_t data_length             = 0;
+  sl_si91x_wait_period_t wait_time = 0;
 
   // Calculate the wait time based on wait_period
   if ((wait_period & ~SL_SI91X_WAIT_FOR_RESPONSE_BIT) == SL_SI91X_WAIT_FOR_EVER) {
@@ -1273,10 +1459,11 @@ sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
   // Wait for a response packet and handle it
   status = sl_si91x_driver_wait_for_response_packet((queue_type + SI91X_CMD_MAX),
                                                     response_event_map[queue_type],
-                                                    context.packet_id,
+                                                    packet_id,
                                                     wait_time,
                                                     &response);
   VERIFY_STATUS_AND_RETURN(status);
+  SLI_SI91X_COMMAND_TRACE(queue_type, packet_id, 0, SL_SI91X_COMMAND_STAGE_WOKEN);
 
   // Process the response packet and return the firmware status
   node            = (sli_si91x_queue_packet_t *)sl_si91x_host_get_buffer_data(response, 0, &data_length);
@@ -1296,6 +1483,65 @@ sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
   return convert_and_save_firmware_status(firmware_status);
 }
 
+sl_status_t sl_si91x_driver_send_command_packet(uint32_t command,
+                                                sl_si91x_queue_type_t queue_type,
+                                                sl_wifi_buffer_t *buffer,
+                                                sl_si91x_wait_period_t wait_period,
+                                                void *sdk_context,
+                                                sl_wifi_buffer_t **data_buffer)
+{
+  uint16_t packet_id = 0;
+  sl_status_t status = sli_si91x_driver_queue_command_packet(command,
+                                                             queue_type,
+                                                             buffer,
+                                                             wait_period,
+                                                             sdk_context,
+                                                             (data_buffer != NULL),
+                                                             &packet_id);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  // Check if the command should return immediately or wait for a response
+  if (wait_period == SL_SI91X_RETURN_IMMEDIATELY) {
+    return SL_STATUS_IN_PROGRESS;
+  }
+
+  return sli_si91x_driver_complete_command_packet(queue_type, packet_id, wait_period, data_buffer);
+}
+
+sl_status_t sl_si91x_driver_queue_command_buffer(uint32_t command,
+                                                 sl_si91x_queue_type_t queue_type,
+                                                 sl_wifi_buffer_t *buffer,
+                                                 sl_si91x_wait_period_t wait_period,
+                                                 uint16_t *packet_id)
+{
+  if ((buffer == NULL) || (packet_id == NULL)) {
+    if (buffer != NULL) {
+      sl_si91x_host_free_buffer(buffer);
+    }
+    return SL_STATUS_NULL_POINTER;
+  }
+
+  // Check if the queue type is within valid range, and that the response is waited for
+  if ((queue_type >= (sl_si91x_queue_type_t)SI91X_CMD_MAX) || (wait_period == SL_SI91X_RETURN_IMMEDIATELY)) {
+    sl_si91x_host_free_buffer(buffer);
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  return sli_si91x_driver_queue_command_packet(command, queue_type, buffer, wait_period, NULL, true, packet_id);
+}
+
+sl_status_t sl_si91x_driver_wait_for_command_buffer(sl_si91x_queue_type_t queue_type,
+                                                    uint16_t packet_id,
+                                                    sl_si91x_wait_period_t wait_period,
+                                                    sl_wifi_buffer_t **data_buffer)
+{
+  if (queue_type >= (sl_si91x_queue_type_t)SI91X_CMD_MAX) {
+    return SL_STATUS_INVALID_INDEX;
+  }
+
+  return sli_si91x_driver_complete_command_packet(queue_type, packet_id, wait_period, data_buffer);
+}
+
 sl_status_t sl_si91x_driver_send_data_packet(sl_si91x_queue_type_t queue_type,
                                              sl_wifi_buffer_t *buffer,
                                              uint32_t wait_time)
@@ -2744,4 +2990,4 @@ sl_status_t sl_si91x_set_nwp_config_request(sl_si91x_nwp_configuration_t nwp_con
     return SL_STATUS_NOT_SUPPORTED;
 
   return status;
-}
\ No newline at end of file
+}
@@ -0,0 +1,279 @@
+/***************************************************************************/ /**
+ * @file
+ * @brief Host-side stress test and benchmark of the Si91x lock-free queue
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+// Runs on the host, not on target. Build it with ThreadSanitizer from this directory, as a single command:
+//
+//   cc -std=gnu11 -O1 -g -fsanitize=thread -pthread -I../inc -I../../../../stm32/silabs_utility/common/inc
+//      sli_si91x_lock_free_queue_test.c -o lock_free_queue_test
+//
+// "./lock_free_queue_test" runs the stress test: several producers push numbered nodes while one consumer pops them,
+// and the consumer checks that every node arrives exactly once and in order per producer. The consumer pops without
+// waiting, as the driver does, so it also runs into nodes whose producer has claimed the tail but not linked it yet.
+// "./lock_free_queue_test bench" reports ns/op of the lock-free queue next to a mutex-protected list; build it
+// without -fsanitize=thread and with -O2 for meaningful numbers.
+
+#include "sli_si91x_lock_free_queue.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_PRODUCERS          4
+#define TEST_NODES_PER_PRODUCER 200000
+
+typedef struct {
+  sl_slist_node_t node; // First member, as in sl_wifi_buffer_t
+  uint32_t producer;
+  uint32_t sequence;
+} test_node_t;
+
+typedef struct {
+  sli_si91x_lock_free_queue_t lock_free;
+  pthread_mutex_t mutex;
+  sl_slist_node_t *head;
+  sl_slist_node_t *tail;
+  uint32_t count;
+  bool use_mutex;
+} test_queue_t;
+
+static test_queue_t queue;
+static test_node_t *nodes;
+
+static void test_queue_init(bool use_mutex)
+{
+  memset(&queue, 0, sizeof(queue));
+  sli_si91x_lock_free_queue_init(&queue.lock_free);
+  pthread_mutex_init(&queue.mutex, NULL);
+  queue.use_mutex = use_mutex;
+}
+
+// Same order as sli_si91x_lock_free_push(): the count is only raised once the node is reachable
+static void test_queue_push(sl_slist_node_t *node)
+{
+  if (!queue.use_mutex) {
+    sli_si91x_lock_free_link(&queue.lock_free, node);
+    __atomic_add_fetch(&queue.count, 1, __ATOMIC_RELEASE);
+    return;
+  }
+
+  pthread_mutex_lock(&queue.mutex);
+  node->node = NULL;
+  if (queue.tail == NULL) {
+    queue.head = node;
+  } else {
+    queue.tail->node = node;
+  }
+  queue.tail = node;
+  queue.count++;
+  pthread_mutex_unlock(&queue.mutex);
+}
+
+static sl_slist_node_t *test_queue_pop(void)
+{
+  sl_slist_node_t *node;
+
+  if (!queue.use_mutex) {
+    node = sli_si91x_lock_free_unlink(&queue.lock_free);
+    if (node != NULL) {
+      __atomic_sub_fetch(&queue.count, 1, __ATOMIC_RELAXED);
+    }
+    return node;
+  }
+
+  pthread_mutex_lock(&queue.mutex);
+  node = queue.head;
+  if (node != NULL) {
+    queue.head = node->node;
+    if (queue.head == NULL) {
+      queue.tail = NULL;
+    }
+    queue.count--;
+  }
+  pthread_mutex_unlock(&queue.mutex);
+  return node;
+}
+
+static uint64_t test_time_ns(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void *test_producer(void *argument)
+{
+  uint32_t producer = (uint32_t)(uintptr_t)argument;
+
+  for (uint32_t i = 0; i < TEST_NODES_PER_PRODUCER; i++) {
+    test_node_t *node = &nodes[(producer * TEST_NODES_PER_PRODUCER) + i];
+    node->producer    = producer;
+    node->sequence    = i;
+    test_queue_push(&node->node);
+  }
+  return NULL;
+}
+
+// Pops every node the producers push; returns the number of errors found
+static uint32_t test_consume(uint32_t producers, uint32_t *empty_pops)
+{
+  uint32_t expected[TEST_PRODUCERS] = { 0 };
+  uint32_t remaining                = producers * TEST_NODES_PER_PRODUCER;
+  uint32_t errors                   = 0;
+
+  *empty_pops = 0;
+  while (remaining > 0) {
+    test_node_t *node = (test_node_t *)test_queue_pop();
+    if (node == NULL) {
+      // As in the driver, a node that cannot be reached yet is picked up on a later call
+      (*empty_pops)++;
+      continue;
+    }
+    if ((node->producer >= producers) || (node->sequence != expected[node->producer])) {
+      if (errors++ < 10) {
+        fprintf(stderr, "producer %u: got node %u\n", node->producer, node->sequence);
+      }
+    } else {
+      expected[node->producer]++;
+    }
+    remaining--;
+  }
+
+  if (test_queue_pop() != NULL) {
+    fprintf(stderr, "queue not empty after the last node\n");
+    errors++;
+  }
+  if (__atomic_load_n(&queue.count, __ATOMIC_ACQUIRE) != 0) {
+    fprintf(stderr, "count is %u after the last node\n", __atomic_load_n(&queue.count, __ATOMIC_ACQUIRE));
+    errors++;
+  }
+  return errors;
+}
+
+// Runs the producers against one consumer; returns the number of errors and the elapsed time
+static uint32_t test_run(bool use_mutex, uint32_t producers, uint64_t *elapsed_ns, uint32_t *empty_pops)
+{
+  pthread_t threads[TEST_PRODUCERS];
+  uint64_t start;
+  uint32_t errors;
+
+  test_queue_init(use_mutex);
+  start = test_time_ns();
+  for (uint32_t i = 0; i < producers; i++) {
+    pthread_create(&threads[i], NULL, test_producer, (void *)(uintptr_t)i);
+  }
+  errors = test_consume(producers, empty_pops);
+  for (uint32_t i = 0; i < producers; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  *elapsed_ns = test_time_ns() - start;
+  pthread_mutex_destroy(&queue.mutex);
+  return errors;
+}
+
+// Single thread push then pop, which is the cost the bus thread and one sender see without contention
+static double test_uncontended_ns_per_op(bool use_mutex)
+{
+  const uint32_t rounds = 1000;
+  uint64_t start;
+
+  test_queue_init(use_mutex);
+  start = test_time_ns();
+  for (uint32_t round = 0; round < rounds; round++) {
+    for (uint32_t i = 0; i < TEST_NODES_PER_PRODUCER / rounds; i++) {
+      test_queue_push(&nodes[i].node);
+    }
+    while (test_queue_pop() != NULL) {
+    }
+  }
+  pthread_mutex_destroy(&queue.mutex);
+  return (double)(test_time_ns() - start) / (double)(2 * (TEST_NODES_PER_PRODUCER / rounds) * rounds);
+}
+
+static int test_stress(void)
+{
+  uint32_t errors = 0;
+
+  for (uint32_t producers = 1; producers <= TEST_PRODUCERS; producers++) {
+    uint64_t elapsed_ns;
+    uint32_t empty_pops;
+    uint32_t run_errors = test_run(false, producers, &elapsed_ns, &empty_pops);
+
+    printf("%u producer(s): %u nodes, %u errors, %u empty pops\n",
+           producers,
+           producers * TEST_NODES_PER_PRODUCER,
+           run_errors,
+           empty_pops);
+    errors += run_errors;
+  }
+  printf("%s\n", (errors == 0) ? "PASS" : "FAIL");
+  return (errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int test_bench(void)
+{
+  printf("%-24s %12s %12s\n", "", "lock-free", "mutex");
+  printf("%-24s %9.1f ns %9.1f ns\n",
+         "uncontended push+pop",
+         test_uncontended_ns_per_op(false),
+         test_uncontended_ns_per_op(true));
+
+  for (uint32_t producers = 1; producers <= TEST_PRODUCERS; producers++) {
+    double ns_per_op[2];
+    uint32_t errors = 0;
+
+    for (int use_mutex = 0; use_mutex < 2; use_mutex++) {
+      uint64_t elapsed_ns;
+      uint32_t empty_pops;
+      errors += test_run(use_mutex != 0, producers, &elapsed_ns, &empty_pops);
+      ns_per_op[use_mutex] = (double)elapsed_ns / (double)(producers * TEST_NODES_PER_PRODUCER);
+    }
+    printf("%u producer(s), per node %9.1f ns %9.1f ns%s\n",
+           producers,
+           ns_per_op[0],
+           ns_per_op[1],
+           (errors == 0) ? "" : " (errors)");
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+  int result;
+
+  nodes = calloc(TEST_PRODUCERS * TEST_NODES_PER_PRODUCER, sizeof(test_node_t));
+  if (nodes == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  result = ((argc > 1) && (strcmp(argv[1], "bench") == 0)) ? test_bench() : test_stress();
+  free(nodes);
+  return result;
+}
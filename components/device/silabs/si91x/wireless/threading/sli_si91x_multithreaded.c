@@ -36,7 +36,9 @@
 #include "sl_rsi_utility.h"
 #include "cmsis_os2.h"
 #include "cmsis_compiler.h"
+#include "em_core.h"
 #include "sl_si91x_core_utilities.h"
+#include "sl_si91x_command_latency.h"
 #include <string.h>
 #ifdef SLI_SI91X_OFFLOAD_NETWORK_STACK
 #include "sl_net_si91x_integration_handler.h"
@@ -91,6 +93,40 @@ extern sl_wifi_event_handler_t si91x_event_handler;
 
 extern si91x_packet_queue_t cmd_queues[SI91X_QUEUE_MAX];
 
+// Socket data burst statistics, only written by the bus thread
+static sl_si91x_tx_batch_statistics_t tx_batch_statistics;
+
+// Received frames kept by socket receive rings, see SL_SI91X_MAX_HELD_RX_FRAMES
+static volatile uint32_t rx_frames_held;
+// Set when the socket data queue counted a frame that its sender, preempted mid-enqueue, had not linked yet. The data
+// queue is then left alone until the sender signals the frame with the TX pending event, rather than polled.
+static bool socket_data_unlinked;
+
+// Scheduling state of a TX queue, owned by the bus thread except for the schedule itself
+typedef struct {
+  sl_si91x_tx_queue_schedule_t schedule;
+  int32_t deficit;      // Bytes the queue may still write in the current round
+  bool ready;           // The queue had a frame the bus thread could write when it last looked
+  uint32_t ready_since; // Tick count at which the queue became ready
+  sl_si91x_tx_queue_statistics_t statistics;
+} sli_si91x_tx_queue_state_t;
+
+#define SLI_SI91X_TX_COMMAND_SCHEDULE \
+  { .priority = SL_SI91X_TX_SCHEDULER_COMMAND_PRIORITY, .quantum = SL_SI91X_TX_SCHEDULER_DEFAULT_QUANTUM }
+
+static sli_si91x_tx_queue_state_t tx_queue_state[SI91X_CMD_MAX] = {
+  [SI91X_COMMON_CMD]  = { .schedule = SLI_SI91X_TX_COMMAND_SCHEDULE },
+  [SI91X_WLAN_CMD]    = { .schedule = SLI_SI91X_TX_COMMAND_SCHEDULE },
+  [SI91X_NETWORK_CMD] = { .schedule = SLI_SI91X_TX_COMMAND_SCHEDULE },
+  [SI91X_SOCKET_CMD]  = { .schedule = SLI_SI91X_TX_COMMAND_SCHEDULE },
+  [SI91X_BT_CMD]      = { .schedule = SLI_SI91X_TX_COMMAND_SCHEDULE },
+  [SI91X_SOCKET_DATA] = { .schedule = { .priority = SL_SI91X_TX_SCHEDULER_DATA_PRIORITY,
+                                        .quantum  = SL_SI91X_TX_SCHEDULER_DEFAULT_QUANTUM } }
+};
+
+// Queue the deficit round robin continues from
+static uint8_t tx_scheduler_cursor;
+
 #ifndef SLI_SI91X_MCU_INTERFACE
 // Declaration of a semaphore handle used for command locking
 extern osSemaphoreId_t cmd_lock;
@@ -122,11 +158,18 @@ extern void sli_si91x_config_m4_dma_desc_on_reset(void);
 static sl_status_t bus_write_frame(sl_si91x_queue_type_t queue_type,
                                    sl_wifi_buffer_type_t buffer_type,
                                    sl_si91x_command_trace_t *trace,
-                                   bool *global_queue_block);
+                                   bool *global_queue_block,
+                                   uint16_t *frame_length);
 
 static sl_status_t bus_write_data_frame(sl_si91x_queue_type_t queue_type,
                                         sl_wifi_buffer_type_t buffer_type,
-                                        bool *global_queue_block);
+                                        bool *global_queue_block,
+                                        uint16_t *frame_length);
+
+static sl_status_t bus_write_data_burst(bool *global_queue_block, uint32_t *burst_length);
+
+static uint8_t sli_si91x_tx_scheduler_select(const sl_si91x_command_trace_t *command_trace);
+static void sli_si91x_tx_scheduler_charge(uint8_t queue, uint32_t length);
 
 sl_status_t si91x_req_wakeup(void);
 
@@ -324,8 +367,10 @@ void si91x_event_handler_thread(const void *args)
 
           SL_NET_EVENT_DISPATCH_HANDLER(data, packet);
 
-          // Free the resources associated with the packet
-          sl_si91x_host_free_buffer(data->host_packet);
+          // Free the resources associated with the packet, unless a socket receive ring kept the frame
+          if (data->host_packet != NULL) {
+            sl_si91x_host_free_buffer(data->host_packet);
+          }
           sl_si91x_host_free_buffer(buffer);
         } else {
           // TODO: error handling
@@ -349,6 +394,9 @@ void si91x_bus_thread(const void *args)
   sl_wifi_buffer_t *temp_buffer  = NULL;
   sl_wifi_buffer_t *buffer;
   uint8_t tx_queues_empty = 0;
+  uint8_t tx_queue        = 0;
+  uint32_t tx_length      = 0;
+  uint16_t frame_length   = 0;
   uint32_t event          = 0;
   uint8_t *data;
   uint16_t length;
@@ -366,7 +414,14 @@ void si91x_bus_thread(const void *args)
   };
 
   while (1) {
-    tx_queues_empty = ((cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_DATA].queued_packet_count)
+    // Check for an already set event
+    event |= si91x_host_wait_for_bus_event(BUS_THREAD_EVENTS, 0);
+    if (event & SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT) {
+      socket_data_unlinked = false;
+    }
+
+    tx_queues_empty = ((cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_DATA].queued_packet_count
+                        && (false == socket_data_unlinked))
                        || (cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_CMD].queued_packet_count
                            && (false == command_trace[SI91X_SOCKET_CMD].command_in_flight))
                        || (cmd_queues[(sl_si91x_queue_type_t)SI91X_WLAN_CMD].queued_packet_count
@@ -378,10 +433,10 @@ void si91x_bus_thread(const void *args)
                        || (cmd_queues[(sl_si91x_queue_type_t)SI91X_NETWORK_CMD].queued_packet_count
                            && (false == command_trace[SI91X_NETWORK_CMD].command_in_flight)));
 
-    // Check for an already set event
-    event |= si91x_host_wait_for_bus_event(BUS_THREAD_EVENTS, 0);
-    // If there are no TX packets to be processed and no RX packets pending, then waitforever
-    if ((tx_queues_empty == 0) && !(event & SL_SI91X_NCP_HOST_BUS_RX_EVENT)) {
+    // If there are no TX packets to be processed and no RX packets pending, then waitforever. Pending RX packets do
+    // not count while reading is paused for held frames; releasing one sets the bus RX event again.
+    if ((tx_queues_empty == 0)
+        && (!(event & SL_SI91X_NCP_HOST_BUS_RX_EVENT) || (rx_frames_held >= SL_SI91X_MAX_HELD_RX_FRAMES))) {
       // Wait for an event related to data TX or RX on the bus with an infinite timeout.
       event |= si91x_host_wait_for_bus_event(BUS_THREAD_EVENTS, osWaitForever);
     }
@@ -409,12 +464,13 @@ void si91x_bus_thread(const void *args)
     }
 #endif
 
-    // Check if there is an RX packet pending or bus RX event is set
+    // Check if there is an RX packet pending or bus RX event is set, unless too many received frames are held
     if ((event & SL_SI91X_NCP_HOST_BUS_RX_EVENT
 #ifndef SLI_SI91X_MCU_INTERFACE
          && (interrupt_status & RSI_RX_PKT_PENDING)
 #endif
            )
+        && (rx_frames_held < SL_SI91X_MAX_HELD_RX_FRAMES)
         && (sl_si91x_bus_read_frame(&buffer) == SL_STATUS_OK)) { // Allocation from RX buffer type!
 
       // Check if the rx queue is empty
@@ -1250,7 +1306,10 @@ void si91x_bus_thread(const void *args)
                 (sl_si91x_packet_t *)sl_si91x_host_get_buffer_data(node->host_packet, 0, NULL);
               SL_NET_EVENT_DISPATCH_HANDLER(node, raw_packet);
 
-              sl_si91x_host_free_buffer(node->host_packet);
+              // A socket receive ring takes the frame, and clears host_packet, when its reader is behind
+              if (node->host_packet != NULL) {
+                sl_si91x_host_free_buffer(node->host_packet);
+              }
               sl_si91x_host_free_buffer(packet);
             }
 
@@ -1261,9 +1320,11 @@ void si91x_bus_thread(const void *args)
             }
 
 #else
-            // If SLI_SI91X_OFFLOAD_NETWORK_STACK is not defined, process the data frame and free the buffer.
-            sl_si91x_host_process_data_frame(SL_WIFI_CLIENT_INTERFACE, buffer);
-            sl_si91x_host_free_buffer(buffer);
+            // If SLI_SI91X_OFFLOAD_NETWORK_STACK is not defined, process the data frame and free the buffer,
+            // unless the network stack keeps it to receive the frame without copying.
+            if (sl_si91x_host_process_data_frame(SL_WIFI_CLIENT_INTERFACE, buffer) != SL_STATUS_IN_PROGRESS) {
+              sl_si91x_host_free_buffer(buffer);
+            }
 #endif
           } else if (frame_type == SL_SI91X_WIFI_RX_DOT11_DATA) {
             ++command_trace[SI91X_WLAN_CMD].rx_counter;
@@ -1310,48 +1371,45 @@ void si91x_bus_thread(const void *args)
       sli_submit_rx_buffer();
     }
 
-    if (event & SL_SI91X_ALL_TX_PENDING_COMMAND_EVENTS) {
-      // This condition is checked before writing frames to the bus
-      for (int i = 0; i < SI91X_SOCKET_DATA; i++) {
-        // Check if the current command queue is empty
-        if ((cmd_queues[(sl_si91x_queue_type_t)i].queued_packet_count)
-            && (command_trace[i].command_in_flight != true)) {
-          // Read the interrupt status
-          sl_si91x_bus_read_interrupt_status(&interrupt_status);
-          if (0 == (interrupt_status & RSI_BUFFER_FULL)) {
-            // Check if there are more packets in the queue
-            // No more packets, clear the SL_SI91X_ALL_TX_PENDING_COMMAND_EVENTS for the processed queue
-            if ((bus_write_frame(i, SL_WIFI_CONTROL_BUFFER, &(command_trace[i]), &global_queue_block) == SL_STATUS_OK)
-                && (0 == cmd_queues[(sl_si91x_queue_type_t)i].queued_packet_count)) {
-              event &= ~SL_SI91X_TX_PENDING_FLAG(i);
-            }
-          } else {
-            break;
-          }
-        } else {
-          // Check if the current command queue is empty
-          if (0 == cmd_queues[(sl_si91x_queue_type_t)i].queued_packet_count) {
-            // No more packets, clear the SL_SI91X_ALL_TX_PENDING_COMMAND_EVENTS for the processed queue
-            event &= ~SL_SI91X_TX_PENDING_FLAG(i);
-          }
+    if (event & (SL_SI91X_ALL_TX_PENDING_COMMAND_EVENTS | SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT)) {
+      // No more packets, clear the TX pending event of every empty queue
+      for (int i = 0; i < SI91X_CMD_MAX; i++) {
+        if (0 == cmd_queues[(sl_si91x_queue_type_t)i].queued_packet_count) {
+          event &= ~SL_SI91X_TX_PENDING_FLAG(i);
         }
       }
-    }
 
-    if (event & SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT) {
-      if (cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_DATA].queued_packet_count) {
+      // Write one frame, or one socket data burst, from the queue the scheduler picks
+      tx_queue = (global_queue_block == true) ? SI91X_CMD_MAX : sli_si91x_tx_scheduler_select(command_trace);
+      if (tx_queue < SI91X_CMD_MAX) {
         // Read the interrupt status
         sl_si91x_bus_read_interrupt_status(&interrupt_status);
-        if (0 == (interrupt_status & RSI_BUFFER_FULL)) {
-          if (bus_write_data_frame(SI91X_SOCKET_DATA_QUEUE, SL_WIFI_TX_FRAME_BUFFER, &global_queue_block)
-              != SL_STATUS_OK) {
+        if (interrupt_status & RSI_BUFFER_FULL) {
+          continue;
+        }
+
+        if (tx_queue == SI91X_SOCKET_DATA) {
+          status = bus_write_data_burst(&global_queue_block, &tx_length);
+          if (status == SL_STATUS_EMPTY) {
+            // Any TX pending event seen so far is stale; wait for the one the preempted sender sets
+            socket_data_unlinked = true;
+            event &= ~SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT;
+          }
+          if (status != SL_STATUS_OK) {
             continue;
           }
         } else {
-          continue;
+          if (bus_write_frame(tx_queue,
+                              SL_WIFI_CONTROL_BUFFER,
+                              &(command_trace[tx_queue]),
+                              &global_queue_block,
+                              &frame_length)
+              != SL_STATUS_OK) {
+            continue;
+          }
+          tx_length = frame_length;
         }
-      } else {
-        event &= ~SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT;
+        sli_si91x_tx_scheduler_charge(tx_queue, tx_length);
       }
     }
   }
@@ -1362,7 +1420,8 @@ void si91x_bus_thread(const void *args)
 static sl_status_t bus_write_frame(sl_si91x_queue_type_t queue_type,
                                    sl_wifi_buffer_type_t buffer_type,
                                    sl_si91x_command_trace_t *trace,
-                                   bool *global_queue_block)
+                                   bool *global_queue_block,
+                                   uint16_t *frame_length)
 {
   UNUSED_PARAMETER(buffer_type);
   sl_status_t status;
@@ -1424,6 +1483,7 @@ static sl_status_t bus_write_frame(sl_si91x_queue_type_t queue_type,
 #endif
   // Write the frame to the bus using packet data and length
   status = sl_si91x_bus_write_frame(packet, packet->data, length);
+  SLI_SI91X_COMMAND_TRACE(queue_type, node->packet_id, packet->command, SL_SI91X_COMMAND_STAGE_WRITTEN);
 
 #ifdef SLI_SI91X_MCU_INTERFACE
   if (packet->desc[2] == RSI_COMMON_REQ_SOFT_RESET) {
@@ -1456,12 +1516,14 @@ static sl_status_t bus_write_frame(sl_si91x_queue_type_t queue_type,
   sl_si91x_host_free_buffer(buffer);
 
   trace->tx_counter++;
+  *frame_length = length;
   return SL_STATUS_OK;
 }
 
 static sl_status_t bus_write_data_frame(sl_si91x_queue_type_t queue_type, // This function is called for writing data
                                         sl_wifi_buffer_type_t buffer_type,
-                                        bool *global_queue_block)
+                                        bool *global_queue_block,
+                                        uint16_t *frame_length)
 {
   UNUSED_PARAMETER(buffer_type);
   sl_status_t status;
@@ -1500,10 +1562,244 @@ static sl_status_t bus_write_data_frame(sl_si91x_queue_type_t queue_type, // Thi
   }
 
 #ifndef SLI_SI91X_MCU_INTERFACE
-  // If WLAN data queue is involved, release semaphore
+  // Return the data TX token taken by the sender
   osSemaphoreRelease(cmd_lock);
 #endif
 
+  *frame_length = length;
   sl_si91x_host_free_buffer(buffer);
   return SL_STATUS_OK;
 }
+
+// Writes queued socket data frames back to back, one bus transfer per frame, bounded by SL_SI91X_TX_BATCH_MAX_FRAMES
+// and SL_SI91X_TX_BATCH_MAX_BYTES so that RX and the command queues are still serviced between bursts. When the data
+// queue runs empty, it waits up to SL_SI91X_TX_BATCH_LINGER_TICKS for the next frame before ending the burst.
+// The caller has already checked that the firmware can accept the first frame.
+static sl_status_t bus_write_data_burst(bool *global_queue_block, uint32_t *burst_length)
+{
+  sl_status_t status        = SL_STATUS_OK;
+  uint16_t interrupt_status = 0;
+  uint32_t frames           = 0;
+  uint32_t bytes            = 0;
+  uint16_t length           = 0;
+
+  do {
+    if (frames != 0) {
+      sl_si91x_bus_read_interrupt_status(&interrupt_status);
+      if (interrupt_status & RSI_BUFFER_FULL) {
+        break;
+      }
+    }
+
+    status = bus_write_data_frame(SI91X_SOCKET_DATA_QUEUE, SL_WIFI_TX_FRAME_BUFFER, global_queue_block, &length);
+    if (status != SL_STATUS_OK) {
+      break;
+    }
+    frames++;
+    bytes += length;
+
+#if (SL_SI91X_TX_BATCH_LINGER_TICKS > 0)
+    if ((frames < SL_SI91X_TX_BATCH_MAX_FRAMES) && (bytes < SL_SI91X_TX_BATCH_MAX_BYTES)
+        && (0 == cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_DATA].queued_packet_count)) {
+      // Let the senders, which run below the bus thread, queue the next frame
+      si91x_host_wait_for_bus_event(SL_SI91X_SOCKET_DATA_TX_PENDING_EVENT, SL_SI91X_TX_BATCH_LINGER_TICKS);
+    }
+#endif
+  } while ((frames < SL_SI91X_TX_BATCH_MAX_FRAMES) && (bytes < SL_SI91X_TX_BATCH_MAX_BYTES)
+           && (0 != cmd_queues[(sl_si91x_queue_type_t)SI91X_SOCKET_DATA].queued_packet_count));
+
+  if (frames == 0) {
+    return status;
+  }
+
+  tx_batch_statistics.bursts++;
+  tx_batch_statistics.frames += frames;
+  tx_batch_statistics.bytes += bytes;
+  uint32_t bin = (frames < SL_SI91X_TX_BATCH_HISTOGRAM_BINS) ? frames : SL_SI91X_TX_BATCH_HISTOGRAM_BINS;
+  tx_batch_statistics.frames_per_burst[bin - 1]++;
+  *burst_length = bytes;
+  return SL_STATUS_OK;
+}
+
+void sli_si91x_host_hold_rx_frame(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  rx_frames_held++;
+  CORE_EXIT_CRITICAL();
+}
+
+void sli_si91x_host_release_rx_frame(void)
+{
+  bool resume;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  resume = (rx_frames_held == SL_SI91X_MAX_HELD_RX_FRAMES);
+  rx_frames_held--;
+  CORE_EXIT_CRITICAL();
+
+  // The bus thread stopped reading frames at the limit, so have it look for pending frames again
+  if (resume) {
+    sl_si91x_host_set_bus_event(SL_SI91X_NCP_HOST_BUS_RX_EVENT);
+  }
+}
+
+void sl_si91x_host_get_tx_batch_statistics(sl_si91x_tx_batch_statistics_t *statistics)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  *statistics = tx_batch_statistics;
+  CORE_EXIT_CRITICAL();
+}
+
+void sl_si91x_host_reset_tx_batch_statistics(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  memset(&tx_batch_statistics, 0, sizeof(tx_batch_statistics));
+  CORE_EXIT_CRITICAL();
+}
+
+// Picks the TX queue the bus thread writes from next. Only ready queues of the lowest priority class compete; among
+// them, deficit round robin shares the bus in proportion to their quanta. Returns SI91X_CMD_MAX if no queue is ready.
+static uint8_t sli_si91x_tx_scheduler_select(const sl_si91x_command_trace_t *command_trace)
+{
+  uint32_t now             = osKernelGetTickCount();
+  uint8_t highest_priority = UINT8_MAX;
+  bool any_ready           = false;
+
+  for (uint8_t i = 0; i < SI91X_CMD_MAX; i++) {
+    sli_si91x_tx_queue_state_t *state = &tx_queue_state[i];
+    bool ready                        = (0 != cmd_queues[(sl_si91x_queue_type_t)i].queued_packet_count)
+                 && ((i == SI91X_SOCKET_DATA) ? !socket_data_unlinked : (command_trace[i].command_in_flight != true));
+
+    if (!ready) {
+      // An idle queue does not keep its credit
+      state->ready   = false;
+      state->deficit = 0;
+      continue;
+    }
+    if (!state->ready) {
+      state->ready       = true;
+      state->ready_since = now;
+    }
+    if (state->schedule.priority <= highest_priority) {
+      highest_priority = state->schedule.priority;
+    }
+    any_ready = true;
+  }
+
+  if (!any_ready) {
+    return SI91X_CMD_MAX;
+  }
+
+  // Stay on the current queue while it has credit, then move on; once every competing queue has used its credit,
+  // credit at once as many rounds as it takes for one of them to have credit again
+  uint32_t rounds = UINT32_MAX;
+  for (uint8_t i = 0; i < SI91X_CMD_MAX; i++) {
+    uint8_t queue                           = (uint8_t)((tx_scheduler_cursor + i) % SI91X_CMD_MAX);
+    const sli_si91x_tx_queue_state_t *state = &tx_queue_state[queue];
+    if (!state->ready || (state->schedule.priority != highest_priority)) {
+      continue;
+    }
+    if (state->deficit > 0) {
+      tx_scheduler_cursor = queue;
+      return queue;
+    }
+    uint32_t queue_rounds = ((uint32_t)(-state->deficit) / state->schedule.quantum) + 1;
+    if (queue_rounds < rounds) {
+      rounds = queue_rounds;
+    }
+  }
+
+  for (uint8_t i = 0; i < SI91X_CMD_MAX; i++) {
+    sli_si91x_tx_queue_state_t *state = &tx_queue_state[i];
+    if (state->ready && (state->schedule.priority == highest_priority)) {
+      state->deficit += (int32_t)(rounds * state->schedule.quantum);
+    }
+  }
+
+  // The first competing queue after the cursor whose credit is now positive is served
+  for (uint8_t i = 0; i < SI91X_CMD_MAX; i++) {
+    uint8_t queue                           = (uint8_t)((tx_scheduler_cursor + i) % SI91X_CMD_MAX);
+    const sli_si91x_tx_queue_state_t *state = &tx_queue_state[queue];
+    if (state->ready && (state->schedule.priority == highest_priority) && (state->deficit > 0)) {
+      tx_scheduler_cursor = queue;
+      return queue;
+    }
+  }
+
+  return SI91X_CMD_MAX;
+}
+
+// Accounts for a write from a queue picked by sli_si91x_tx_scheduler_select()
+static void sli_si91x_tx_scheduler_charge(uint8_t queue, uint32_t length)
+{
+  sli_si91x_tx_queue_state_t *state = &tx_queue_state[queue];
+  uint32_t wait_ticks               = osKernelGetTickCount() - state->ready_since;
+  uint32_t wait_ms                  = (uint32_t)(((uint64_t)wait_ticks * 1000) / osKernelGetTickFreq());
+  uint8_t bin                       = 0;
+
+  state->deficit -= (int32_t)length;
+  // The next frame of this queue waits from now on
+  state->ready = false;
+
+  // Bin 0 counts services that did not wait, bin n waits of up to 2^(n-1) ms and the last bin all longer waits
+  if (wait_ticks != 0) {
+    bin = 1;
+    while ((bin < (SL_SI91X_TX_QUEUE_WAIT_HISTOGRAM_BINS - 1)) && (wait_ms > (1UL << (bin - 1)))) {
+      bin++;
+    }
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  state->statistics.services++;
+  state->statistics.bytes += length;
+  state->statistics.wait_histogram[bin]++;
+  if (wait_ms > state->statistics.max_wait_ms) {
+    state->statistics.max_wait_ms = wait_ms;
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+sl_status_t sl_si91x_host_set_tx_queue_schedule(sl_si91x_queue_type_t queue,
+                                                const sl_si91x_tx_queue_schedule_t *schedule)
+{
+  SL_VERIFY_POINTER_OR_RETURN(schedule, SL_STATUS_NULL_POINTER);
+  if ((queue > SI91X_SOCKET_DATA_QUEUE) || (schedule->quantum == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  tx_queue_state[queue].schedule = *schedule;
+  CORE_EXIT_CRITICAL();
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_si91x_host_get_tx_queue_statistics(sl_si91x_queue_type_t queue,
+                                                  sl_si91x_tx_queue_statistics_t *statistics)
+{
+  SL_VERIFY_POINTER_OR_RETURN(statistics, SL_STATUS_NULL_POINTER);
+  if (queue > SI91X_SOCKET_DATA_QUEUE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  *statistics = tx_queue_state[queue].statistics;
+  CORE_EXIT_CRITICAL();
+  return SL_STATUS_OK;
+}
+
+void sl_si91x_host_reset_tx_queue_statistics(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  for (int i = 0; i < SI91X_CMD_MAX; i++) {
+    memset(&tx_queue_state[i].statistics, 0, sizeof(tx_queue_state[i].statistics));
+  }
+  CORE_EXIT_CRITICAL();
+}
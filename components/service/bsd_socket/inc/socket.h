@@ -129,6 +129,8 @@ typedef long off_t;
 #define	SO_CERT_INDEX				0x1026	///< Sets certificate index for SSL socket.
 #define	SO_HIGH_PERFORMANCE_SOCKET	0x1027	///< Enables high-performance socket.
 #define SO_TLS_SNI                  0x1028  ///< Passes SNI extension for SSL socket.
+#define SO_RX_RING_SIZE             0x1029  ///< Sets size of host-side receive ring buffer.
+#define SO_RX_RING_DROPPED          0x102A  ///< Gets number of bytes dropped by the host-side receive ring.
 /** @} */
 
 // From Linux include/uapi/linux/tcp.h
@@ -849,6 +851,28 @@ ssize_t	send(int socket_id, const void *buf, size_t buf_len, int flags);
  ******************************************************************************/
 ssize_t	sendto(int socket_id, const void *buf, size_t buf_len, int flags, const struct sockaddr *to_addr, socklen_t to_addr_len);
 
+/***************************************************************************/ /**
+ * @brief
+ *   Send a message gathered from multiple buffers on a socket.
+ * 
+ *   The @ref sendmsg() system call behaves like @ref sendto(), with the payload described by the msg_iov array of the message header
+ *   and the optional target address given by msg_name and msg_namelen. The buffers are copied directly into the frame sent to the
+ *   firmware, so a header and a payload held in separate buffers need not be joined by the application first.
+ * 
+ * @param[in] socket_id
+ *   Socket identification number.
+ * @param[in] message
+ *   Message header of type @ref msghdr describing the target address and the buffers to transmit.
+ * @param[in] flags
+ *   Controls the transmission of the data.
+ * @return
+ *   The number of octets sent. If an error occurred, a value of -1 is returned.
+ * @note 
+ *   Due to firmware limitations, @ref sendmsg() system call doesn't support any flags, and ancillary data is ignored.
+ *   The total length of the buffers is subject to the same limits as @ref sendto().
+ ******************************************************************************/
+ssize_t	sendmsg(int socket_id, const struct msghdr *message, int flags);
+
 /***************************************************************************/ /**
  * @brief
  *   Set options on sockets. 
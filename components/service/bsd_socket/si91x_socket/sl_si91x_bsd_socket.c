@@ -293,6 +293,16 @@ int accept(int socket_id, struct sockaddr *addr, socklen_t *addr_len)
   // Copy the local address information to the client socket
   memcpy(&si91x_client_socket->local_address, &si91x_server_socket->local_address, sizeof(struct sockaddr_in6));
 
+  // Accepted sockets inherit the host-side receive ring of the listening socket
+  if (si91x_server_socket->rx_ring_size != 0) {
+    si91x_client_socket->rx_ring_size       = si91x_server_socket->rx_ring_size;
+    si91x_client_socket->recv_data_callback = si91x_server_socket->recv_data_callback;
+    if (sli_si91x_socket_rx_ring_create(si91x_client_socket) != SL_STATUS_OK) {
+      close(client_socket_id);
+      SET_ERROR_AND_RETURN(ENOMEM);
+    }
+  }
+
   // populating socket info to accept request structure
   accept_request.socket_id   = (uint8_t)si91x_server_socket->id;
   accept_request.source_port = si91x_server_socket->local_address.sin6_port;
@@ -336,25 +346,19 @@ ssize_t recv(int socket_id, void *buf, size_t buf_len, int flags)
   return recvfrom(socket_id, buf, buf_len, flags, NULL, NULL);
 }
 
-ssize_t sendto(int socket_id,
-               const void *data,
-               size_t data_len,
-               int flags,
-               const struct sockaddr *to_addr,
-               socklen_t to_addr_len)
+// Validate a send on the socket and fill the socket send request for data_len bytes of payload
+static int sli_si91x_prepare_send_request(int socket_id,
+                                          size_t data_len,
+                                          const struct sockaddr *to_addr,
+                                          socklen_t to_addr_len,
+                                          sl_si91x_socket_send_request_t *request)
 {
-  // Initialize variables and error handling
-  UNUSED_PARAMETER(flags);
-  errno = 0;
-
-  sl_status_t status                     = SL_STATUS_OK;
-  si91x_socket_t *si91x_socket           = get_si91x_socket(socket_id);
-  sl_si91x_socket_send_request_t request = { 0 };
+  sl_status_t status           = SL_STATUS_OK;
+  si91x_socket_t *si91x_socket = get_si91x_socket(socket_id);
 
   // Check for various error conditions
   SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket == NULL, EBADF);
   SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->type == SOCK_STREAM && si91x_socket->state != CONNECTED, ENOTCONN);
-  SET_ERRNO_AND_RETURN_IF_TRUE(data == NULL, EFAULT);
 
   if (si91x_socket->type == SOCK_STREAM) {
     if (si91x_socket->ssl_bitmap & SL_SI91X_ENABLE_TLS) {
@@ -402,18 +406,18 @@ ssize_t sendto(int socket_id,
   // create a socket send request
   if (si91x_socket->local_address.sin6_family == AF_INET6) {
     const struct sockaddr_in6 *socket_address = (const struct sockaddr_in6 *)to_addr;
-    request.ip_version                        = SL_IPV6_VERSION;
-    request.data_offset = (si91x_socket->type == SOCK_STREAM) ? TCP_V6_HEADER_LENGTH : UDP_V6_HEADER_LENGTH;
+    request->ip_version                       = SL_IPV6_VERSION;
+    request->data_offset = (si91x_socket->type == SOCK_STREAM) ? TCP_V6_HEADER_LENGTH : UDP_V6_HEADER_LENGTH;
     const uint8_t *destination_ip =
       (si91x_socket->state == UDP_UNCONNECTED_READY || to_addr_len >= sizeof(struct sockaddr_in6))
         ? socket_address->sin6_addr.__u6_addr.__u6_addr8
         : si91x_socket->remote_address.sin6_addr.__u6_addr.__u6_addr8;
 
-    memcpy(request.dest_ip_addr.ipv6_address, destination_ip, SL_IPV6_ADDRESS_LENGTH);
+    memcpy(request->dest_ip_addr.ipv6_address, destination_ip, SL_IPV6_ADDRESS_LENGTH);
   } else {
     const struct sockaddr_in *socket_address = (const struct sockaddr_in *)to_addr;
-    request.ip_version                       = SL_IPV4_VERSION;
-    request.data_offset = (si91x_socket->type == SOCK_STREAM) ? TCP_HEADER_LENGTH : UDP_HEADER_LENGTH;
+    request->ip_version                      = SL_IPV4_VERSION;
+    request->data_offset = (si91x_socket->type == SOCK_STREAM) ? TCP_HEADER_LENGTH : UDP_HEADER_LENGTH;
     const uint32_t *destination_ip =
       (si91x_socket->state == UDP_UNCONNECTED_READY || to_addr_len >= sizeof(struct sockaddr_in))
         ? &socket_address->sin_addr.s_addr
@@ -423,18 +427,42 @@ ssize_t sendto(int socket_id,
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #endif // __GNUC__
-    memcpy(request.dest_ip_addr.ipv4_address, destination_ip, SL_IPV4_ADDRESS_LENGTH);
+    memcpy(request->dest_ip_addr.ipv4_address, destination_ip, SL_IPV4_ADDRESS_LENGTH);
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif // __GNUC__
   }
 
   // Set other parameters in the request structure
-  request.socket_id = (uint16_t)si91x_socket->id;
-  request.dest_port = (si91x_socket->state == UDP_UNCONNECTED_READY || to_addr_len > 0)
-                        ? ((const struct sockaddr_in *)to_addr)->sin_port
-                        : si91x_socket->remote_address.sin6_port;
-  request.length    = data_len;
+  request->socket_id = (uint16_t)si91x_socket->id;
+  request->dest_port = (si91x_socket->state == UDP_UNCONNECTED_READY || to_addr_len > 0)
+                         ? ((const struct sockaddr_in *)to_addr)->sin_port
+                         : si91x_socket->remote_address.sin6_port;
+  request->length    = data_len;
+
+  return SI91X_NO_ERROR;
+}
+
+ssize_t sendto(int socket_id,
+               const void *data,
+               size_t data_len,
+               int flags,
+               const struct sockaddr *to_addr,
+               socklen_t to_addr_len)
+{
+  // Initialize variables and error handling
+  UNUSED_PARAMETER(flags);
+  errno = 0;
+
+  sl_status_t status                     = SL_STATUS_OK;
+  sl_si91x_socket_send_request_t request = { 0 };
+
+  SET_ERRNO_AND_RETURN_IF_TRUE(get_si91x_socket(socket_id) == NULL, EBADF);
+  SET_ERRNO_AND_RETURN_IF_TRUE(data == NULL, EFAULT);
+
+  if (sli_si91x_prepare_send_request(socket_id, data_len, to_addr, to_addr_len, &request) != SI91X_NO_ERROR) {
+    return -1;
+  }
 
   // Send the socket data request
   status = sl_si91x_driver_send_socket_data(&request, data, 0);
@@ -443,9 +471,104 @@ ssize_t sendto(int socket_id,
   return data_len;
 }
 
+ssize_t sendmsg(int socket_id, const struct msghdr *message, int flags)
+{
+  UNUSED_PARAMETER(flags);
+  errno = 0;
+
+  sl_status_t status                     = SL_STATUS_OK;
+  sl_si91x_socket_send_request_t request = { 0 };
+  sl_wifi_buffer_t *buffer               = NULL;
+  uint8_t *payload                       = NULL;
+  size_t data_len                        = 0;
+
+  SET_ERRNO_AND_RETURN_IF_TRUE(get_si91x_socket(socket_id) == NULL, EBADF);
+  SET_ERRNO_AND_RETURN_IF_TRUE(message == NULL, EFAULT);
+  SET_ERRNO_AND_RETURN_IF_TRUE(message->msg_iov == NULL && message->msg_iovlen != 0, EFAULT);
+
+  for (unsigned int index = 0; index < message->msg_iovlen; index++) {
+    SET_ERRNO_AND_RETURN_IF_TRUE(message->msg_iov[index].iov_base == NULL && message->msg_iov[index].iov_len != 0,
+                                 EFAULT);
+    data_len += message->msg_iov[index].iov_len;
+  }
+
+  if (sli_si91x_prepare_send_request(socket_id, data_len, message->msg_name, message->msg_namelen, &request)
+      != SI91X_NO_ERROR) {
+    return -1;
+  }
+
+  // Gather the I/O vectors straight into the TX frame, without staging them in a contiguous buffer first
+  status = sl_si91x_driver_allocate_socket_data_buffer(&request, &buffer, (void **)&payload);
+  SOCKET_VERIFY_STATUS_AND_RETURN(status, SL_STATUS_OK, ENOBUFS);
+
+  for (unsigned int index = 0; index < message->msg_iovlen; index++) {
+    memcpy(payload, message->msg_iov[index].iov_base, message->msg_iov[index].iov_len);
+    payload += message->msg_iov[index].iov_len;
+  }
+
+  status = sl_si91x_driver_send_socket_data_buffer(buffer, 0);
+  SOCKET_VERIFY_STATUS_AND_RETURN(status, SL_STATUS_OK, ENOBUFS);
+
+  return data_len;
+}
+
+// Fill a BSD address structure with the source address of received data
+static void sli_si91x_copy_source_address(const sl_si91x_socket_metadata_t *metadata,
+                                          struct sockaddr *addr,
+                                          socklen_t *addr_len)
+{
+  if (metadata->ip_version == SL_IPV4_VERSION && *addr_len >= sizeof(struct sockaddr_in)) {
+    struct sockaddr_in *socket_address = (struct sockaddr_in *)addr;
+
+    socket_address->sin_port   = metadata->dest_port;
+    socket_address->sin_family = AF_INET;
+    memcpy(&socket_address->sin_addr.s_addr, metadata->dest_ip_addr.ipv4_address, SL_IPV4_ADDRESS_LENGTH);
+
+    *addr_len = sizeof(struct sockaddr_in);
+  } else if (metadata->ip_version == SL_IPV6_VERSION && *addr_len >= sizeof(struct sockaddr_in6)) {
+    struct sockaddr_in6 *ipv6_socket_address = ((struct sockaddr_in6 *)addr);
+
+    ipv6_socket_address->sin6_port   = metadata->dest_port;
+    ipv6_socket_address->sin6_family = AF_INET6;
+    memcpy(&ipv6_socket_address->sin6_addr.__u6_addr.__u6_addr8,
+           metadata->dest_ip_addr.ipv6_address,
+           SL_IPV6_ADDRESS_LENGTH);
+
+    *addr_len = sizeof(struct sockaddr_in6);
+  } else {
+    // Not BSD compliant.
+    *addr_len = 0;
+  }
+}
+
+// Read from the host-side receive ring of a socket configured with SO_RX_RING_SIZE
+static ssize_t sli_si91x_recvfrom_rx_ring(si91x_socket_t *si91x_socket,
+                                          void *buf,
+                                          size_t buf_len,
+                                          int flags,
+                                          struct sockaddr *addr,
+                                          socklen_t *addr_len)
+{
+  sl_si91x_socket_metadata_t source = { 0 };
+  size_t bytes_read                 = 0;
+  sl_status_t status = sli_si91x_socket_rx_ring_read(si91x_socket, buf, buf_len, flags, &source, &bytes_read);
+
+  // Peer closed the connection and all buffered data has been consumed
+  if (status == SL_STATUS_NOT_AVAILABLE) {
+    return 0;
+  }
+  SET_ERRNO_AND_RETURN_IF_TRUE(status == SL_STATUS_WOULD_BLOCK || status == SL_STATUS_TIMEOUT, EAGAIN);
+  SOCKET_VERIFY_STATUS_AND_RETURN(status, SL_STATUS_OK, SI91X_UNDEFINED_ERROR);
+
+  if (addr != NULL) {
+    sli_si91x_copy_source_address(&source, addr, addr_len);
+  }
+
+  return (ssize_t)bytes_read;
+}
+
 ssize_t recvfrom(int socket_id, void *buf, size_t buf_len, int flags, struct sockaddr *addr, socklen_t *addr_len)
 {
-  UNUSED_PARAMETER(flags); // Ignoring the 'flags' parameter
   sl_si91x_wait_period_t wait_time = 0;
   errno                            = 0;
 
@@ -461,7 +584,10 @@ ssize_t recvfrom(int socket_id, void *buf, size_t buf_len, int flags, struct soc
 
   // Check for error conditions and return appropriate error codes
   SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket == NULL, EBADF);
-  SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->type == SOCK_STREAM && si91x_socket->state != CONNECTED, ENOTCONN);
+  // Data buffered in the receive ring stays readable after the peer has closed the connection
+  SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->type == SOCK_STREAM && si91x_socket->state != CONNECTED
+                                 && !(si91x_socket->rx_ring != NULL && si91x_socket->state == DISCONNECTED),
+                               ENOTCONN);
   SET_ERRNO_AND_RETURN_IF_TRUE(buf == NULL, EFAULT);
   SET_ERRNO_AND_RETURN_IF_TRUE(buf_len <= 0, EINVAL);
 
@@ -473,6 +599,10 @@ ssize_t recvfrom(int socket_id, void *buf, size_t buf_len, int flags, struct soc
     si91x_socket->state = UDP_UNCONNECTED_READY;
   }
 
+  if (si91x_socket->rx_ring != NULL) {
+    return sli_si91x_recvfrom_rx_ring(si91x_socket, buf, buf_len, flags, addr, addr_len);
+  }
+
   // Possible states are only reset and disconnected.
   SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->state != CONNECTED && si91x_socket->state != UDP_UNCONNECTED_READY, EBADF);
 
@@ -521,28 +651,7 @@ ssize_t recvfrom(int socket_id, void *buf, size_t buf_len, int flags, struct soc
 
   // If an address structure is provided, fill it with destination address information
   if (addr != NULL) {
-    if (response->ip_version == SL_IPV4_VERSION && *addr_len >= sizeof(struct sockaddr_in)) {
-      struct sockaddr_in *socket_address = (struct sockaddr_in *)addr;
-
-      socket_address->sin_port   = response->dest_port;
-      socket_address->sin_family = AF_INET;
-      memcpy(&socket_address->sin_addr.s_addr, response->dest_ip_addr.ipv4_address, SL_IPV4_ADDRESS_LENGTH);
-
-      *addr_len = sizeof(struct sockaddr_in);
-    } else if (response->ip_version == SL_IPV6_VERSION && *addr_len >= sizeof(struct sockaddr_in6)) {
-      struct sockaddr_in6 *ipv6_socket_address = ((struct sockaddr_in6 *)addr);
-
-      ipv6_socket_address->sin6_port   = response->dest_port;
-      ipv6_socket_address->sin6_family = AF_INET6;
-      memcpy(&ipv6_socket_address->sin6_addr.__u6_addr.__u6_addr8,
-             response->dest_ip_addr.ipv6_address,
-             SL_IPV6_ADDRESS_LENGTH);
-
-      *addr_len = sizeof(struct sockaddr_in6);
-    } else {
-      // Not BSD compliant.
-      *addr_len = 0;
-    }
+    sli_si91x_copy_source_address(response, addr, addr_len);
   }
 
   // Free the buffer
@@ -697,6 +806,18 @@ int sl_si91x_set_custom_sync_sockopt(int socket_id,
       break;
     }
 
+    case SO_RX_RING_SIZE: {
+      // The receive ring can only be set up before the socket is created in the firmware
+      SET_ERRNO_AND_RETURN_IF_TRUE(option_length < sizeof(uint32_t), EINVAL);
+      SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->state != INITIALIZED && si91x_socket->state != BOUND, EISCONN);
+      SET_ERRNO_AND_RETURN_IF_TRUE(si91x_socket->recv_data_callback != NULL, EINVAL);
+      SET_ERRNO_AND_RETURN_IF_TRUE(*(const uint32_t *)option_value > SI91X_SOCKET_RX_RING_MAX_SIZE, EINVAL);
+      SET_ERRNO_AND_RETURN_IF_TRUE(*(const uint32_t *)option_value < SI91X_SOCKET_RX_RING_MIN_SIZE, EINVAL);
+
+      si91x_socket->rx_ring_size = *(const uint32_t *)option_value;
+      break;
+    }
+
     case SO_TLS_SNI: {
       // Call a function to add a Server Name Indication (SNI) extension to si91x_socket
       sl_status_t status = add_server_name_indication_extension(&si91x_socket->sni_extensions,
@@ -816,6 +937,15 @@ int sl_si91x_get_custom_sync_sockopt(int socket_id,
     // Retrieve and copy the socket certificate index
     *option_length = GET_SAFE_MEMCPY_LENGTH(*option_length, sizeof(si91x_socket->certificate_index));
     memcpy(option_value, &si91x_socket->certificate_index, *option_length);
+  } else if (option_name == SO_RX_RING_SIZE) {
+    // Retrieve and copy the configured receive ring size
+    *option_length = GET_SAFE_MEMCPY_LENGTH(*option_length, sizeof(si91x_socket->rx_ring_size));
+    memcpy(option_value, &si91x_socket->rx_ring_size, *option_length);
+  } else if (option_name == SO_RX_RING_DROPPED) {
+    // Retrieve and copy the number of bytes dropped by the receive ring
+    uint32_t dropped_bytes = (si91x_socket->rx_ring != NULL) ? si91x_socket->rx_ring->dropped_bytes : 0;
+    *option_length         = GET_SAFE_MEMCPY_LENGTH(*option_length, sizeof(dropped_bytes));
+    memcpy(option_value, &dropped_bytes, *option_length);
   } else {
     // Unsupported option
     SET_ERROR_AND_RETURN(ENOPROTOOPT);
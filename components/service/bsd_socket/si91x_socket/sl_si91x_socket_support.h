@@ -76,7 +76,7 @@ typedef struct {
  * @param[in]  option_level   
  * Level at which the option is defined. One of the values from @ref BSD_SOCKET_OPTION_LEVEL.
  * @param[in]  option_name    
- * Name of the option to be set. Currently, ONLY @ref SO_CERT_INDEX, @ref SO_HIGH_PERFORMANCE_SOCKET, @ref SO_TLS_SNI are supported.
+ * Name of the option to be set. Currently, ONLY @ref SO_CERT_INDEX, @ref SO_HIGH_PERFORMANCE_SOCKET, @ref SO_TLS_SNI, @ref SO_RX_RING_SIZE are supported.
  * @param[in]  option_value   
  * Pointer to the value for the option.
  * @param[in]  option_length  
@@ -84,6 +84,15 @@ typedef struct {
  * @return     
  * Returns 0 on success or -1 on error (in which case, errno is set appropriately).
  *
+ * @note
+ *   @ref SO_RX_RING_SIZE takes a uint32_t size in bytes, from SI91X_SOCKET_RX_RING_MIN_SIZE up to
+ *   SI91X_SOCKET_RX_RING_MAX_SIZE, and must be set before the socket is connected, bound for UDP reads or put in
+ *   listen state. Received data is then pushed by the firmware into a host-side ring, and recv()/recvfrom() support
+ *   MSG_PEEK, MSG_WAITALL and MSG_DONTWAIT. Accepted sockets inherit the ring size of the listening socket. Datagrams
+ *   that do not fit in the ring are dropped and counted by @ref SO_RX_RING_DROPPED. Stream data that does not fit is
+ *   kept in driver RX buffers until recv() makes room for it. Once SL_SI91X_MAX_HELD_RX_FRAMES frames are kept, the
+ *   driver stops reading from the network processor, which then stops accepting TCP data. Other sockets, events and
+ *   command responses wait too, so keep reading stream sockets that have a ring.
  */
 int sl_si91x_set_custom_sync_sockopt(int socket_id,
                                      int option_level,
@@ -98,7 +107,7 @@ int sl_si91x_set_custom_sync_sockopt(int socket_id,
  * @param[in]  option_level   
  * Level at which the option is defined. One of the values from @ref BSD_SOCKET_OPTION_LEVEL.
  * @param[in]  option_name    
- * Name of the option to be retrieved. Currently, ONLY @ref SO_CERT_INDEX is supported.
+ * Name of the option to be retrieved. Currently, ONLY @ref SO_CERT_INDEX, @ref SO_RX_RING_SIZE, @ref SO_RX_RING_DROPPED are supported.
  * @param[in]  option_value   
  * Pointer to the value for the option.
  * @param[in]  option_length  
@@ -126,6 +126,36 @@ sl_status_t sl_mqtt_client_publish(sl_mqtt_client_t *client,
                                    uint32_t timeout,
                                    void *context);
 
+/***************************************************************************/ /**
+ * @brief
+ *   Queue a message for publishing without waiting for the previous publishes to complete.
+ * @pre Pre-conditions:
+ * - 
+ *   @ref sl_mqtt_client_connect should be called before this API.
+ * @param[in] client	
+ *   @ref sl_mqtt_client_t client which requires to publish the message.
+ * @param[in] message	
+ *   @ref sl_mqtt_client_message_t Message which needs to be published. It is copied before the API returns.
+ * @param[in] timeout	
+ *   Time in milliseconds to wait for one of the SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE publish slots to become free.
+ * @param[in] complete_handler
+ *   @ref sl_mqtt_client_publish_complete_t handler called once the publish completes. May be NULL.
+ * @param[in] context   
+ *   Context which would be returned in the complete handler.
+ * @return			
+ *   sl_status_t. SL_STATUS_IN_PROGRESS if the message was queued, SL_STATUS_TIMEOUT if no publish slot became free.
+ * @note
+ *  Up to SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE publishes are kept queued or in flight. The request is built directly
+ *  in the driver command frame, so this API does not use the heap.
+ * @note
+ *  The maximum length of the topic should be less than SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH.
+ ******************************************************************************/
+sl_status_t sl_mqtt_client_publish_pipelined(sl_mqtt_client_t *client,
+                                             const sl_mqtt_client_message_t *message,
+                                             uint32_t timeout,
+                                             sl_mqtt_client_publish_complete_t complete_handler,
+                                             void *context);
+
 /***************************************************************************/ /**
  * @brief
  *   Indicate which client can subscribe to a topic.
@@ -150,6 +180,9 @@ sl_status_t sl_mqtt_client_publish(sl_mqtt_client_t *client,
  *   sl_status_t. If called asynchronously, SL_STATUS_IN_PROGRESS will be returned as status.
  * @note
  *   The maximum length of the topic should be less than SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH.
+ * @note
+ *   A message whose topic matches several subscribed topics, for example "home/+/temperature" and "home/#", is
+ *   passed to the message handler of each of them. Message handlers must not unsubscribe before they return.
  ******************************************************************************/
 sl_status_t sl_mqtt_client_subscribe(sl_mqtt_client_t *client,
                                      const uint8_t *topic,
@@ -168,7 +201,7 @@ sl_status_t sl_mqtt_client_subscribe(sl_mqtt_client_t *client,
  * @param[in] client			
  *   @ref sl_mqtt_client_t client that unsubscribes the topic.
  * @param[in] topic				
- *   Topic from which client needs to unsubscribe.
+ *   Topic from which client needs to unsubscribe, exactly as it was given to @ref sl_mqtt_client_subscribe.
  * @param[in] length			
  *   Length of the topic.
  * @param[in] timeout	
@@ -215,9 +215,31 @@ typedef void (*sl_mqtt_client_message_received_t)(void *client,
                                                   sl_mqtt_client_message_t *message_to_be_published,
                                                   void *context);
 
+/// Number of publishes that @ref sl_mqtt_client_publish_pipelined can have queued or in flight at the same time
+#ifndef SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE
+#define SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE 4
+#endif
+
+/**
+ * @typedef sl_mqtt_client_publish_complete_t
+ * @brief
+ *    Handler for the completion of a publish queued with @ref sl_mqtt_client_publish_pipelined.
+ * @param client
+ *    Client which published the message.
+ * @param status
+ *    SL_STATUS_OK if the publish succeeded, otherwise the reason it failed.
+ * @param context
+ *    Context provided by user at the time of the publish call.
+ */
+typedef void (*sl_mqtt_client_publish_complete_t)(void *client, sl_status_t status, void *context);
+
+/// Node of the topic-level index that the MQTT client builds over its subscriptions
+typedef struct sl_mqtt_client_topic_node_s sl_mqtt_client_topic_node_t;
+
 /// MQTT Client Topic Subscription Info structure
 typedef struct {
   sl_slist_node_t next_subscription;                       ///< Next node in the linked list.
+  sl_slist_node_t next_topic_subscription;                 ///< Next subscription with the same topic filter.
   sl_mqtt_client_message_received_t topic_message_handler; ///< A function pointer to message handler.
   sl_mqtt_qos_t qos_of_subscription;                       ///< Quality of subscription.
   uint16_t
@@ -235,6 +257,8 @@ typedef struct {
     *client_configuration; ///< Pointer to client configuration, given at the time of connect() API.
   sl_mqtt_client_topic_subscription_info_t
     *subscription_list_head; ///< Pointer to the head of the subscription linked list.
+  sl_mqtt_client_topic_node_t
+    *subscription_index; ///< Root of the topic-level index of the subscription list, used to match received topics.
   sl_mqtt_client_event_handler_t
     client_event_handler; ///< Function pointer to event handler given at the time of @ref sl_mqtt_client_init.
 } sl_mqtt_client_t;
@@ -24,6 +24,8 @@
 #include "sl_mqtt_client_types.h"
 #include "si91x_mqtt_client_types.h"
 #include "si91x_mqtt_client_utility.h"
+#include "cmsis_os2.h"
+#include "em_core.h"
 #include "sl_status.h"
 
 /**
@@ -56,9 +58,6 @@
 	^ -> firmware events
 **/
 
-// Declaring strtok_r as extern to suppress implicit declaration warning.
-extern char *strtok_r(char *, const char *, char **);
-
 #define SI91X_MQTT_CLIENT_INIT_TIMEOUT        5000
 #define SI91X_MQTT_CLIENT_DISCONNECT_TIMEOUT  5000
 #define SI91X_MQTT_CHECK_RETAIN_MESSAGE       BIT(0)
@@ -73,87 +72,385 @@ extern char *strtok_r(char *, const char *, char **);
     }                                                       \
   } while (0)
 
+// Node of the subscription index. Each node stands for one level of a topic filter, so the subscriptions of a node
+// are those whose topic filter is made of the levels on the path from the root to the node.
+struct sl_mqtt_client_topic_node_s {
+  sl_mqtt_client_topic_node_t *parent;
+  sl_mqtt_client_topic_node_t *next_sibling;
+  sl_mqtt_client_topic_node_t *children;           // Children whose level is a plain string
+  sl_mqtt_client_topic_node_t *single_level_child; // Child whose level is "+"
+  sl_mqtt_client_topic_node_t *multi_level_child;  // Child whose level is "#"
+  sl_slist_node_t *subscriptions;                  // Subscriptions whose topic filter ends at this node
+  uint16_t pending_subscriptions;                  // Subscribe requests in flight whose topic filter ends here
+  uint16_t deliveries;                             // Received messages whose delivery is walking this node
+  uint16_t level_length;
+  uint32_t level_hash;
+  uint8_t level[];
+};
+
+// Publish slot of sl_mqtt_client_publish_pipelined(); the SDK context is the first member, so the context the driver
+// hands back with the response is also the slot
+typedef struct {
+  sl_si91x_mqtt_client_context_t sdk_context;
+  sl_mqtt_client_publish_complete_t complete_handler;
+  bool in_use;
+} sli_si91x_mqtt_publish_slot_t;
+
 static sl_mqtt_client_t *mqtt_client;
+static sli_si91x_mqtt_publish_slot_t publish_window[SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE];
+static osSemaphoreId_t publish_window_semaphore;
+// Message handlers may unsubscribe or disconnect. While they run, removed subscriptions and a dropped index are only
+// unlinked from the client, and freed once the delivery of the message is complete.
+static bool delivering_message;
+static sl_slist_node_t *deferred_subscription_removals;
+static sl_mqtt_client_topic_node_t *deferred_subscription_index;
 static sl_mqtt_client_error_status_t sli_si91x_get_event_error_status(sl_mqtt_client_event_t event);
+
+static uint32_t sli_si91x_get_topic_level_hash(const uint8_t *level, uint16_t level_length)
+{
+  // FNV-1a, only used to skip most of the memcmp() calls while searching the children of a node
+  uint32_t hash = 2166136261UL;
+
+  for (uint16_t index = 0; index < level_length; index++) {
+    hash = (hash ^ level[index]) * 16777619UL;
+  }
+  return hash;
+}
+
+static uint16_t sli_si91x_get_topic_level_length(const uint8_t *topic, uint16_t topic_length, uint16_t offset)
+{
+  uint16_t end = offset;
+
+  while ((end < topic_length) && (topic[end] != SL_SI91X_MQTT_CLIENT_TOPIC_DELIMITER[0])) {
+    end++;
+  }
+  return (uint16_t)(end - offset);
+}
+
+static inline bool sli_si91x_is_wild_card_level(const uint8_t *level, uint16_t level_length, const char *wild_card)
+{
+  return (level_length == 1) && (level[0] == (uint8_t)wild_card[0]);
+}
+
 /**
- * A internal helper function to get node of list which matches the given topic.
- * @param client 		Pointer to client object whose subscription list needs to be searched.
- * @param topic			Topic which needs to be searched in list.
- * @param topic_length	Length of the topic that needs to be searched.
- * @param required_node	A double pointer to node pointer.
+ * A internal helper function to get the link in the index that holds the child of a node for a topic level.
+ * @param node			Node whose children need to be searched.
+ * @param level			Topic level, not NULL terminated.
+ * @param level_length	Length of the topic level.
+ * @param level_hash	Hash of the topic level.
+ * @return				Link to the child, which points to NULL if the node has no child for the level.
  */
-static void sli_si91x_get_subscription(const sl_mqtt_client_t *client,
-                                       const uint8_t *topic,
-                                       const uint16_t topic_length,
-                                       sl_mqtt_client_topic_subscription_info_t **required_subscription)
+static sl_mqtt_client_topic_node_t **sli_si91x_get_topic_node_link(sl_mqtt_client_topic_node_t *node,
+                                                                   const uint8_t *level,
+                                                                   uint16_t level_length,
+                                                                   uint32_t level_hash)
 {
-  sl_mqtt_client_topic_subscription_info_t *subscription = client->subscription_list_head;
+  sl_mqtt_client_topic_node_t **link = &node->children;
 
-  uint8_t subscribed_topic[SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH] = { 0 };
-  uint8_t received_topic[SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH]   = { 0 };
-  *required_subscription                                           = NULL;
+  if (sli_si91x_is_wild_card_level(level, level_length, SL_SI91X_MQTT_CLIENT_SINGLE_LEVEL_WILD_CARD)) {
+    return &node->single_level_child;
+  }
+  if (sli_si91x_is_wild_card_level(level, level_length, SL_SI91X_MQTT_CLIENT_MULTI_LEVEL_WILD_CARD)) {
+    return &node->multi_level_child;
+  }
 
-  // If the topic length is greater than or equal to SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH, return.
-  if (topic_length >= SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH) {
+  while ((*link != NULL)
+         && (((*link)->level_hash != level_hash) || ((*link)->level_length != level_length)
+             || (memcmp((*link)->level, level, level_length) != 0))) {
+    link = &(*link)->next_sibling;
+  }
+  return link;
+}
+
+// Frees the nodes from the given one up towards the root for as long as they no longer lead to a subscription
+static void sli_si91x_prune_topic_node(sl_mqtt_client_t *client, sl_mqtt_client_topic_node_t *node)
+{
+  while ((node != NULL) && (node->subscriptions == NULL) && (node->pending_subscriptions == 0)
+         && (node->deliveries == 0) && (node->children == NULL) && (node->single_level_child == NULL)
+         && (node->multi_level_child == NULL)) {
+    sl_mqtt_client_topic_node_t *parent = node->parent;
+
+    if (parent == NULL) {
+      client->subscription_index = NULL;
+    } else {
+      *sli_si91x_get_topic_node_link(parent, node->level, node->level_length, node->level_hash) = node->next_sibling;
+    }
+    free(node);
+    node = parent;
+  }
+}
+
+/**
+ * A internal helper function to get the node of the subscription index for a topic filter.
+ * @param client 		Pointer to client object whose subscription index needs to be searched.
+ * @param topic			Topic filter, wildcards are compared as plain levels.
+ * @param topic_length	Length of the topic filter.
+ * @param create		Whether the missing nodes on the path of the topic filter are allocated.
+ * @return				The node of the topic filter, or NULL if it does not exist or could not be allocated.
+ */
+static sl_mqtt_client_topic_node_t *sli_si91x_get_topic_node(sl_mqtt_client_t *client,
+                                                             const uint8_t *topic,
+                                                             uint16_t topic_length,
+                                                             bool create)
+{
+  sl_mqtt_client_topic_node_t *node;
+  uint16_t offset = 0;
+
+  if (client->subscription_index == NULL) {
+    if (!create) {
+      return NULL;
+    }
+    client->subscription_index = calloc(1, sizeof(sl_mqtt_client_topic_node_t));
+  }
+  node = client->subscription_index;
+
+  // Every topic has at least one level, and a delimiter at the end of the topic starts an empty level
+  while ((node != NULL) && (offset <= topic_length)) {
+    const uint8_t *level  = &topic[offset];
+    uint16_t level_length = sli_si91x_get_topic_level_length(topic, topic_length, offset);
+    uint32_t level_hash   = sli_si91x_get_topic_level_hash(level, level_length);
+
+    sl_mqtt_client_topic_node_t **link = sli_si91x_get_topic_node_link(node, level, level_length, level_hash);
+
+    if ((*link == NULL) && create) {
+      *link = calloc(1, sizeof(sl_mqtt_client_topic_node_t) + level_length);
+      if (*link == NULL) {
+        sli_si91x_prune_topic_node(client, node);
+        return NULL;
+      }
+      (*link)->parent       = node;
+      (*link)->level_length = level_length;
+      (*link)->level_hash   = level_hash;
+      memcpy((*link)->level, level, level_length);
+    }
+
+    node = *link;
+    offset += level_length + 1;
+  }
+  return node;
+}
+
+// Makes sure the nodes of a topic filter exist before it is subscribed, so the subscription can be indexed without allocating
+static sl_status_t sli_si91x_reserve_subscription(sl_mqtt_client_t *client, const uint8_t *topic, uint16_t topic_length)
+{
+  sl_mqtt_client_topic_node_t *node = sli_si91x_get_topic_node(client, topic, topic_length, true);
+
+  if (node == NULL) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  node->pending_subscriptions++;
+  return SL_STATUS_OK;
+}
+
+// Releases the nodes reserved for a subscription that the broker did not accept
+static void sli_si91x_cancel_subscription(sl_mqtt_client_t *client,
+                                          const sl_mqtt_client_topic_subscription_info_t *subscription)
+{
+  sl_mqtt_client_topic_node_t *node =
+    sli_si91x_get_topic_node(client, subscription->topic, subscription->topic_length, false);
+
+  if ((node != NULL) && (node->pending_subscriptions > 0)) {
+    node->pending_subscriptions--;
+    sli_si91x_prune_topic_node(client, node);
+  }
+}
+
+// Adds a subscription that the broker accepted to the subscription list and to the index
+static sl_status_t sli_si91x_add_subscription(sl_mqtt_client_t *client,
+                                              sl_mqtt_client_topic_subscription_info_t *subscription)
+{
+  // The nodes were reserved by the subscribe call, unless all subscriptions were dropped while it was in flight
+  sl_mqtt_client_topic_node_t *node =
+    sli_si91x_get_topic_node(client, subscription->topic, subscription->topic_length, true);
+
+  if (node == NULL) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+  if (node->pending_subscriptions > 0) {
+    node->pending_subscriptions--;
+  }
+
+  sl_slist_push(&node->subscriptions, &subscription->next_topic_subscription);
+  sl_slist_push((sl_slist_node_t **)&client->subscription_list_head, (sl_slist_node_t *)subscription);
+  return SL_STATUS_OK;
+}
+
+// Removes a subscription from the subscription list and the index, and frees it
+static void sli_si91x_remove_subscription(sl_mqtt_client_t *client,
+                                          sl_mqtt_client_topic_subscription_info_t *subscription)
+{
+  sl_slist_remove((sl_slist_node_t **)&client->subscription_list_head, (sl_slist_node_t *)subscription);
+
+  if (delivering_message) {
+    // The delivery may still be walking the subscription, so it only stops receiving messages until then
+    subscription->topic_message_handler = NULL;
+    sl_slist_push(&deferred_subscription_removals, &subscription->next_subscription);
     return;
   }
 
-  while (subscription != NULL) {
-    memcpy(subscribed_topic, subscription->topic, subscription->topic_length);
-    memcpy(received_topic, topic, topic_length);
+  sl_mqtt_client_topic_node_t *node =
+    sli_si91x_get_topic_node(client, subscription->topic, subscription->topic_length, false);
 
-    // adding null character at the end of the string as topic might not end with null terminating character.
-    // the size of topic is guaranteed to be less than SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH.
-    subscribed_topic[subscription->topic_length] = '\0';
+  if (node != NULL) {
+    sl_slist_remove(&node->subscriptions, &subscription->next_topic_subscription);
+    sli_si91x_prune_topic_node(client, node);
+  }
+  free(subscription);
+}
 
-    char *subscribed_topic_save_ptr = NULL;
-    char *received_topic_save_ptr   = NULL;
+/**
+ * A internal helper function to get the subscription of an exact topic filter.
+ * @param client 		Pointer to client object whose subscriptions need to be searched.
+ * @param topic			Topic filter which needs to be searched, wildcards are compared as plain levels.
+ * @param topic_length	Length of the topic filter that needs to be searched.
+ * @return				The subscription, or NULL if the topic filter is not subscribed.
+ */
+static sl_mqtt_client_topic_subscription_info_t *sli_si91x_get_subscription(sl_mqtt_client_t *client,
+                                                                            const uint8_t *topic,
+                                                                            uint16_t topic_length)
+{
+  const sl_mqtt_client_topic_node_t *node = sli_si91x_get_topic_node(client, topic, topic_length, false);
+  sl_mqtt_client_topic_subscription_info_t *subscription;
 
-    const char *subscribed_topic_token = NULL;
-    const char *received_topic_token   = NULL;
+  if (node == NULL) {
+    return NULL;
+  }
 
-    subscribed_topic_token =
-      strtok_r((char *)subscribed_topic, SL_SI91X_MQTT_CLIENT_TOPIC_DELIMITER, &subscribed_topic_save_ptr);
-    received_topic_token =
-      strtok_r((char *)received_topic, SL_SI91X_MQTT_CLIENT_TOPIC_DELIMITER, &received_topic_save_ptr);
+  // Subscriptions removed during a message delivery stay in the index until it is complete
+  SL_SLIST_FOR_EACH_ENTRY(node->subscriptions,
+                          subscription,
+                          sl_mqtt_client_topic_subscription_info_t,
+                          next_topic_subscription)
+  {
+    if (subscription->topic_message_handler != NULL) {
+      return subscription;
+    }
+  }
+  return NULL;
+}
 
-    while (subscribed_topic_token != NULL && received_topic_token != NULL) {
-      uint8_t subscribe_topic_length = (uint8_t)(strlen(subscribed_topic_token));
+// Ends the use of a node by a message delivery, and frees it if handlers removed all that kept it in the index
+static void sli_si91x_release_topic_node(sl_mqtt_client_t *client, sl_mqtt_client_topic_node_t *node)
+{
+  node->deliveries--;
 
-      // This boolean stores whether the subscribed_topic_token is wildcard or not by checking the length of the token and character stored in it.
-      uint8_t is_wild_card =
-        (subscribe_topic_length == 1)
-        && ((strncmp(subscribed_topic_token, SL_SI91X_MQTT_CLIENT_MULTI_LEVEL_WILD_CARD, 1) == 0)
-            || (strncmp(subscribed_topic_token, SL_SI91X_MQTT_CLIENT_SINGLE_LEVEL_WILD_CARD, 1) == 0));
+  // A dropped index is freed as a whole once the delivery is complete
+  if (deferred_subscription_index == NULL) {
+    sli_si91x_prune_topic_node(client, node);
+  }
+}
 
-      uint8_t is_multi_level_wild_card =
-        is_wild_card && (strncmp(subscribed_topic_token, SL_SI91X_MQTT_CLIENT_MULTI_LEVEL_WILD_CARD, 1) == 0);
+static uint32_t sli_si91x_notify_subscriptions(sl_mqtt_client_t *client,
+                                               sl_mqtt_client_topic_node_t *node,
+                                               sl_mqtt_client_message_t *message,
+                                               void *context)
+{
+  sl_mqtt_client_topic_subscription_info_t *subscription;
+  uint32_t count = 0;
+
+  node->deliveries++;
+  SL_SLIST_FOR_EACH_ENTRY(node->subscriptions,
+                          subscription,
+                          sl_mqtt_client_topic_subscription_info_t,
+                          next_topic_subscription)
+  {
+    if (subscription->topic_message_handler != NULL) {
+      subscription->topic_message_handler(client, message, context);
+      count++;
+    }
+  }
+  sli_si91x_release_topic_node(client, node);
+  return count;
+}
 
-      // if subscribed_topic_token isn't wildcard and tokens does not match, break the loop and continue searching with other subscriptions.
-      if (!is_wild_card
-          && ((subscribe_topic_length != strlen(received_topic_token))
-              || memcmp(subscribed_topic_token, received_topic_token, subscribe_topic_length) != 0)) {
-        break;
-      } else if (is_multi_level_wild_card) {
-        // if the subscribed_topic_token is "#", the assign the current subscription as required_subscription and return.
-        *required_subscription = subscription;
-        return;
-      } else {
-        // The execution enters the else block either in case of single level wildcard or successful comparison of current token
-        subscribed_topic_token = strtok_r(NULL, SL_SI91X_MQTT_CLIENT_TOPIC_DELIMITER, &subscribed_topic_save_ptr);
-        received_topic_token   = strtok_r(NULL, SL_SI91X_MQTT_CLIENT_TOPIC_DELIMITER, &received_topic_save_ptr);
+/**
+ * A internal helper function to call the handler of every subscription whose topic filter matches a received topic.
+ * Only the "+" branches of the index are followed by recursion, so the stack depth is bounded by the number of
+ * single level wildcards in the subscribed topic filters rather than by the number of subscriptions.
+ * @param client 		Pointer to client object which received the message.
+ * @param node			Node of the index to match the remaining levels of the topic against.
+ * @param message		Received message.
+ * @param offset		Offset of the first topic level not matched yet.
+ * @param context		Context passed to the handlers.
+ * @return				Number of handlers called.
+ */
+static uint32_t sli_si91x_deliver_message(sl_mqtt_client_t *client,
+                                          sl_mqtt_client_topic_node_t *node,
+                                          sl_mqtt_client_message_t *message,
+                                          uint16_t offset,
+                                          void *context)
+{
+  const uint8_t *topic  = message->topic;
+  uint16_t topic_length = (uint16_t)message->topic_length;
+  uint32_t count        = 0;
+
+  while (node != NULL) {
+    sl_mqtt_client_topic_node_t *next = NULL;
+
+    // Handlers may subscribe to new topic filters or drop a subscription, so the node is kept while it is walked
+    node->deliveries++;
+
+    if (offset > topic_length) {
+      // All levels matched; "#" also matches the parent level, so "home/#" receives messages on "home"
+      count += sli_si91x_notify_subscriptions(client, node, message, context);
+      if (node->multi_level_child != NULL) {
+        count += sli_si91x_notify_subscriptions(client, node->multi_level_child, message, context);
+      }
+    } else {
+      const uint8_t *level  = &topic[offset];
+      uint16_t level_length = sli_si91x_get_topic_level_length(topic, topic_length, offset);
+
+      // Topics starting with '$' are reserved for the broker and are not matched by a wildcard in the first level
+      if ((offset != 0) || (level_length == 0) || (level[0] != '$')) {
+        if (node->multi_level_child != NULL) {
+          count += sli_si91x_notify_subscriptions(client, node->multi_level_child, message, context);
+        }
+        if (node->single_level_child != NULL) {
+          count +=
+            sli_si91x_deliver_message(client, node->single_level_child, message, offset + level_length + 1, context);
+        }
       }
 
-      // If both strings reach end of token, assign this subscription as required_subscription
-      // Example: subscription Topic: Home/+/TemperatureSensor
-      //          Received Topic:     Home/Garden/TemperatureSensor
-      if (subscribed_topic_token == NULL && received_topic_token == NULL) {
-        *required_subscription = subscription;
-        return;
+      uint32_t level_hash = sli_si91x_get_topic_level_hash(level, level_length);
+      next                = node->children;
+      while ((next != NULL)
+             && ((next->level_hash != level_hash) || (next->level_length != level_length)
+                 || (memcmp(next->level, level, level_length) != 0))) {
+        next = next->next_sibling;
       }
+      offset += level_length + 1;
     }
 
-    subscription = (sl_mqtt_client_topic_subscription_info_t *)subscription->next_subscription.node;
+    sli_si91x_release_topic_node(client, node);
+    node = next;
+  }
+  return count;
+}
+
+// Frees every node of a subscription index, always removing the first child of a node
+static void sli_si91x_free_topic_index(sl_mqtt_client_topic_node_t *node)
+{
+  while (node != NULL) {
+    sl_mqtt_client_topic_node_t *child = (node->children != NULL)             ? node->children
+                                         : (node->single_level_child != NULL) ? node->single_level_child
+                                                                              : node->multi_level_child;
+    if (child != NULL) {
+      node = child;
+      continue;
+    }
+
+    sl_mqtt_client_topic_node_t *parent = node->parent;
+    if (parent != NULL) {
+      if (parent->children == node) {
+        parent->children = node->next_sibling;
+      } else if (parent->single_level_child == node) {
+        parent->single_level_child = NULL;
+      } else {
+        parent->multi_level_child = NULL;
+      }
+    }
+    free(node);
+    node = parent;
   }
 }
 
@@ -164,9 +461,107 @@ static void sli_si91x_remove_and_free_all_subscriptions(sl_mqtt_client_t *client
   while ((node_to_be_freed = (sl_mqtt_client_topic_subscription_info_t *)(sl_slist_pop(
             (sl_slist_node_t **)&client->subscription_list_head)))
          != NULL) {
-    free(node_to_be_freed);
+    if (delivering_message) {
+      node_to_be_freed->topic_message_handler = NULL;
+      sl_slist_push(&deferred_subscription_removals, &node_to_be_freed->next_subscription);
+    } else {
+      free(node_to_be_freed);
+    }
+  }
+
+  // The index a message delivery is walking is freed once the delivery is complete
+  if (delivering_message && (deferred_subscription_index == NULL)) {
+    deferred_subscription_index = client->subscription_index;
+  } else {
+    sli_si91x_free_topic_index(client->subscription_index);
+  }
+  client->subscription_index = NULL;
+}
+
+// Calls the handler of every subscription matching a received message, then frees what the handlers removed
+static uint32_t sli_si91x_dispatch_message(sl_mqtt_client_t *client, sl_mqtt_client_message_t *message, void *context)
+{
+  sl_slist_node_t *removed;
+
+  delivering_message = true;
+  uint32_t count     = sli_si91x_deliver_message(client, client->subscription_index, message, 0, context);
+  delivering_message = false;
+
+  while ((removed = sl_slist_pop(&deferred_subscription_removals)) != NULL) {
+    sli_si91x_remove_subscription(client, (sl_mqtt_client_topic_subscription_info_t *)removed);
+  }
+  sli_si91x_free_topic_index(deferred_subscription_index);
+  deferred_subscription_index = NULL;
+  return count;
+}
+
+static inline bool sli_si91x_is_publish_window_context(const void *sdk_context)
+{
+  return ((const uint8_t *)sdk_context >= (const uint8_t *)&publish_window[0])
+         && ((const uint8_t *)sdk_context < (const uint8_t *)&publish_window[SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE]);
+}
+
+// Frees the slot of a completed pipelined publish and reports the result to the application
+static void sli_si91x_complete_publish(sl_si91x_mqtt_client_context_t *sdk_context, sl_status_t status)
+{
+  sli_si91x_mqtt_publish_slot_t *slot                = (sli_si91x_mqtt_publish_slot_t *)sdk_context;
+  sl_mqtt_client_publish_complete_t complete_handler = slot->complete_handler;
+  sl_mqtt_client_t *client                           = sdk_context->client;
+  void *user_context                                 = sdk_context->user_context;
+
+  // Free the slot before calling the handler, so the handler can queue the next publish
+  slot->in_use = false;
+  osSemaphoreRelease(publish_window_semaphore);
+
+  if (complete_handler != NULL) {
+    complete_handler(client, status, user_context);
   }
 }
+
+/**
+ * A internal helper function to send a publish request.
+ * The request is built directly in the driver command frame, so the message is copied once and the heap is not used.
+ * @param message		Message which needs to be published.
+ * @param wait_period	Timeout for the command response.
+ * @param sdk_context	Context handed back with the response if the request is sent asynchronously.
+ * @return				Status of the publish request.
+ */
+static sl_status_t sli_si91x_send_publish_request(const sl_mqtt_client_message_t *message,
+                                                  sl_si91x_wait_period_t wait_period,
+                                                  void *sdk_context)
+{
+  sl_wifi_buffer_t *buffer                                   = NULL;
+  si91x_mqtt_client_publish_request_t *si91x_publish_request = NULL;
+  uint32_t publish_request_size = sizeof(si91x_mqtt_client_publish_request_t) + message->content_length;
+
+  sl_status_t status = sl_si91x_driver_allocate_command_buffer(RSI_WLAN_REQ_EMB_MQTT_CLIENT,
+                                                               publish_request_size,
+                                                               &buffer,
+                                                               (void **)&si91x_publish_request);
+  VERIFY_STATUS_AND_RETURN(status);
+
+  memset(si91x_publish_request, 0, sizeof(si91x_mqtt_client_publish_request_t));
+  si91x_publish_request->command_type = SI91X_MQTT_CLIENT_PUBLISH_COMMAND;
+
+  si91x_publish_request->dup      = message->is_duplicate_message;
+  si91x_publish_request->qos      = (uint8_t)(message->qos_level);
+  si91x_publish_request->retained = message->is_retained;
+
+  si91x_publish_request->topic_len = (uint8_t)(message->topic_length);    // Narrowing of variable
+  si91x_publish_request->msg_len   = (uint16_t)(message->content_length); // Narrowing of variable
+
+  si91x_publish_request->msg = (int8_t *)si91x_publish_request + sizeof(si91x_mqtt_client_publish_request_t);
+  memcpy(si91x_publish_request->topic, message->topic, message->topic_length);
+  memcpy(si91x_publish_request->msg, message->content, message->content_length);
+
+  return sl_si91x_driver_send_command_buffer(RSI_WLAN_REQ_EMB_MQTT_CLIENT,
+                                             SI91X_NETWORK_CMD_QUEUE,
+                                             buffer,
+                                             wait_period,
+                                             sdk_context,
+                                             NULL);
+}
+
 static inline bool is_connect_previously_called(const sl_mqtt_client_t *client)
 {
   return (NULL != client->client_configuration);
@@ -361,6 +756,14 @@ sl_status_t sl_mqtt_client_init(sl_mqtt_client_t *client, sl_mqtt_client_event_h
   client->client_event_handler = event_handler;
   sl_slist_init((sl_slist_node_t **)&client->subscription_list_head);
 
+  if (publish_window_semaphore == NULL) {
+    publish_window_semaphore =
+      osSemaphoreNew(SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE, SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE, NULL);
+    if (publish_window_semaphore == NULL) {
+      return SL_STATUS_ALLOCATION_FAILED;
+    }
+  }
+
   mqtt_client = client;
   return SL_STATUS_OK;
 }
@@ -573,12 +976,7 @@ sl_status_t sl_mqtt_client_publish(sl_mqtt_client_t *client,
 
   sl_status_t status;
   sl_si91x_mqtt_client_context_t *sdk_context = NULL;
-  uint32_t publish_request_size               = sizeof(si91x_mqtt_client_publish_request_t) + message->content_length;
 
-  si91x_mqtt_client_publish_request_t *si91x_publish_request = calloc(publish_request_size, 1);
-  if (si91x_publish_request == NULL) {
-    return SL_STATUS_ALLOCATION_FAILED;
-  }
   status = sli_si91x_build_mqtt_sdk_context_if_async(SL_MQTT_CLIENT_MESSAGE_PUBLISHED_EVENT,
                                                      client,
                                                      context,
@@ -587,31 +985,12 @@ sl_status_t sl_mqtt_client_publish(sl_mqtt_client_t *client,
                                                      &sdk_context);
 
   if (status != SL_STATUS_OK) {
-    SL_CLEANUP_MALLOC(si91x_publish_request);
     return SL_STATUS_ALLOCATION_FAILED;
   }
 
-  si91x_publish_request->command_type = SI91X_MQTT_CLIENT_PUBLISH_COMMAND;
-
-  si91x_publish_request->dup      = message->is_duplicate_message;
-  si91x_publish_request->qos      = (uint8_t)(message->qos_level);
-  si91x_publish_request->retained = message->is_retained;
-
-  si91x_publish_request->topic_len = (uint8_t)(message->topic_length);    // Narrowing of variable
-  si91x_publish_request->msg_len   = (uint16_t)(message->content_length); // Narrowing of variable
-
-  si91x_publish_request->msg = (int8_t *)si91x_publish_request + sizeof(si91x_mqtt_client_publish_request_t);
-  memcpy(si91x_publish_request->topic, message->topic, message->topic_length);
-  memcpy(si91x_publish_request->msg, message->content, message->content_length);
-
-  status = sl_si91x_driver_send_command(RSI_WLAN_REQ_EMB_MQTT_CLIENT,
-                                        SI91X_NETWORK_CMD_QUEUE,
-                                        si91x_publish_request,
-                                        publish_request_size,
-                                        timeout <= 0 ? SL_SI91X_RETURN_IMMEDIATELY : SL_SI91X_WAIT_FOR(timeout),
-                                        sdk_context,
-                                        NULL);
-  free(si91x_publish_request);
+  status = sli_si91x_send_publish_request(message,
+                                          timeout <= 0 ? SL_SI91X_RETURN_IMMEDIATELY : SL_SI91X_WAIT_FOR(timeout),
+                                          sdk_context);
 
   if (status == SL_STATUS_IN_PROGRESS) {
     return status;
@@ -623,6 +1002,56 @@ sl_status_t sl_mqtt_client_publish(sl_mqtt_client_t *client,
   return status;
 }
 
+sl_status_t sl_mqtt_client_publish_pipelined(sl_mqtt_client_t *client,
+                                             const sl_mqtt_client_message_t *message,
+                                             uint32_t timeout,
+                                             sl_mqtt_client_publish_complete_t complete_handler,
+                                             void *context)
+{
+  SL_VERIFY_POINTER_OR_RETURN(client, SL_STATUS_WIFI_NULL_PTR_ARG);
+  SL_VERIFY_POINTER_OR_RETURN(message, SL_STATUS_WIFI_NULL_PTR_ARG);
+
+  VERIFY_AND_RETURN_ERROR_IF_FALSE(client->state == SL_MQTT_CLIENT_CONNECTED, SL_STATUS_INVALID_STATE);
+
+  if (message->topic_length >= SI91X_MQTT_CLIENT_TOPIC_MAXIMUM_LENGTH) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  sl_status_t status;
+  sli_si91x_mqtt_publish_slot_t *slot = NULL;
+
+  // Wait for one of the publishes in the window to complete
+  if (osSemaphoreAcquire(publish_window_semaphore, timeout) != osOK) {
+    return SL_STATUS_TIMEOUT;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  for (uint32_t index = 0; index < SL_MQTT_CLIENT_PUBLISH_WINDOW_SIZE; index++) {
+    if (!publish_window[index].in_use) {
+      slot         = &publish_window[index];
+      slot->in_use = true;
+      break;
+    }
+  }
+  CORE_EXIT_CRITICAL();
+
+  // The semaphore counts the free slots, so one is always found
+  slot->sdk_context.event        = SL_MQTT_CLIENT_MESSAGE_PUBLISHED_EVENT;
+  slot->sdk_context.client       = client;
+  slot->sdk_context.user_context = context;
+  slot->sdk_context.sdk_data     = NULL;
+  slot->complete_handler         = complete_handler;
+
+  status = sli_si91x_send_publish_request(message, SL_SI91X_RETURN_IMMEDIATELY, &slot->sdk_context);
+  if (status != SL_STATUS_IN_PROGRESS) {
+    slot->in_use = false;
+    osSemaphoreRelease(publish_window_semaphore);
+  }
+
+  return status;
+}
+
 sl_status_t sl_mqtt_client_subscribe(sl_mqtt_client_t *client,
                                      const uint8_t *topic,
                                      uint16_t topic_length,
@@ -655,7 +1084,8 @@ sl_status_t sl_mqtt_client_subscribe(sl_mqtt_client_t *client,
                                                      timeout,
                                                      &sdk_context);
 
-  if (subscription == NULL || status != SL_STATUS_OK) {
+  if (subscription == NULL || status != SL_STATUS_OK
+      || sli_si91x_reserve_subscription(client, topic, topic_length) != SL_STATUS_OK) {
     SL_CLEANUP_MALLOC(subscription);
     SL_CLEANUP_MALLOC(sdk_context);
 
@@ -685,12 +1115,16 @@ sl_status_t sl_mqtt_client_subscribe(sl_mqtt_client_t *client,
     return status;
   } else if (status != SL_STATUS_OK) {
 
+    sli_si91x_cancel_subscription(client, subscription);
     free(subscription);
     SL_CLEANUP_MALLOC(sdk_context);
     return status;
   }
 
-  sl_slist_push((sl_slist_node_t **)&client->subscription_list_head, (sl_slist_node_t *)subscription);
+  status = sli_si91x_add_subscription(client, subscription);
+  if (status != SL_STATUS_OK) {
+    free(subscription);
+  }
   return status;
 }
 
@@ -712,9 +1146,7 @@ sl_status_t sl_mqtt_client_unsubscribe(sl_mqtt_client_t *client,
   sl_status_t status;
   sl_si91x_mqtt_client_context_t *sdk_context                       = NULL;
   si91x_mqtt_client_unsubscribe_request_t si91x_unsubscribe_request = { 0 };
-  sl_mqtt_client_topic_subscription_info_t *subscription;
-
-  sli_si91x_get_subscription(client, topic, topic_length, &subscription);
+  sl_mqtt_client_topic_subscription_info_t *subscription = sli_si91x_get_subscription(client, topic, topic_length);
 
   status = sli_si91x_build_mqtt_sdk_context_if_async(SL_MQTT_CLIENT_UNSUBSCRIBED_EVENT,
                                                      client,
@@ -745,8 +1177,7 @@ sl_status_t sl_mqtt_client_unsubscribe(sl_mqtt_client_t *client,
   }
 
   if (subscription != NULL) {
-    sl_slist_remove((sl_slist_node_t **)&client->subscription_list_head, (sl_slist_node_t *)subscription);
-    free(subscription);
+    sli_si91x_remove_subscription(client, subscription);
   }
 
   return status;
@@ -816,6 +1247,9 @@ static uint8_t sli_si91x_mqtt_identification_function(sl_wifi_buffer_t *buffer,
   if (!is_async_request) {
     sl_si91x_host_add_to_queue(SI91X_NETWORK_RESPONSE_QUEUE, response_buffer);
     sl_si91x_host_set_event(NCP_HOST_NETWORK_RESPONSE_EVENT);
+  } else if (sli_si91x_is_publish_window_context(node->sdk_context)) {
+    // A pipelined publish that never reached the broker still completes, so that its slot is returned to the window
+    sli_si91x_complete_publish(node->sdk_context, SL_STATUS_ABORT);
   }
 
   return true;
@@ -825,6 +1259,12 @@ sl_status_t sli_si91x_mqtt_event_handler(sl_status_t status,
                                          sl_si91x_mqtt_client_context_t *sdk_context,
                                          sl_si91x_packet_t *rx_packet)
 {
+  // Pipelined publishes report to their own complete handler and keep their context in the publish window
+  if (sli_si91x_is_publish_window_context(sdk_context)) {
+    sli_si91x_complete_publish(sdk_context, status);
+    return SL_STATUS_OK;
+  }
+
   sl_mqtt_client_error_status_t error_status = sli_si91x_get_event_error_status(sdk_context->event);
 
   bool is_error_event                          = false;
@@ -858,14 +1298,17 @@ sl_status_t sli_si91x_mqtt_event_handler(sl_status_t status,
     case SL_MQTT_CLIENT_SUBSCRIBED_EVENT: {
       if (status != SL_STATUS_OK) {
         // Free subscription passed in subscribe() call if subscription call failed.
+        sli_si91x_cancel_subscription(sdk_context->client, sdk_context->sdk_data);
         free(sdk_context->sdk_data);
         is_error_event = true;
         break;
       }
 
       // As subscription is success, add the subscription to list.
-      sl_slist_push((sl_slist_node_t **)&sdk_context->client->subscription_list_head,
-                    (sl_slist_node_t *)sdk_context->sdk_data);
+      if (sli_si91x_add_subscription(sdk_context->client, sdk_context->sdk_data) != SL_STATUS_OK) {
+        free(sdk_context->sdk_data);
+        is_error_event = true;
+      }
       break;
     }
 
@@ -876,16 +1319,15 @@ sl_status_t sli_si91x_mqtt_event_handler(sl_status_t status,
       }
 
       // Free subscription if the unsubscription API call is successful.
-      sl_slist_remove((sl_slist_node_t **)&sdk_context->client->subscription_list_head,
-                      (sl_slist_node_t *)sdk_context->sdk_data);
-      free(sdk_context->sdk_data);
+      if (sdk_context->sdk_data != NULL) {
+        sli_si91x_remove_subscription(sdk_context->client, sdk_context->sdk_data);
+      }
       break;
     }
 
     case SL_MQTT_CLIENT_MESSAGED_RECEIVED_EVENT: {
       // Extract the MQTT message from payload and create sl_mqtt_message
       sl_mqtt_client_message_t received_message;
-      sl_mqtt_client_topic_subscription_info_t *subscription;
 
       si91x_mqtt_client_received_message *si91x_message = (si91x_mqtt_client_received_message *)rx_packet->data;
 
@@ -907,15 +1349,9 @@ sl_status_t sli_si91x_mqtt_event_handler(sl_status_t status,
       // Use the SI91X_MQTT_CHECK_IS_DUPLICATE_MESSAGE macro to extract the third bit and determine if the message is a duplicate
       received_message.is_duplicate_message = si91x_message->mqtt_flags & SI91X_MQTT_CHECK_IS_DUPLICATE_MESSAGE;
 
-      sli_si91x_get_subscription(sdk_context->client,
-                                 received_message.topic,
-                                 received_message.topic_length,
-                                 &subscription);
-
-      if (subscription == NULL) {
+      // Every subscription whose topic filter matches the topic receives the message
+      if (sli_si91x_dispatch_message(sdk_context->client, &received_message, sdk_context->user_context) == 0) {
         SL_DEBUG_LOG("Unable to find subscription: Dropping MQTT message handling");
-      } else {
-        subscription->topic_message_handler(sdk_context->client, &received_message, sdk_context->user_context);
       }
 
       free(sdk_context);
@@ -15,6 +15,8 @@
 #include "lwip/ethip6.h"
 #include "lwip/ip6_addr.h"
 #include "lwip/timeouts.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
 #include "cmsis_os2.h"
 #include "sl_si91x_host_interface.h"
 #include "sl_wifi.h"
@@ -24,6 +26,7 @@
 #include "sl_net.h"
 #include <string.h>
 #include "sl_rsi_utility.h"
+#include "sl_si91x_driver.h"
 
 #define NETIF_IPV4_ADDRESS(X, Y) (uint8_t)(((X) >> (8 * Y)) & 0xFF)
 #define MAC_48_BIT_SET           (1)
@@ -34,15 +37,69 @@
 #define MAX_TRANSFER_UNIT        1500
 #define get_netif(i)             ((i & SL_WIFI_CLIENT_INTERFACE) ? &wifi_client_context->netif : &wifi_ap_context->netif)
 
+// Smallest RX buffer quota the driver accepts, see sl_wifi_buffer_configuration_t
+#define SL_NET_LWIP_MIN_RX_BUFFER_QUOTA 10
+// RX buffers kept free of zero-copy frames for command responses and bus reads
+#define SL_NET_LWIP_RX_QUOTA_RESERVE 4
+
+// Number of received frames that lwIP can hold on to without copying them out of the driver RX buffer.
+// Frames received while all of them are in use are copied into the lwIP pbuf pool instead.
+// These frames count against the driver RX buffer quota, which command responses share, so keep this small.
+#ifndef SL_NET_LWIP_ZERO_COPY_RX_FRAMES
+#define SL_NET_LWIP_ZERO_COPY_RX_FRAMES 4
+#endif
+
+#if SL_NET_LWIP_ZERO_COPY_RX_FRAMES > (SL_NET_LWIP_MIN_RX_BUFFER_QUOTA - SL_NET_LWIP_RX_QUOTA_RESERVE)
+#error "SL_NET_LWIP_ZERO_COPY_RX_FRAMES must leave room in the driver RX buffer quota for command responses"
+#endif
+
+#if LWIP_SUPPORT_CUSTOM_PBUF
+// pbuf referencing a frame in a driver RX buffer, which is returned to the driver when lwIP frees the pbuf
+typedef struct {
+  struct pbuf_custom pbuf;
+  sl_wifi_buffer_t *buffer;
+} sl_net_lwip_rx_pbuf_t;
+
+LWIP_MEMPOOL_DECLARE(SL_NET_LWIP_RX_PBUF,
+                     SL_NET_LWIP_ZERO_COPY_RX_FRAMES,
+                     sizeof(sl_net_lwip_rx_pbuf_t),
+                     "Zero-copy RX pbufs")
+#endif
+
 sl_net_wifi_lwip_context_t *wifi_client_context = NULL;
 sl_net_wifi_lwip_context_t *wifi_ap_context     = NULL;
 uint32_t gOverrunCount                          = 0;
 
 extern sys_thread_t lwip_thread;
+extern bool device_initialized;
 
 /******************************************************************************
                                 Static Functions
 ******************************************************************************/
+#if LWIP_SUPPORT_CUSTOM_PBUF
+static void rx_pbuf_free(struct pbuf *p)
+{
+  sl_net_lwip_rx_pbuf_t *rx_pbuf = (sl_net_lwip_rx_pbuf_t *)p;
+
+  sl_si91x_host_free_buffer(rx_pbuf->buffer);
+  LWIP_MEMPOOL_FREE(SL_NET_LWIP_RX_PBUF, rx_pbuf);
+}
+
+// Wraps a frame in its driver RX buffer into a pbuf, returns NULL if no zero-copy pbuf is free
+static struct pbuf *rx_pbuf_alloc(sl_wifi_buffer_t *buffer, uint8_t *b, uint16_t len)
+{
+  sl_net_lwip_rx_pbuf_t *rx_pbuf = (sl_net_lwip_rx_pbuf_t *)LWIP_MEMPOOL_ALLOC(SL_NET_LWIP_RX_PBUF);
+
+  if (rx_pbuf == NULL) {
+    return STRUCT_PBUF;
+  }
+  rx_pbuf->buffer                    = buffer;
+  rx_pbuf->pbuf.custom_free_function = rx_pbuf_free;
+
+  return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx_pbuf->pbuf, b, len);
+}
+#endif
+
 static void low_level_init(struct netif *netif)
 {
   uint32_t status = 0;
@@ -80,17 +137,15 @@ static void low_level_init(struct netif *netif)
 #endif /* LWIP_IPV6_MLD */
 }
 
-static void low_level_input(struct netif *netif, uint8_t *b, uint16_t len)
+static sl_status_t low_level_input(struct netif *netif, sl_wifi_buffer_t *buffer, uint8_t *b, uint16_t len)
 {
-  struct pbuf *p, *q;
+  struct pbuf *p = STRUCT_PBUF;
+  struct pbuf *q;
   uint32_t bufferoffset;
+  bool is_zero_copy = false;
 
   if (len <= 0) {
-    return;
-  }
-
-  if (len < LWIP_FRAME_ALIGNMENT) { /* 60 : LWIP frame alignment */
-    len = LWIP_FRAME_ALIGNMENT;
+    return SL_STATUS_OK;
   }
 
   // Drop packets originated from the same interface and is not destined for the said interface
@@ -117,22 +172,40 @@ static void low_level_input(struct netif *netif, uint8_t *b, uint16_t len)
                  src_mac[5],
                  b[12],
                  b[13]);
-    return;
+    return SL_STATUS_OK;
+  }
+#endif
+
+#if LWIP_SUPPORT_CUSTOM_PBUF
+  /* Frames of at least the minimum length are handed to lwIP in the driver RX buffer itself,
+   * which lwIP returns to the driver when it frees the pbuf
+   */
+  if (len >= LWIP_FRAME_ALIGNMENT) {
+    p            = rx_pbuf_alloc(buffer, b, len);
+    is_zero_copy = (p != STRUCT_PBUF);
   }
+#else
+  UNUSED_PARAMETER(buffer);
 #endif
 
-  /* We allocate a pbuf chain of pbufs from the Lwip buffer pool
+  if (len < LWIP_FRAME_ALIGNMENT) { /* 60 : LWIP frame alignment */
+    len = LWIP_FRAME_ALIGNMENT;
+  }
+
+  /* Otherwise we allocate a pbuf chain of pbufs from the Lwip buffer pool
    * and copy the data to the pbuf chain
    */
-  if ((p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL)) != STRUCT_PBUF) {
+  if ((p == STRUCT_PBUF) && ((p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL)) != STRUCT_PBUF)) {
     for (q = p, bufferoffset = 0; q != NULL; q = q->next) {
       memcpy((uint8_t *)q->payload, (uint8_t *)b + bufferoffset, q->len);
       bufferoffset += q->len;
     }
+  }
 
+  if (p != STRUCT_PBUF) {
     SL_DEBUG_LOG("%s: ACCEPT %d, [%02x:%02x:%02x:%02x:%02x:%02x]<-[%02x:%02x:%02x:%02x:%02x:%02x] type=%02x%02x",
                  __func__,
-                 bufferoffset,
+                 p->tot_len,
                  dst_mac[0],
                  dst_mac[1],
                  dst_mac[2],
@@ -150,21 +223,35 @@ static void low_level_input(struct netif *netif, uint8_t *b, uint16_t len)
 
     if (netif->input(p, netif) != ERR_OK) {
       gOverrunCount++;
+      // Freeing a zero-copy pbuf also frees the driver RX buffer
       pbuf_free(p);
     }
   } else {
     gOverrunCount++;
   }
 
-  return;
+  return is_zero_copy ? SL_STATUS_IN_PROGRESS : SL_STATUS_OK;
 }
 
 static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
   UNUSED_PARAMETER(netif);
   sl_status_t status;
+  sl_wifi_buffer_t *buffer;
+  void *frame;
+
+  if (!device_initialized || !sl_wifi_is_interface_up(SL_WIFI_CLIENT_INTERFACE) || (p->tot_len == 0)) {
+    return ERR_IF;
+  }
 
-  status = sl_wifi_send_raw_data_frame(SL_WIFI_CLIENT_INTERFACE, (uint8_t *)p->payload, p->len);
+  // Gather the whole pbuf chain straight into the driver TX buffer, so lwIP never has to linearize a frame
+  status = sl_si91x_driver_allocate_raw_buffer(RSI_SEND_RAW_DATA, p->tot_len, &buffer, &frame);
+  if (status != SL_STATUS_OK) {
+    return ERR_MEM;
+  }
+  pbuf_copy_partial(p, frame, p->tot_len, 0);
+
+  status = sl_si91x_driver_send_raw_buffer(buffer);
   if (status != SL_STATUS_OK) {
     return ERR_IF;
   }
@@ -342,6 +429,9 @@ sl_status_t sl_net_wifi_client_init(sl_net_interface_t interface,
   }
   wifi_client_context = context;
   tcpip_init(NULL, NULL);
+#if LWIP_SUPPORT_CUSTOM_PBUF
+  LWIP_MEMPOOL_INIT(SL_NET_LWIP_RX_PBUF);
+#endif
   sta_netif_config();
   return SL_STATUS_OK;
 }
@@ -429,7 +519,7 @@ sl_status_t sl_si91x_host_process_data_frame(sl_wifi_interface_t interface, sl_w
    * and forward the received frame buffer to LWIP
    */
   if ((ifp = get_netif(interface)) != NULL) {
-    low_level_input(ifp, rsi_pkt->data, rsi_pkt->length);
+    return low_level_input(ifp, buffer, rsi_pkt->data, rsi_pkt->length);
   }
 
   return SL_STATUS_OK;
@@ -67,6 +67,10 @@ sl_status_t sl_http_server_deinit(sl_http_server_t *handle);
  * @brief
  *   Spawns a new thread and starts accepting requests on the configured HTTP port.
  *   The HTTP request handlers are invoked from this thread.
+ * @note
+ *   If max_clients in @ref sl_http_server_config_t is greater than 1, up to max_clients connections are served
+ *   concurrently and the request handlers are invoked from a pool of worker_count threads instead. Each connection
+ *   is then represented by its own handle, which is the one passed to the request handlers.
  * @pre Pre-conditions:
  * - The HTTP server handle should be initialized using @ref sl_http_server_init before calling this API.
  * @param[in] handle
@@ -91,7 +95,8 @@ sl_status_t sl_http_server_stop(sl_http_server_t *handle);
 /***************************************************************************/ /**
  * @brief
  *   Retrieves the headers from an HTTP request.
- *   This function extracts all headers from a given HTTP request and stores them in the provided headers array.
+ *   This function copies the headers recorded while the request was parsed, up to @ref SL_HTTP_SERVER_MAX_REQUEST_HEADERS,
+ *   to the provided headers array. It can be called any number of times from the request handler.
  * @param[in] handle
  *   HTTP server handle of type @ref sl_http_server_t.
  * @param[in] request
@@ -113,7 +118,8 @@ sl_status_t sl_http_server_get_request_headers(sl_http_server_t *handle,
  * @brief
  *   Reads the HTTP request data being received after the headers.
  * @pre Pre-conditions:
- * - This API can only be called if req_data_length parameter in @ref sl_http_server_request_t is greater than 0.
+ * - This API can only be called if req_data_length parameter in @ref sl_http_server_request_t is greater than 0, or if
+ *   is_chunked is set. Chunked request data is decoded, and the end of the data is reached once no data is returned.
  * - This API can only be called from with in the request handler of corresponding request.
  * @param[in] handle
  *   HTTP server handle of type @ref sl_http_server_t
@@ -156,6 +162,57 @@ sl_status_t sl_http_server_send_response(sl_http_server_t *handle, sl_http_serve
  *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
  */
 sl_status_t sl_http_server_write_data(sl_http_server_t *handle, uint8_t *data, uint32_t data_length);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Makes the HTTP server send the response to the current request, streaming the body from the given source.
+ *   This API can be used instead of @ref sl_http_server_send_response when the body is not held in RAM, for example
+ *   when it is a constant in flash, a file or generated on the fly. It returns once the whole response is sent.
+ * @note
+ *   The data and length fields of the response are ignored. A body of unknown length is sent with the chunked
+ *   transfer coding, or to HTTP/1.0 clients by closing the connection after it. If the body has an entity tag that
+ *   matches an If-None-Match header of the request, a 304 response without body is sent instead. A gzip encoded
+ *   body is sent with the Content-Encoding and Vary headers.
+ * @pre Pre-conditions:
+ * - This API can only be called once per request, from the request handler of the corresponding request.
+ * @param[in] handle
+ *   HTTP server handle of type @ref sl_http_server_t
+ * @param[in] response
+ *   Pointer to the response of type @ref sl_http_server_response_t
+ * @param[in] body
+ *   Pointer to the body source of type @ref sl_http_server_body_t
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ */
+sl_status_t sl_http_server_send_response_body(sl_http_server_t *handle,
+                                              sl_http_server_response_t *response,
+                                              const sl_http_server_body_t *body);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Makes the HTTP server send a static asset as the response to the current request.
+ *   The gzip compressed asset is sent if the client accepts it or if it is the only one available, the uncompressed
+ *   asset otherwise. Requests that already hold the entity tag of the asset get a 304 response.
+ * @pre Pre-conditions:
+ * - This API can only be called once per request, from the request handler of the corresponding request.
+ * @param[in] handle
+ *   HTTP server handle of type @ref sl_http_server_t
+ * @param[in] asset
+ *   Pointer to the asset of type @ref sl_http_server_static_asset_t
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ */
+sl_status_t sl_http_server_send_static_asset(sl_http_server_t *handle, const sl_http_server_static_asset_t *asset);
+
+/***************************************************************************/ /**
+ * @brief
+ *   Checks whether the client accepts gzip compressed responses to the current request.
+ * @param[in] handle
+ *   HTTP server handle of type @ref sl_http_server_t
+ * @return
+ *   true if the Accept-Encoding header of the request allows the gzip content coding, false otherwise.
+ */
+bool sl_http_server_request_accepts_gzip(const sl_http_server_t *handle);
 /** @} */
 
 #endif //SL_HTTP_SERVER_H
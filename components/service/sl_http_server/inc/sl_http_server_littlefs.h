@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * # License
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef SL_HTTP_SERVER_LITTLEFS_H
+#define SL_HTTP_SERVER_LITTLEFS_H
+
+#include "sl_http_server.h"
+#include "lfs.h"
+
+/**
+ *  @addtogroup SERVICE_HTTP_SERVER_CONSTANTS
+ *  @{
+ */
+
+#ifndef SL_HTTP_SERVER_LITTLEFS_PATH_MAX
+/// Maximum length of the path of a file served by @ref sl_http_server_send_littlefs_file, including the ".gz" suffix of its compressed variant.
+#define SL_HTTP_SERVER_LITTLEFS_PATH_MAX 64
+#endif
+
+/** @} */
+
+/**
+ * @addtogroup SERVICE_HTTP_SERVER_FUNCTIONS
+ * @{
+ */
+
+/***************************************************************************/ /**
+ * @brief
+ *   Makes the HTTP server send a littlefs file as the response to the current request.
+ *   The file is streamed through the response buffer of the handle, so its size is not limited by the available RAM.
+ *   If the client accepts gzip and a file with the same path and a ".gz" suffix exists, that file is sent instead
+ *   with the gzip content coding.
+ * @pre Pre-conditions:
+ * - This API can only be called once per request, from the request handler of the corresponding request.
+ * - In concurrent mode the file system must be configured for access from several threads.
+ * @param[in] handle
+ *   HTTP server handle of type @ref sl_http_server_t
+ * @param[in] response
+ *   Pointer to the response of type @ref sl_http_server_response_t. Its data and length fields are ignored.
+ * @param[in] lfs
+ *   Mounted littlefs file system.
+ * @param[in] path
+ *   Path of the file.
+ * @param[in] etag
+ *   Entity tag of the file including its quotes, or NULL. Requests that already hold it get a 304 response.
+ * @return
+ *   sl_status_t. See https://docs.silabs.com/gecko-platform/4.1/common/api/group-status for details.
+ *   SL_STATUS_NOT_FOUND is returned, and no response is sent, if the file does not exist.
+ */
+sl_status_t sl_http_server_send_littlefs_file(sl_http_server_t *handle,
+                                              sl_http_server_response_t *response,
+                                              lfs_t *lfs,
+                                              const char *path,
+                                              const char *etag);
+/** @} */
+
+#endif //SL_HTTP_SERVER_LITTLEFS_H
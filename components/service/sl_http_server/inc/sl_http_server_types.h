@@ -68,6 +68,47 @@
 /// Maximum length of the header buffer.
 #define MAX_HEADER_BUFFER_LENGTH 1024
 
+#ifndef SL_HTTP_SERVER_MAX_CLIENTS
+/// Upper bound on concurrent client connections accepted by a single HTTP server instance.
+#define SL_HTTP_SERVER_MAX_CLIENTS 4
+#endif
+
+#ifndef SL_HTTP_SERVER_MAX_WORKERS
+/// Upper bound on worker threads used to run request handlers in concurrent mode.
+#define SL_HTTP_SERVER_MAX_WORKERS 4
+#endif
+
+#ifndef SL_HTTP_SERVER_WORKER_STACK_SIZE
+/// Stack size in bytes of each HTTP server worker thread.
+#define SL_HTTP_SERVER_WORKER_STACK_SIZE 2048
+#endif
+
+#ifndef SL_HTTP_SERVER_SELECT_TIMEOUT_MS
+/// Interval in milliseconds after which idle keep-alive connections are re-polled in concurrent mode.
+#define SL_HTTP_SERVER_SELECT_TIMEOUT_MS 50
+#endif
+
+#ifndef SL_HTTP_SERVER_MAX_REQUEST_HEADERS
+/// Number of request headers recorded by the parser and returned by @ref sl_http_server_get_request_headers.
+#define SL_HTTP_SERVER_MAX_REQUEST_HEADERS 16
+#endif
+
+#ifndef SL_HTTP_SERVER_ROUTE_TABLE_SIZE
+/// Number of slots of the hash table indexing the exact-match request handlers. Must be a power of two.
+#define SL_HTTP_SERVER_ROUTE_TABLE_SIZE 32
+#endif
+
+/// Bit of a request type in the methods mask of @ref sl_http_server_handler_t.
+#define SL_HTTP_REQUEST_METHOD(type) (1U << (type))
+
+#ifndef SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH
+/// Size in bytes of the buffer in which response headers and produced body data are gathered before being sent.
+#define SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH 512
+#endif
+
+/// Length of a @ref sl_http_server_body_t produced by a callback that is not known in advance. The body is then sent with the chunked transfer coding.
+#define SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN 0xFFFFFFFFUL
+
 /******************************************************
  *                   Enumerations
  ******************************************************/
@@ -78,6 +119,7 @@
  */
 typedef enum {
   SL_HTTP_RESPONSE_OK                         = 200, ///< Success response code
+  SL_HTTP_RESPONSE_NOT_MODIFIED               = 304, ///< Not modified response code
   SL_HTTP_RESPONSE_BAD_REQUEST                = 400, ///< Bad request response code
   SL_HTTP_RESPONSE_UNAUTHORIZED               = 401, ///< Unauthorized response code
   SL_HTTP_RESPONSE_FORBIDDEN                  = 403, ///< Forbidden response code
@@ -136,6 +178,21 @@ typedef struct sl_http_server_request_s sl_http_server_request_t;
  ******************************************************************************/
 typedef sl_status_t (*sl_http_request_handler_t)(sl_http_server_t *handle, sl_http_server_request_t *request);
 
+/**
+ * @typedef sl_http_server_body_read_t
+ * @brief
+ *    Callback invoked to produce the next part of a response body of type @ref SL_HTTP_SERVER_BODY_CALLBACK.
+ * @param[in] context
+ *    Context given in @ref sl_http_server_body_t
+ * @param[out] buffer
+ *    Buffer to write the body data to.
+ * @param[in] buffer_length
+ *    Size of the buffer. It is never larger than the part of the body that remains to be sent.
+ * @return
+ *    Number of bytes written to the buffer, 0 once the body is complete, or a negative value to abort the response.
+ ******************************************************************************/
+typedef int32_t (*sl_http_server_body_read_t)(void *context, uint8_t *buffer, uint32_t buffer_length);
+
 /******************************************************
  *                    Structures
  ******************************************************/
@@ -157,6 +214,35 @@ typedef struct {
   uint32_t expected_data_length;         ///< Total length of the data to be sent in response
 } sl_http_server_response_t;
 
+/// HTTP server response body sources
+typedef enum {
+  SL_HTTP_SERVER_BODY_MEMORY,  ///< Body held in RAM or in flash, sent from where it is stored without being copied
+  SL_HTTP_SERVER_BODY_CALLBACK ///< Body produced piecewise by a read callback, for example from a file
+} sl_http_server_body_type_t;
+
+/// HTTP server response body streamed by @ref sl_http_server_send_response_body
+typedef struct {
+  sl_http_server_body_type_t type; ///< Source of the body
+  const uint8_t *data;             ///< Body data of an @ref SL_HTTP_SERVER_BODY_MEMORY body
+  sl_http_server_body_read_t read; ///< Read callback of an @ref SL_HTTP_SERVER_BODY_CALLBACK body
+  void *context;                   ///< Context passed to the read callback
+  uint32_t length;                 ///< Length of the body, or @ref SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN for a callback body
+  const char *etag;                ///< Entity tag of the body including its quotes, or NULL. Matching If-None-Match requests get a 304 response.
+  bool gzip_encoded;               ///< The body is gzip compressed; Content-Encoding is set accordingly
+} sl_http_server_body_t;
+
+/// Static asset served by @ref sl_http_server_send_static_asset, typically a constant in flash
+typedef struct {
+  const char *content_type;  ///< Content type of the asset
+  const uint8_t *data;       ///< Uncompressed asset, or NULL if only the gzip compressed asset is available
+  uint32_t length;           ///< Length of the uncompressed asset
+  const uint8_t *gzip_data;  ///< Gzip compressed asset, or NULL
+  uint32_t gzip_length;      ///< Length of the gzip compressed asset
+  const char *etag;          ///< Entity tag of the asset including its quotes, or NULL. Both encodings share it, so a weak tag (W/"...") should be used when both are given.
+  sl_http_header_t *headers; ///< Additional response headers such as Cache-Control, or NULL
+  uint16_t header_count;     ///< Length of header array
+} sl_http_server_static_asset_t;
+
 /// HTTP server uri query parametrs
 typedef struct {
   char *query; ///< URI path
@@ -177,12 +263,15 @@ typedef struct sl_http_server_request_s {
   uint16_t request_header_count;      ///< Number of request headers received
   sl_http_server_request_type_t type; ///< Type of the request (GET, POST, etc.)
   uint32_t request_data_length;       ///< Length of the request data
+  bool is_chunked; ///< Request data uses chunked transfer coding. request_data_length is 0 and the data is read until @ref sl_http_server_read_request_data returns no data.
 } sl_http_server_request_t;
 
 /// HTTP server expected request handling parameters
 typedef struct {
   char *uri;                         ///< URI pattern to match the request
   sl_http_request_handler_t handler; ///< Request handler function
+  uint8_t methods; ///< Mask of @ref SL_HTTP_REQUEST_METHOD bits of the request types handled. 0 handles every request type.
+  bool prefix; ///< Handle every URI that starts with uri. The longest matching prefix wins; exact matches take precedence.
 } sl_http_server_handler_t;
 
 /// HTTP server configuration
@@ -192,6 +281,9 @@ typedef struct {
   uint16_t handlers_count;                   ///< Length of request handlers array
   sl_http_request_handler_t default_handler; ///< Default handler
   uint16_t client_idle_time;                 ///< Idle duration in seconds before the client is considered inactive.
+  uint8_t max_clients; ///< Number of concurrent client connections, capped at @ref SL_HTTP_SERVER_MAX_CLIENTS. 0 or 1 serves one client at a time.
+  uint8_t worker_count; ///< Number of worker threads running request handlers when max_clients > 1, capped at @ref SL_HTTP_SERVER_MAX_WORKERS. 0 selects one worker.
+  uint16_t keep_alive_timeout; ///< Idle duration in seconds an HTTP/1.1 persistent connection is kept open between requests. 0 closes the connection after every response.
 } sl_http_server_config_t;
 
 /// HTTP server handle used to manage all HTTP server functions
@@ -203,11 +295,20 @@ typedef struct sl_http_server_s {
   sl_http_server_request_t request;              ///< Current HTTP request being processed.
   char request_buffer[MAX_HEADER_BUFFER_LENGTH]; ///< Buffer for storing the HTTP request.
   char *header;                                  ///< Pointer to string containing headers.
+  sl_http_header_t request_headers[SL_HTTP_SERVER_MAX_REQUEST_HEADERS]; ///< Headers of the current request, pointing into request_buffer.
   uint8_t *req_data;                             ///< Pointer to the data of the HTTP request.
   uint32_t data_length;                          ///< Length of the request data.
   uint32_t rem_len;                              ///< Remaining length of data to be processed in the request.
   bool response_sent;       ///< Flag indicating whether the response has been sent for the current request.
   uint32_t rem_resp_length; ///< Remaining length of data to be sent in the response.
+  uint8_t response_buffer[SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH]; ///< Buffer in which the response is gathered before being sent.
+  bool keep_alive;          ///< Flag indicating whether the connection is kept open after the current response.
+  uint8_t chunk_state;      ///< Decoder state of a chunked request body.
+  uint32_t chunk_length;    ///< Bytes left in the current chunk of a chunked request body.
+  uint16_t route_table[SL_HTTP_SERVER_ROUTE_TABLE_SIZE]; ///< Exact-match handlers by URI hash, as index + 1. Built by @ref sl_http_server_init.
+  bool routes_indexed; ///< Every exact-match handler is in route_table.
+  struct sl_http_server_s *parent; ///< Owning server handle for per-connection handles in concurrent mode, NULL otherwise.
+  void *context;                   ///< Internal state of the concurrent mode, NULL otherwise.
 } sl_http_server_t;
 
 /// HTTP read data parameters
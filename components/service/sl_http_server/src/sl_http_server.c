@@ -34,12 +34,111 @@
 #define SL_HIGH_PERFORMANCE_SOCKET    BIT(7)
 #define HTTP_MAX_HEADER_LENGTH        (MAX_HEADER_BUFFER_LENGTH - 1)
 #define HTTP_CONNECTION_STATUS_HEADER "Connection: close\r\n"
+#define HTTP_CONNECTION_KEEP_ALIVE    "Connection: keep-alive\r\n"
+#define HTTP_SERVER_CLOSE_DELAY_MS    100 ///< Time given to the NWP to flush the response before the client socket is closed.
 
 #define HTTP_SERVER_START_SUCCESS   BIT(0)
 #define HTTP_SERVER_START_FAILED    BIT(1)
 #define HTTP_SERVER_STOP_CMD        BIT(2)
 #define HTTP_SERVER_EXIT            BIT(3)
 #define HTTP_SERVER_CONNECT_SUCCESS BIT(4)
+#define HTTP_SERVER_SELECT_DONE     BIT(5)
+#define HTTP_SERVER_SLOT_RELEASED   BIT(6)
+
+/******************************************************
+ *                   Type Definitions
+ ******************************************************/
+typedef enum {
+  SLI_HTTP_SERVER_SLOT_FREE,   ///< No client is attached to the slot
+  SLI_HTTP_SERVER_SLOT_IDLE,   ///< Persistent connection waiting for its next request
+  SLI_HTTP_SERVER_SLOT_BUSY,   ///< Connection owned by a worker thread
+  SLI_HTTP_SERVER_SLOT_CLOSING ///< Finished connection whose socket the server thread closes after the close delay
+} sli_http_server_slot_state_t;
+
+// Client slot used in concurrent mode. The embedded handle is passed to the request handlers.
+typedef struct {
+  sl_http_server_t connection;
+  volatile sli_http_server_slot_state_t state;
+  uint32_t last_activity;
+} sli_http_server_slot_t;
+
+// Concurrent mode state referenced from the context field of the server handle
+typedef struct {
+  sli_http_server_slot_t *slots;
+  uint8_t slot_count;
+  osMessageQueueId_t work_queue;
+  osSemaphoreId_t worker_exit;
+  uint8_t worker_count;
+} sli_http_server_pool_t;
+
+// Request parser states. The parser walks the request buffer once and resumes where it stopped when more data arrives.
+typedef enum {
+  SLI_HTTP_PARSE_METHOD,
+  SLI_HTTP_PARSE_PATH,
+  SLI_HTTP_PARSE_QUERY,
+  SLI_HTTP_PARSE_VERSION,
+  SLI_HTTP_PARSE_REQUEST_LINE_LF,
+  SLI_HTTP_PARSE_HEADER_START,
+  SLI_HTTP_PARSE_HEADER_NAME,
+  SLI_HTTP_PARSE_HEADER_VALUE_START,
+  SLI_HTTP_PARSE_HEADER_VALUE,
+  SLI_HTTP_PARSE_HEADER_LF,
+  SLI_HTTP_PARSE_HEADERS_END_LF,
+  SLI_HTTP_PARSE_DONE,
+  SLI_HTTP_PARSE_ERROR
+} sli_http_parse_state_t;
+
+typedef struct {
+  sli_http_parse_state_t state;
+  int position;       // Next byte of the request buffer to parse
+  int token;          // Start of the token being parsed
+  int value_end;      // End of the header value without trailing whitespace
+  char *header_name;  // Name of the header being parsed
+  bool query_active;  // The query parameter being parsed is stored in the request
+  uint32_t path_hash; // Hash of the URI path, used for the route lookup
+} sli_http_parser_t;
+
+// Decoder states of a chunked request body, kept in the chunk_state field of the handle
+typedef enum {
+  SLI_HTTP_CHUNK_SIZE,
+  SLI_HTTP_CHUNK_EXTENSION,
+  SLI_HTTP_CHUNK_SIZE_LF,
+  SLI_HTTP_CHUNK_DATA,
+  SLI_HTTP_CHUNK_DATA_CR,
+  SLI_HTTP_CHUNK_DATA_LF,
+  SLI_HTTP_CHUNK_TRAILER,
+  SLI_HTTP_CHUNK_TRAILER_LINE,
+  SLI_HTTP_CHUNK_END_LF,
+  SLI_HTTP_CHUNK_DONE,
+  SLI_HTTP_CHUNK_ERROR
+} sli_http_chunk_state_t;
+
+// How the end of a response body is delimited
+typedef enum {
+  SLI_HTTP_BODY_CONTENT_LENGTH, // Content-Length header
+  SLI_HTTP_BODY_CHUNKED,        // Chunked transfer coding
+  SLI_HTTP_BODY_CLOSE,          // Closing the connection, for HTTP/1.0 clients
+  SLI_HTTP_BODY_NONE            // The response never has a body, such as a 304 response
+} sli_http_body_framing_t;
+
+// Response being gathered in the response buffer of the handle, so that few and large sends carry it
+typedef struct {
+  sl_http_server_t *handle;
+  int window_size;    // Largest amount of data passed to a single send
+  uint32_t length;    // Bytes gathered in the response buffer
+  sl_status_t status; // SL_STATUS_FAIL once a send failed, the rest of the response is then dropped
+} sli_http_tx_t;
+
+// Chunk size lines are written with a fixed width in front of the chunk data, which is produced in place
+#define SLI_HTTP_CHUNK_SIZE_LINE_LENGTH 10
+
+#if SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH < 64
+#error "SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH must be at least 64 bytes"
+#endif
+
+// FNV-1a hash of URI paths, computed by the parser and when the route table is built
+#define SLI_HTTP_PATH_HASH_INIT 2166136261UL
+#define SLI_HTTP_PATH_HASH(hash, c) (((hash) ^ (uint8_t)(c)) * 16777619UL)
 
 /******************************************************
  *               Variable Definitions
@@ -48,6 +147,7 @@ static int server_socket               = -1;
 static int client_socket               = -1;
 static sl_http_server_t *server_handle = NULL;
 static osThreadId_t http_server_id     = NULL;
+static fd_set selected_fds;
 
 const osThreadAttr_t http_server_attributes = {
   .name       = "http_server",
@@ -61,225 +161,657 @@ const osThreadAttr_t http_server_attributes = {
   .reserved   = 0,
 };
 
+const osThreadAttr_t http_server_worker_attributes = {
+  .name       = "http_server_worker",
+  .attr_bits  = 0,
+  .cb_mem     = 0,
+  .cb_size    = 0,
+  .stack_mem  = 0,
+  .stack_size = SL_HTTP_SERVER_WORKER_STACK_SIZE,
+  .priority   = osPriorityNormal,
+  .tz_module  = 0,
+  .reserved   = 0,
+};
+
 /******************************************************
  *               Static functions
  ******************************************************/
-static sl_status_t unknown_request_handler(sl_http_server_t *handle, sl_http_server_request_t *request)
+static void sli_send_error_response(sl_http_server_t *handle, sl_http_response_code_t response_code, char *text)
 {
-  UNUSED_PARAMETER(request);
   sl_http_server_response_t response = { 0 };
-  char *response_data                = "Not Found!";
-  uint32_t length                    = strlen(response_data);
+  uint32_t length                    = strlen(text);
 
-  response.response_code        = SL_HTTP_RESPONSE_NOT_FOUND;
+  response.response_code        = response_code;
   response.content_type         = SL_HTTP_CONTENT_TYPE_TEXT_HTML;
-  response.data                 = (uint8_t *)response_data;
+  response.data                 = (uint8_t *)text;
   response.current_data_length  = length;
   response.expected_data_length = length;
   response.headers              = NULL;
   response.header_count         = 0;
   sl_http_server_send_response(handle, &response);
+}
+
+static sl_status_t unknown_request_handler(sl_http_server_t *handle, sl_http_server_request_t *request)
+{
+  UNUSED_PARAMETER(request);
+  sli_send_error_response(handle, SL_HTTP_RESPONSE_NOT_FOUND, "Not Found!");
 
   return SL_STATUS_OK;
 }
 
-static sl_status_t sli_parse_http_headers(sl_http_server_t *handle, int length)
-{
-  uint16_t header_count   = 0;
-  int string_length       = 0;
-  char *headers           = NULL;
-  char *sol               = NULL;
-  char *target            = NULL;
-  char content_length[32] = { 0 };
-
-  handle->request.request_data_length       = 0;
-  handle->request.request_header_count      = 0;
-  handle->request.uri.path                  = NULL;
-  handle->request.uri.query_parameter_count = 0;
-  headers                                   = handle->request_buffer;
-  sol                                       = headers;
-  for (int i = 0; i < length; i++) {
-    if ('\r' == headers[i] && '\n' == headers[i + 1]) {
-      headers[i]     = 0;
-      headers[i + 1] = 0;
-
-      SL_DEBUG_LOG("Got request method : %s\n", sol);
-
-      char *sep_pos = strchr(sol, ' '); // Find the space position
-      sep_pos[0]    = 0;
-      if (strcmp(sol, "GET") == 0) {
-        handle->request.type = SL_HTTP_REQUEST_GET;
-      } else if (strcmp(sol, "POST") == 0) {
-        handle->request.type = SL_HTTP_REQUEST_POST;
-      } else if (strcmp(sol, "PUT") == 0) {
-        handle->request.type = SL_HTTP_REQUEST_PUT;
-      } else if (strcmp(sol, "DELETE") == 0) {
-        handle->request.type = SL_HTTP_REQUEST_DELETE;
-      } else if (strcmp(sol, "HEAD") == 0) {
-        handle->request.type = SL_HTTP_REQUEST_HEAD;
-      } else {
-        return SL_STATUS_FAIL;
-      }
-      handle->request.uri.path = &sep_pos[1];
+// Returns true if text starts with prefix, ignoring case
+static bool sli_http_starts_with(const char *text, const char *prefix)
+{
+  for (; *prefix != 0; text++, prefix++) {
+    if (tolower((unsigned char)*text) != tolower((unsigned char)*prefix)) {
+      return false;
+    }
+  }
+  return true;
+}
 
-      sep_pos = strchr(handle->request.uri.path, ' '); // Find the space position
-      if (NULL != sep_pos) {
-        sep_pos[0] = 0;
-        if (0 == strcmp(&(sep_pos[1]), "HTTP/1.1")) {
-          handle->request.version = SL_HTTP_VERSION_1_1;
-        } else {
-          handle->request.version = SL_HTTP_VERSION_1_0;
-        }
-        // ToDo: Store HTTP version
-      } else {
-        handle->request.version = SL_HTTP_VERSION_1_0;
-      }
+static bool sli_http_token_equals(const char *text, const char *token)
+{
+  return sli_http_starts_with(text, token) && (0 == text[strlen(token)]);
+}
 
-      sol = &(headers[i + 2]);
-      break;
+static bool sli_http_token_contains(const char *text, const char *token)
+{
+  for (; *text != 0; text++) {
+    if (sli_http_starts_with(text, token)) {
+      return true;
     }
   }
+  return false;
+}
 
-  handle->header = sol;
-  length         = strlen(sol);
-  headers        = sol;
+// Returns the value of a request header, or NULL if the request does not have it
+static const char *sli_http_find_request_header(const sl_http_server_t *handle, const char *name)
+{
+  uint16_t count = (handle->request.request_header_count < SL_HTTP_SERVER_MAX_REQUEST_HEADERS)
+                     ? handle->request.request_header_count
+                     : SL_HTTP_SERVER_MAX_REQUEST_HEADERS;
 
-  target = strchr(handle->request.uri.path, '?');
-  if (NULL != target) {
-    target[0] = 0;
-    target += 1;
-    handle->request.uri.query_parameter_count = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (sli_http_token_equals(handle->request_headers[i].key, name)) {
+      return handle->request_headers[i].value;
+    }
+  }
+  return NULL;
+}
 
-    char *query = NULL;
-    char *value = NULL;
+// Returns true if the If-None-Match header of the request lists the entity tag. Tags are compared weakly, as for GET.
+static bool sli_http_etag_matches(const sl_http_server_t *handle, const char *etag)
+{
+  const char *list = sli_http_find_request_header(handle, "If-None-Match");
+  size_t length;
 
-    query = target;
-    for (int i = 0; i < MAX_QUERY_PARAMETERS; i++) {
-      handle->request.uri.query_parameters[i].query = query;
-      query                                         = strchr(query, '&');
-      if (NULL != query) {
-        query[0] = 0;
-        query += 1;
-      }
-      value = strchr(handle->request.uri.query_parameters[i].query, '=');
-      if (NULL != value) {
-        value[0] = 0;
-        value += 1;
-      }
-      handle->request.uri.query_parameters[i].value = value;
-      handle->request.uri.query_parameter_count++;
+  if (NULL == list) {
+    return false;
+  }
+  if (0 == strncmp(etag, "W/", 2)) {
+    etag += 2;
+  }
+  length = strlen(etag);
 
-      if (NULL == query) {
-        break;
-      }
+  while (*list != 0) {
+    while ((*list == ' ') || (*list == '\t') || (*list == ',')) {
+      list++;
+    }
+    if (*list == '*') {
+      return true;
+    }
+    if (0 == strncmp(list, "W/", 2)) {
+      list += 2;
+    }
+    if ((0 == strncmp(list, etag, length))
+        && ((list[length] == 0) || (list[length] == ',') || (list[length] == ' ') || (list[length] == '\t'))) {
+      return true;
+    }
+    while ((*list != 0) && (*list != ',')) {
+      list++;
+    }
+  }
+  return false;
+}
+
+static sl_status_t sli_http_parse_method(sl_http_server_t *handle, const char *method)
+{
+  static const struct {
+    const char *name;
+    sl_http_server_request_type_t type;
+  } methods[] = {
+    { "GET", SL_HTTP_REQUEST_GET },       { "POST", SL_HTTP_REQUEST_POST }, { "PUT", SL_HTTP_REQUEST_PUT },
+    { "DELETE", SL_HTTP_REQUEST_DELETE }, { "HEAD", SL_HTTP_REQUEST_HEAD },
+  };
+
+  SL_DEBUG_LOG("Got request method : %s\n", method);
+  for (uint8_t i = 0; i < (sizeof(methods) / sizeof(methods[0])); i++) {
+    if (0 == strcmp(method, methods[i].name)) {
+      handle->request.type = methods[i].type;
+      return SL_STATUS_OK;
+    }
+  }
+  return SL_STATUS_FAIL;
+}
+
+// Records a header and applies the ones that affect how the request is received or the connection is handled
+static void sli_http_process_header(sl_http_server_t *handle, char *name, char *value)
+{
+  sl_http_server_request_t *request = &(handle->request);
+
+  if (request->request_header_count < SL_HTTP_SERVER_MAX_REQUEST_HEADERS) {
+    handle->request_headers[request->request_header_count].key   = name;
+    handle->request_headers[request->request_header_count].value = value;
+  }
+  request->request_header_count++;
+
+  if (sli_http_token_equals(name, "Content-Length")) {
+    request->request_data_length = strtoul(value, NULL, 10);
+  } else if (sli_http_token_equals(name, "Connection")) {
+    if (sli_http_token_contains(value, "close")) {
+      handle->keep_alive = false;
+    } else if (sli_http_token_contains(value, "keep-alive")) {
+      handle->keep_alive = (handle->config.keep_alive_timeout != 0);
     }
+  } else if (sli_http_token_equals(name, "Transfer-Encoding")) {
+    request->is_chunked = sli_http_token_contains(value, "chunked");
   }
+}
 
-  for (int i = 0; i < length; i++) {
-    // Identify number of headers
-    if ('\r' == headers[i] && '\n' == headers[i + 1]) {
-      // Found a new line
-      header_count++;
+// Starts a query parameter at the given position, if the request has room for it
+static void sli_http_start_query_parameter(sl_http_server_t *handle, sli_http_parser_t *parser, int position)
+{
+  sl_http_server_request_uri_t *uri = &(handle->request.uri);
 
-      if (0 == strncmp("Content-Length", sol, strlen("Content-Length"))) {
-        target = strchr(sol, ':');
-        if (' ' == target[1]) {
-          target += 2;
+  parser->query_active = (uri->query_parameter_count < MAX_QUERY_PARAMETERS);
+  if (parser->query_active) {
+    uri->query_parameters[uri->query_parameter_count].query = &(handle->request_buffer[position]);
+    uri->query_parameters[uri->query_parameter_count].value = NULL;
+    uri->query_parameter_count++;
+  }
+}
+
+// Parses the request buffer up to length bytes, terminating the tokens in place. Stops once the headers are complete.
+static void sli_http_parse_request(sl_http_server_t *handle, sli_http_parser_t *parser, int length)
+{
+  char *buffer                      = handle->request_buffer;
+  sl_http_server_request_t *request = &(handle->request);
+
+  for (; (parser->position < length) && (SLI_HTTP_PARSE_DONE != parser->state) && (SLI_HTTP_PARSE_ERROR != parser->state);
+       parser->position++) {
+    int position = parser->position;
+    char c       = buffer[position];
+
+    switch (parser->state) {
+      case SLI_HTTP_PARSE_METHOD:
+        if (' ' == c) {
+          buffer[position] = 0;
+          if (SL_STATUS_OK != sli_http_parse_method(handle, &buffer[parser->token])) {
+            parser->state = SLI_HTTP_PARSE_ERROR;
+            break;
+          }
+          request->uri.path = &buffer[position + 1];
+          parser->state     = SLI_HTTP_PARSE_PATH;
+        } else if (('\r' == c) || ('\n' == c)) {
+          parser->state = SLI_HTTP_PARSE_ERROR;
+        }
+        break;
+
+      case SLI_HTTP_PARSE_PATH:
+      case SLI_HTTP_PARSE_QUERY:
+        if (' ' == c) {
+          buffer[position] = 0;
+          parser->token    = position + 1;
+          parser->state    = SLI_HTTP_PARSE_VERSION;
+        } else if ('\r' == c) {
+          // Request line without a protocol version
+          buffer[position] = 0;
+          request->version = SL_HTTP_VERSION_1_0;
+          parser->state    = SLI_HTTP_PARSE_REQUEST_LINE_LF;
+        } else if (SLI_HTTP_PARSE_PATH == parser->state) {
+          if ('?' == c) {
+            buffer[position] = 0;
+            sli_http_start_query_parameter(handle, parser, position + 1);
+            parser->state = SLI_HTTP_PARSE_QUERY;
+          } else {
+            parser->path_hash = SLI_HTTP_PATH_HASH(parser->path_hash, c);
+          }
+        } else if ('&' == c) {
+          buffer[position] = 0;
+          sli_http_start_query_parameter(handle, parser, position + 1);
+        } else if (('=' == c) && parser->query_active
+                   && (NULL == request->uri.query_parameters[request->uri.query_parameter_count - 1].value)) {
+          buffer[position]                                                        = 0;
+          request->uri.query_parameters[request->uri.query_parameter_count - 1].value = &buffer[position + 1];
+        }
+        break;
+
+      case SLI_HTTP_PARSE_VERSION:
+        if ('\r' == c) {
+          buffer[position] = 0;
+          request->version =
+            (0 == strcmp(&buffer[parser->token], "HTTP/1.1")) ? SL_HTTP_VERSION_1_1 : SL_HTTP_VERSION_1_0;
+          parser->state = SLI_HTTP_PARSE_REQUEST_LINE_LF;
+        }
+        break;
+
+      case SLI_HTTP_PARSE_REQUEST_LINE_LF:
+        if ('\n' != c) {
+          parser->state = SLI_HTTP_PARSE_ERROR;
+          break;
+        }
+        // HTTP/1.1 connections are persistent unless the client asks otherwise
+        handle->keep_alive =
+          ((SL_HTTP_VERSION_1_1 == request->version) && (handle->config.keep_alive_timeout != 0));
+        handle->header = &buffer[position + 1];
+        parser->state  = SLI_HTTP_PARSE_HEADER_START;
+        break;
+
+      case SLI_HTTP_PARSE_HEADER_START:
+        if ('\r' == c) {
+          parser->state = SLI_HTTP_PARSE_HEADERS_END_LF;
+        } else if ((':' == c) || ('\n' == c)) {
+          parser->state = SLI_HTTP_PARSE_ERROR;
         } else {
-          target += 1;
+          parser->token = position;
+          parser->state = SLI_HTTP_PARSE_HEADER_NAME;
         }
+        break;
 
-        string_length = (&headers[i]) - target;
-        if (string_length < 32) {
-          strncpy(content_length, target, string_length);
-          handle->request.request_data_length = atoi(content_length);
+      case SLI_HTTP_PARSE_HEADER_NAME:
+        if (':' == c) {
+          int name_end = position;
+          while ((name_end > parser->token) && (' ' == buffer[name_end - 1])) {
+            name_end--;
+          }
+          buffer[name_end]    = 0;
+          parser->header_name = &buffer[parser->token];
+          parser->state       = SLI_HTTP_PARSE_HEADER_VALUE_START;
+        } else if (('\r' == c) || ('\n' == c)) {
+          parser->state = SLI_HTTP_PARSE_ERROR;
         }
-      }
+        break;
+
+      case SLI_HTTP_PARSE_HEADER_VALUE_START:
+        if ('\r' == c) {
+          buffer[position] = 0;
+          sli_http_process_header(handle, parser->header_name, &buffer[position]);
+          parser->state = SLI_HTTP_PARSE_HEADER_LF;
+        } else if ((' ' != c) && ('\t' != c)) {
+          parser->token     = position;
+          parser->value_end = position + 1;
+          parser->state     = SLI_HTTP_PARSE_HEADER_VALUE;
+        }
+        break;
+
+      case SLI_HTTP_PARSE_HEADER_VALUE:
+        if ('\r' == c) {
+          buffer[parser->value_end] = 0;
+          sli_http_process_header(handle, parser->header_name, &buffer[parser->token]);
+          parser->state = SLI_HTTP_PARSE_HEADER_LF;
+        } else if ((' ' != c) && ('\t' != c)) {
+          parser->value_end = position + 1;
+        }
+        break;
+
+      case SLI_HTTP_PARSE_HEADER_LF:
+        parser->state = ('\n' == c) ? SLI_HTTP_PARSE_HEADER_START : SLI_HTTP_PARSE_ERROR;
+        break;
 
-      sol = &(headers[i + 2]);
-      i++;
+      case SLI_HTTP_PARSE_HEADERS_END_LF:
+        parser->state = ('\n' == c) ? SLI_HTTP_PARSE_DONE : SLI_HTTP_PARSE_ERROR;
+        break;
+
+      default:
+        break;
     }
   }
-  handle->request.request_header_count = header_count;
+}
 
-  return SL_STATUS_OK;
+static int sli_hex_digit_value(uint8_t c)
+{
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  }
+  c = (uint8_t)tolower(c);
+  if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  }
+  return -1;
 }
 
-// Define the thread function for handling individual clients
-static void sli_process_request(sl_http_server_t *handle, int client_socket)
+// Decodes chunked transfer coding from input to output, which may alias input as the output never gets ahead of it.
+// Returns the number of input bytes consumed. Stops when the output is full or the last chunk and trailers are consumed.
+static uint32_t sli_decode_chunked_data(sl_http_server_t *handle,
+                                        const uint8_t *input,
+                                        uint32_t input_length,
+                                        uint8_t *output,
+                                        uint32_t output_length,
+                                        uint32_t *produced)
 {
-  int recv_length                   = 0;
-  int rem_length                    = 0;
-  sl_http_server_request_t *request = NULL;
-  char *recv_buffer                 = NULL;
+  uint32_t consumed = 0;
+  uint32_t length   = 0;
+  int digit         = 0;
+
+  *produced = 0;
+  while ((consumed < input_length) && (SLI_HTTP_CHUNK_DONE != handle->chunk_state)
+         && (SLI_HTTP_CHUNK_ERROR != handle->chunk_state)) {
+    uint8_t c = input[consumed];
+
+    switch (handle->chunk_state) {
+      case SLI_HTTP_CHUNK_SIZE:
+        digit = sli_hex_digit_value(c);
+        if ((digit >= 0) && (handle->chunk_length <= 0x0FFFFFFF)) {
+          handle->chunk_length = (handle->chunk_length << 4) | (uint32_t)digit;
+        } else if ((';' == c) || (' ' == c) || ('\t' == c)) {
+          handle->chunk_state = SLI_HTTP_CHUNK_EXTENSION;
+        } else if ('\r' == c) {
+          handle->chunk_state = SLI_HTTP_CHUNK_SIZE_LF;
+        } else {
+          handle->chunk_state = SLI_HTTP_CHUNK_ERROR;
+        }
+        break;
 
-  handle->request.request_data_length = 0;
-  handle->response_sent               = false;
-  rem_length                          = (MAX_HEADER_BUFFER_LENGTH - 1);
-  recv_buffer                         = handle->request_buffer;
+      case SLI_HTTP_CHUNK_EXTENSION:
+        if ('\r' == c) {
+          handle->chunk_state = SLI_HTTP_CHUNK_SIZE_LF;
+        }
+        break;
 
-  // Loop until Complete headers are received
-  while (rem_length > 0) {
-    int length = recv(client_socket, recv_buffer, rem_length, 0);
-    if (length < 0) {
-      SL_DEBUG_LOG("\r\nSocket receive failed with bsd error: %d\r\n", errno);
-      close(client_socket);
-      return;
+      case SLI_HTTP_CHUNK_SIZE_LF:
+        if ('\n' != c) {
+          handle->chunk_state = SLI_HTTP_CHUNK_ERROR;
+        } else {
+          handle->chunk_state = (0 == handle->chunk_length) ? SLI_HTTP_CHUNK_TRAILER : SLI_HTTP_CHUNK_DATA;
+        }
+        break;
+
+      case SLI_HTTP_CHUNK_DATA:
+        length = input_length - consumed;
+        if (length > handle->chunk_length) {
+          length = handle->chunk_length;
+        }
+        if (length > (output_length - *produced)) {
+          length = output_length - *produced;
+        }
+        if (0 == length) {
+          return consumed;
+        }
+        memmove(&output[*produced], &input[consumed], length);
+        *produced += length;
+        consumed += length;
+        handle->chunk_length -= length;
+        if (0 == handle->chunk_length) {
+          handle->chunk_state = SLI_HTTP_CHUNK_DATA_CR;
+        }
+        continue;
+
+      case SLI_HTTP_CHUNK_DATA_CR:
+        handle->chunk_state = ('\r' == c) ? SLI_HTTP_CHUNK_DATA_LF : SLI_HTTP_CHUNK_ERROR;
+        break;
+
+      case SLI_HTTP_CHUNK_DATA_LF:
+        handle->chunk_state = ('\n' == c) ? SLI_HTTP_CHUNK_SIZE : SLI_HTTP_CHUNK_ERROR;
+        break;
+
+      case SLI_HTTP_CHUNK_TRAILER:
+        handle->chunk_state = ('\r' == c) ? SLI_HTTP_CHUNK_END_LF : SLI_HTTP_CHUNK_TRAILER_LINE;
+        break;
+
+      case SLI_HTTP_CHUNK_TRAILER_LINE:
+        if ('\n' == c) {
+          handle->chunk_state = SLI_HTTP_CHUNK_TRAILER;
+        }
+        break;
+
+      case SLI_HTTP_CHUNK_END_LF:
+        handle->chunk_state = ('\n' == c) ? SLI_HTTP_CHUNK_DONE : SLI_HTTP_CHUNK_ERROR;
+        break;
+
+      default:
+        break;
     }
-    char *sol = &(recv_buffer[recv_length]);
-    recv_length += length;
-    rem_length -= length;
-    recv_buffer[recv_length] = 0;
-    recv_buffer += length;
+    consumed++;
+  }
+  return consumed;
+}
 
-    // Search for end of the header
-    char *sep_pos = strstr(sol, "\r\n\r\n");
-    SL_DEBUG_LOG("Got chunk: \n%s\n", sol);
+// Reads and decodes chunked request data until the buffer is full or the last chunk is received
+static sl_status_t sli_read_chunked_request_data(sl_http_server_t *handle, sl_http_recv_req_data_t *recvData)
+{
+  uint32_t consumed = 0;
+  uint32_t produced = 0;
+
+  while ((recvData->received_data_length < recvData->buffer_length) && (SLI_HTTP_CHUNK_DONE != handle->chunk_state)) {
+    uint8_t *output        = &(recvData->buffer[recvData->received_data_length]);
+    uint32_t output_length = recvData->buffer_length - recvData->received_data_length;
+
+    if (handle->data_length > 0) {
+      // Data received along with the headers
+      consumed = sli_decode_chunked_data(handle, handle->req_data, handle->data_length, output, output_length, &produced);
+      handle->req_data += consumed;
+      handle->data_length -= consumed;
+    } else {
+      int receive_length = recv(handle->client_socket, output, output_length, 0);
+      if (receive_length <= 0) {
+        SL_DEBUG_LOG("\r\nSocket receive failed with bsd error: %d\r\n", errno);
+        handle->keep_alive = false;
+        return SL_STATUS_FAIL;
+      }
+      consumed = sli_decode_chunked_data(handle, output, (uint32_t)receive_length, output, output_length, &produced);
+      // Bytes of a pipelined request received past this one cannot be replayed, so do not reuse the connection
+      if (consumed < (uint32_t)receive_length) {
+        handle->keep_alive = false;
+      }
+    }
+    if (SLI_HTTP_CHUNK_ERROR == handle->chunk_state) {
+      SL_DEBUG_LOG("\r\nMalformed chunked request data\r\n");
+      handle->keep_alive = false;
+      return SL_STATUS_FAIL;
+    }
+    recvData->received_data_length += produced;
+  }
+
+  if (SLI_HTTP_CHUNK_DONE == handle->chunk_state) {
+    handle->rem_len = 0;
+    if (handle->data_length > 0) {
+      handle->keep_alive = false;
+    }
+  }
+  return SL_STATUS_OK;
+}
+
+// Indexes the exact-match handlers by URI hash. Prefix handlers, and handlers that do not fit, are matched by a scan.
+static void sli_build_route_table(sl_http_server_t *handle)
+{
+  memset(handle->route_table, 0, sizeof(handle->route_table));
+  handle->routes_indexed = true;
 
-    if (NULL != sep_pos) {
-      sep_pos[2] = 0;
-      sep_pos[3] = 0;
-      rem_length = 0;
+  for (uint16_t i = 0; i < handle->config.handlers_count; i++) {
+    const sl_http_server_handler_t *handler = &(handle->config.handlers_list[i]);
+    uint32_t hash                           = SLI_HTTP_PATH_HASH_INIT;
+    uint32_t probe                          = 0;
 
-      if (SL_STATUS_OK != sli_parse_http_headers(handle, length)) {
+    if (handler->prefix) {
+      handle->routes_indexed = false;
+      continue;
+    }
+    for (const char *c = handler->uri; *c != 0; c++) {
+      hash = SLI_HTTP_PATH_HASH(hash, *c);
+    }
+    for (probe = 0; probe < SL_HTTP_SERVER_ROUTE_TABLE_SIZE; probe++) {
+      uint16_t *entry = &(handle->route_table[(hash + probe) & (SL_HTTP_SERVER_ROUTE_TABLE_SIZE - 1)]);
+      if (0 == *entry) {
+        *entry = i + 1;
         break;
       }
-      SL_DEBUG_LOG("Got expected data length : %lu\n", handle->request.request_data_length);
+    }
+    if (SL_HTTP_SERVER_ROUTE_TABLE_SIZE == probe) {
+      handle->routes_indexed = false;
+    }
+  }
+}
 
-      if (handle->request.request_data_length > 0) {
-        int header_length = (int)(sep_pos - handle->request_buffer);
-        recv_buffer       = (char *)handle->req_data;
-        handle->rem_len   = handle->request.request_data_length;
+static bool sli_handler_accepts(const sl_http_server_handler_t *handler, const sl_http_server_request_t *request)
+{
+  return (0 == handler->methods) || (0 != (handler->methods & SL_HTTP_REQUEST_METHOD(request->type)));
+}
 
-        SL_DEBUG_LOG("Got header length : %u\n", header_length);
+// Finds the handler of a request. path_matched is set if a handler has the path of the request, whatever its methods.
+static const sl_http_server_handler_t *sli_find_request_handler(const sl_http_server_t *handle,
+                                                                const sl_http_server_request_t *request,
+                                                                uint32_t path_hash,
+                                                                bool *path_matched)
+{
+  // Connection handles of the concurrent mode share the route table of their server
+  const sl_http_server_t *routes              = (NULL != handle->parent) ? handle->parent : handle;
+  const sl_http_server_handler_t *handlers    = handle->config.handlers_list;
+  const sl_http_server_handler_t *best_prefix = NULL;
+  size_t best_prefix_length                   = 0;
+
+  *path_matched = false;
+  if (NULL == request->uri.path) {
+    return NULL;
+  }
+
+  for (uint32_t probe = 0; probe < SL_HTTP_SERVER_ROUTE_TABLE_SIZE; probe++) {
+    uint16_t entry = routes->route_table[(path_hash + probe) & (SL_HTTP_SERVER_ROUTE_TABLE_SIZE - 1)];
+    if (0 == entry) {
+      break;
+    }
+    if (0 == strcmp(handlers[entry - 1].uri, request->uri.path)) {
+      *path_matched = true;
+      if (sli_handler_accepts(&handlers[entry - 1], request)) {
+        return &handlers[entry - 1];
+      }
+    }
+  }
+  if (routes->routes_indexed) {
+    return NULL;
+  }
 
-        // Check if we recived data along with header
-        if (recv_length > (header_length + 4)) {
-          length              = recv_length - (header_length + 4);
-          handle->data_length = length;
-          SL_DEBUG_LOG("Got remaining data length : %lu\n", handle->data_length);
-          handle->req_data = (uint8_t *)(handle->request_buffer + header_length + 4);
+  for (uint16_t i = 0; i < handle->config.handlers_count; i++) {
+    const sl_http_server_handler_t *handler = &handlers[i];
+
+    if (handler->prefix) {
+      size_t length = strlen(handler->uri);
+      if (0 == strncmp(handler->uri, request->uri.path, length)) {
+        *path_matched = true;
+        if (sli_handler_accepts(handler, request) && ((NULL == best_prefix) || (length > best_prefix_length))) {
+          best_prefix        = handler;
+          best_prefix_length = length;
         }
-        recv_length = 0;
+      }
+    } else if (0 == strcmp(handler->uri, request->uri.path)) {
+      *path_matched = true;
+      if (sli_handler_accepts(handler, request)) {
+        return handler;
       }
     }
   }
+  return best_prefix;
+}
 
-  request = &(handle->request);
+// Receives and dispatches a single request on the given client socket. The caller owns the socket.
+static sl_status_t sli_process_request(sl_http_server_t *handle, int client_socket)
+{
+  sli_http_parser_t parser                = { 0 };
+  sl_http_server_request_t *request       = &(handle->request);
+  const sl_http_server_handler_t *handler = NULL;
+  bool path_matched                       = false;
+  int recv_length                         = 0;
+  uint32_t body_length                    = 0;
+
+  memset(request, 0, sizeof(sl_http_server_request_t));
+  handle->response_sent   = false;
+  handle->keep_alive      = false;
+  handle->header          = NULL;
+  handle->req_data        = NULL;
+  handle->data_length     = 0;
+  handle->rem_len         = 0;
+  handle->rem_resp_length = 0;
+  handle->chunk_state     = SLI_HTTP_CHUNK_SIZE;
+  handle->chunk_length    = 0;
+  parser.state            = SLI_HTTP_PARSE_METHOD;
+  parser.path_hash        = SLI_HTTP_PATH_HASH_INIT;
+
+  // Receive until the headers are complete, parsing every byte once as it arrives
+  while (SLI_HTTP_PARSE_DONE != parser.state) {
+    if (recv_length >= HTTP_MAX_HEADER_LENGTH) {
+      SL_DEBUG_LOG("\r\nRequest headers exceed the request buffer\r\n");
+      return SL_STATUS_FAIL;
+    }
+    int length = recv(client_socket, &(handle->request_buffer[recv_length]), HTTP_MAX_HEADER_LENGTH - recv_length, 0);
+    if (length <= 0) {
+      SL_DEBUG_LOG("\r\nSocket receive failed with bsd error: %d\r\n", errno);
+      return SL_STATUS_FAIL;
+    }
+    recv_length += length;
+    handle->request_buffer[recv_length] = 0;
 
-  // Check if the handler's list has the URI
-  for (uint16_t i = 0; i < handle->config.handlers_count; i++) {
-    if (strcmp(handle->config.handlers_list[i].uri, request->uri.path) == 0) {
-      // If the handler is present, call the handler
-      handle->config.handlers_list[i].handler(handle, request);
-      break;
+    sli_http_parse_request(handle, &parser, recv_length);
+    if (SLI_HTTP_PARSE_ERROR == parser.state) {
+      SL_DEBUG_LOG("\r\nMalformed request\r\n");
+      return SL_STATUS_FAIL;
+    }
+  }
+  SL_DEBUG_LOG("Got expected data length : %lu\n", request->request_data_length);
+
+  // Data received along with the headers is returned first by sl_http_server_read_request_data
+  body_length      = (uint32_t)(recv_length - parser.position);
+  handle->req_data = (uint8_t *)&(handle->request_buffer[parser.position]);
+  if (request->is_chunked) {
+    // The length of chunked data is unknown until its last chunk; rem_len stays nonzero until then
+    request->request_data_length = 0;
+    handle->data_length          = body_length;
+    handle->rem_len              = 1;
+  } else {
+    handle->rem_len     = request->request_data_length;
+    handle->data_length = (body_length < request->request_data_length) ? body_length : request->request_data_length;
+    // Bytes of a pipelined request received past this one cannot be replayed, so do not reuse the connection
+    if (body_length > request->request_data_length) {
+      handle->keep_alive = false;
     }
   }
 
+  handler = sli_find_request_handler(handle, request, parser.path_hash, &path_matched);
+  if (NULL != handler) {
+    handler->handler(handle, request);
+  } else if (path_matched) {
+    sli_send_error_response(handle, SL_HTTP_RESPONSE_METHOD_NOT_ALLOWED, "Method Not Allowed");
+  }
+
   if (false == handle->response_sent) {
     handle->config.default_handler(handle, &(handle->request));
   }
-  return;
+  return SL_STATUS_OK;
+}
+
+// A connection can serve another request only if the current exchange is complete on both sides
+static bool sli_is_connection_reusable(const sl_http_server_t *handle)
+{
+  return (handle->keep_alive && handle->response_sent && (0 == handle->rem_resp_length) && (0 == handle->rem_len));
+}
+
+static void sli_close_client_socket(sl_http_server_t *handle)
+{
+  close(handle->client_socket);
+  handle->client_socket   = -1;
+  handle->rem_resp_length = 0;
+}
+
+static sl_status_t sli_set_receive_timeout(int socket, uint16_t timeout_seconds)
+{
+  sl_si91x_time_value timeout = { 0 };
+  timeout.tv_sec              = timeout_seconds;
+
+  if (setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))) {
+    SL_DEBUG_LOG("\r\n setsockopt fail\r\n");
+    return SL_STATUS_FAIL;
+  }
+  SL_DEBUG_LOG("\r\n setsockopt done\r\n");
+  return SL_STATUS_OK;
 }
 
 static void client_accept_callback(int32_t sock_id, struct sockaddr *addr, uint8_t ip_version)
@@ -291,6 +823,283 @@ static void client_accept_callback(int32_t sock_id, struct sockaddr *addr, uint8
   osEventFlagsSet(server_handle->http_server_id, HTTP_SERVER_CONNECT_SUCCESS);
 }
 
+static void select_callback_handler(fd_set *fd_read, fd_set *fd_write, fd_set *fd_except, int32_t status)
+{
+  UNUSED_PARAMETER(fd_write);
+  UNUSED_PARAMETER(fd_except);
+
+  if ((SL_STATUS_OK == status) && (NULL != fd_read)) {
+    selected_fds = *fd_read;
+  } else {
+    FD_ZERO(&selected_fds);
+  }
+  osEventFlagsSet(server_handle->http_server_id, HTTP_SERVER_SELECT_DONE);
+}
+
+static sli_http_server_slot_t *sli_http_server_get_free_slot(sli_http_server_pool_t *pool)
+{
+  for (uint8_t i = 0; i < pool->slot_count; i++) {
+    if (SLI_HTTP_SERVER_SLOT_FREE == pool->slots[i].state) {
+      return &pool->slots[i];
+    }
+  }
+  return NULL;
+}
+
+// Hands a connection with a pending request over to the worker pool
+static void sli_http_server_dispatch(sli_http_server_pool_t *pool, sli_http_server_slot_t *slot)
+{
+  slot->state = SLI_HTTP_SERVER_SLOT_BUSY;
+  if (osOK != osMessageQueuePut(pool->work_queue, &slot, 0, 0)) {
+    SL_DEBUG_LOG("\r\nFailed to queue client socket : %d\r\n", slot->connection.client_socket);
+    close(slot->connection.client_socket);
+    slot->connection.client_socket = -1;
+    slot->state                    = SLI_HTTP_SERVER_SLOT_FREE;
+  }
+}
+
+static void sli_http_server_worker(void *arg)
+{
+  sli_http_server_pool_t *pool = (sli_http_server_pool_t *)arg;
+  sli_http_server_slot_t *slot = NULL;
+
+  while (osOK == osMessageQueueGet(pool->work_queue, &slot, NULL, osWaitForever)) {
+    // A NULL slot is queued by the server thread when the server is stopped
+    if (NULL == slot) {
+      break;
+    }
+
+    sl_http_server_t *connection = &slot->connection;
+    if ((SL_STATUS_OK == sli_process_request(connection, connection->client_socket))
+        && sli_is_connection_reusable(connection)) {
+      slot->last_activity = osKernelGetTickCount();
+      slot->state         = SLI_HTTP_SERVER_SLOT_IDLE;
+    } else {
+      // The server thread closes the socket once the NWP had time to flush the response, so the worker moves on
+      slot->last_activity = osKernelGetTickCount();
+      slot->state         = SLI_HTTP_SERVER_SLOT_CLOSING;
+    }
+    osEventFlagsSet(connection->http_server_id, HTTP_SERVER_SLOT_RELEASED);
+  }
+
+  osSemaphoreRelease(pool->worker_exit);
+  osThreadExit();
+}
+
+static void sli_http_server_pool_destroy(sli_http_server_pool_t *pool)
+{
+  sli_http_server_slot_t *stop = NULL;
+
+  // Workers drain the connections queued ahead of the stop markers before exiting
+  for (uint8_t i = 0; i < pool->worker_count; i++) {
+    osMessageQueuePut(pool->work_queue, &stop, 0, osWaitForever);
+  }
+  for (uint8_t i = 0; i < pool->worker_count; i++) {
+    osSemaphoreAcquire(pool->worker_exit, osWaitForever);
+  }
+
+  if (NULL != pool->slots) {
+    for (uint8_t i = 0; i < pool->slot_count; i++) {
+      if (SLI_HTTP_SERVER_SLOT_FREE != pool->slots[i].state) {
+        close(pool->slots[i].connection.client_socket);
+      }
+    }
+    free(pool->slots);
+  }
+  if (NULL != pool->work_queue) {
+    osMessageQueueDelete(pool->work_queue);
+  }
+  if (NULL != pool->worker_exit) {
+    osSemaphoreDelete(pool->worker_exit);
+  }
+  free(pool);
+}
+
+static sli_http_server_pool_t *sli_http_server_pool_create(sl_http_server_t *server)
+{
+  sli_http_server_pool_t *pool = calloc(1, sizeof(sli_http_server_pool_t));
+  uint8_t worker_count         = server->config.worker_count;
+
+  if (NULL == pool) {
+    return NULL;
+  }
+
+  pool->slot_count = (server->config.max_clients > SL_HTTP_SERVER_MAX_CLIENTS) ? SL_HTTP_SERVER_MAX_CLIENTS
+                                                                                 : server->config.max_clients;
+  if (0 == worker_count) {
+    worker_count = 1;
+  } else if (worker_count > SL_HTTP_SERVER_MAX_WORKERS) {
+    worker_count = SL_HTTP_SERVER_MAX_WORKERS;
+  }
+
+  // Every slot is queued at most once, plus one stop marker per worker
+  pool->slots       = calloc(pool->slot_count, sizeof(sli_http_server_slot_t));
+  pool->work_queue  = osMessageQueueNew(pool->slot_count + worker_count, sizeof(sli_http_server_slot_t *), NULL);
+  pool->worker_exit = osSemaphoreNew(worker_count, 0, NULL);
+  if ((NULL == pool->slots) || (NULL == pool->work_queue) || (NULL == pool->worker_exit)) {
+    sli_http_server_pool_destroy(pool);
+    return NULL;
+  }
+
+  for (uint8_t i = 0; i < pool->slot_count; i++) {
+    sl_http_server_t *connection = &pool->slots[i].connection;
+
+    connection->config         = server->config;
+    connection->server_socket  = server->server_socket;
+    connection->client_socket  = -1;
+    connection->http_server_id = server->http_server_id;
+    connection->parent         = server;
+    pool->slots[i].state       = SLI_HTTP_SERVER_SLOT_FREE;
+  }
+
+  for (uint8_t i = 0; i < worker_count; i++) {
+    if (NULL == osThreadNew((osThreadFunc_t)sli_http_server_worker, pool, &http_server_worker_attributes)) {
+      break;
+    }
+    pool->worker_count++;
+  }
+  if (0 == pool->worker_count) {
+    sli_http_server_pool_destroy(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+// Closes the sockets of finished connections whose close delay has passed. Returns the ticks until the next one is
+// due, or osWaitForever if no connection is waiting to be closed.
+static uint32_t sli_http_server_close_finished_connections(sli_http_server_pool_t *pool)
+{
+  uint32_t close_delay = ((uint32_t)HTTP_SERVER_CLOSE_DELAY_MS * osKernelGetTickFreq()) / 1000;
+  uint32_t next_close  = osWaitForever;
+
+  for (uint8_t i = 0; i < pool->slot_count; i++) {
+    sli_http_server_slot_t *slot = &pool->slots[i];
+
+    if (SLI_HTTP_SERVER_SLOT_CLOSING != slot->state) {
+      continue;
+    }
+
+    uint32_t elapsed = osKernelGetTickCount() - slot->last_activity;
+    if (elapsed >= close_delay) {
+      sli_close_client_socket(&slot->connection);
+      slot->state = SLI_HTTP_SERVER_SLOT_FREE;
+    } else if ((close_delay - elapsed) < next_close) {
+      next_close = close_delay - elapsed;
+    }
+  }
+  return next_close;
+}
+
+// Closes persistent connections that exceeded the keep-alive timeout and polls the remaining ones for a new request.
+// Returns true if a select request is outstanding.
+static bool sli_http_server_poll_idle_connections(const sl_http_server_t *server, sli_http_server_pool_t *pool)
+{
+  fd_set read_fds;
+  struct timeval timeout = { 0 };
+  int max_fd             = -1;
+  uint32_t idle_ticks    = (uint32_t)server->config.keep_alive_timeout * osKernelGetTickFreq();
+
+  FD_ZERO(&read_fds);
+  for (uint8_t i = 0; i < pool->slot_count; i++) {
+    sli_http_server_slot_t *slot = &pool->slots[i];
+
+    if (SLI_HTTP_SERVER_SLOT_IDLE != slot->state) {
+      continue;
+    }
+
+    if ((osKernelGetTickCount() - slot->last_activity) >= idle_ticks) {
+      SL_DEBUG_LOG("\r\nClosing idle client socket : %d\r\n", slot->connection.client_socket);
+      close(slot->connection.client_socket);
+      slot->connection.client_socket = -1;
+      slot->state                    = SLI_HTTP_SERVER_SLOT_FREE;
+      continue;
+    }
+
+    FD_SET(slot->connection.client_socket, &read_fds);
+    if (slot->connection.client_socket > max_fd) {
+      max_fd = slot->connection.client_socket;
+    }
+  }
+
+  if (max_fd < 0) {
+    return false;
+  }
+
+  timeout.tv_sec  = SL_HTTP_SERVER_SELECT_TIMEOUT_MS / 1000;
+  timeout.tv_usec = (SL_HTTP_SERVER_SELECT_TIMEOUT_MS % 1000) * 1000;
+  if (SI91X_NO_ERROR != sl_si91x_select(max_fd + 1, &read_fds, NULL, NULL, &timeout, select_callback_handler)) {
+    SL_DEBUG_LOG("\r\nSocket select failed with bsd error: %d\r\n", errno);
+    return false;
+  }
+  return true;
+}
+
+// Accepts up to max_clients connections and hands each received request to the worker pool
+static void sli_http_server_serve_concurrent(sl_http_server_t *server, sli_http_server_pool_t *pool)
+{
+  bool accept_pending          = false;
+  bool select_pending          = false;
+  uint32_t result              = 0;
+  uint32_t close_timeout       = osWaitForever;
+  sli_http_server_slot_t *slot = NULL;
+
+  while (1) {
+    close_timeout = sli_http_server_close_finished_connections(pool);
+
+    if (false == select_pending) {
+      select_pending = sli_http_server_poll_idle_connections(server, pool);
+    }
+
+    if ((false == accept_pending) && (NULL != sli_http_server_get_free_slot(pool))) {
+      if (SI91X_NO_ERROR == sl_si91x_accept_async(server->server_socket, client_accept_callback)) {
+        accept_pending = true;
+      } else {
+        SL_DEBUG_LOG("\r\nSocket accept failed with bsd error: %d\r\n", errno);
+      }
+    }
+
+    result = osEventFlagsWait(server->http_server_id,
+                              HTTP_SERVER_STOP_CMD | HTTP_SERVER_CONNECT_SUCCESS | HTTP_SERVER_SELECT_DONE
+                                | HTTP_SERVER_SLOT_RELEASED,
+                              osFlagsWaitAny,
+                              close_timeout);
+    if (result & osFlagsError) {
+      continue;
+    }
+
+    if (result & HTTP_SERVER_STOP_CMD) {
+      SL_DEBUG_LOG("\r\nIn http server thread: Got Stop Command\r\n");
+      return;
+    }
+
+    if (result & HTTP_SERVER_CONNECT_SUCCESS) {
+      // Accept is only issued while a slot is free, so a slot is always available here
+      accept_pending = false;
+      slot           = sli_http_server_get_free_slot(pool);
+      SL_DEBUG_LOG("\r\nClient Socket:%d----------------------------", client_socket);
+
+      if ((server->config.client_idle_time != 0)
+          && (SL_STATUS_OK != sli_set_receive_timeout(client_socket, server->config.client_idle_time))) {
+        close(client_socket);
+      } else {
+        slot->connection.client_socket = client_socket;
+        sli_http_server_dispatch(pool, slot);
+      }
+    }
+
+    if (result & HTTP_SERVER_SELECT_DONE) {
+      select_pending = false;
+      for (uint8_t i = 0; i < pool->slot_count; i++) {
+        slot = &pool->slots[i];
+        if ((SLI_HTTP_SERVER_SLOT_IDLE == slot->state) && FD_ISSET(slot->connection.client_socket, &selected_fds)) {
+          sli_http_server_dispatch(pool, slot);
+        }
+      }
+    }
+  }
+}
+
 static void sli_http_server(const void *arg)
 {
   uint32_t result                   = 0;
@@ -299,6 +1108,8 @@ static void sli_http_server(const void *arg)
   struct sockaddr_in server_address = { 0 };
   socklen_t socket_length           = sizeof(struct sockaddr_in);
   uint8_t high_performance_socket   = SL_HIGH_PERFORMANCE_SOCKET;
+  bool concurrent_mode              = (server_handle->config.max_clients > 1);
+  int back_log                      = BACK_LOG;
 
   // Indicate to HTTP Server start that http server thread started successfully.
   osEventFlagsSet(server_handle->http_server_id, HTTP_SERVER_START_SUCCESS);
@@ -340,7 +1151,12 @@ static void sli_http_server(const void *arg)
     return;
   }
 
-  socket_return_value = listen(server_socket, BACK_LOG);
+  if (concurrent_mode) {
+    back_log = (server_handle->config.max_clients > SL_HTTP_SERVER_MAX_CLIENTS) ? SL_HTTP_SERVER_MAX_CLIENTS
+                                                                                : server_handle->config.max_clients;
+  }
+
+  socket_return_value = listen(server_socket, back_log);
   if (socket_return_value < 0) {
     SL_DEBUG_LOG("\r\nSocket listen failed with bsd error: %d\r\n", errno);
     close(server_socket);
@@ -348,8 +1164,31 @@ static void sli_http_server(const void *arg)
   }
   SL_DEBUG_LOG("\r\nListening on Local Port : %d\r\n", server_address.sin_port);
 
-  sl_si91x_time_value timeout = { 0 };
-  timeout.tv_sec              = server_handle->config.client_idle_time;
+  if (concurrent_mode) {
+    server_handle->server_socket = server_socket;
+
+    sli_http_server_pool_t *pool = sli_http_server_pool_create(server_handle);
+    if (NULL == pool) {
+      SL_DEBUG_LOG("\r\nFailed to create HTTP server worker pool\r\n");
+      server_handle->server_socket = -1;
+      close(server_socket);
+      return;
+    }
+    server_handle->context = pool;
+
+    sli_http_server_serve_concurrent(server_handle, pool);
+
+    // Stop accepting new clients, then let the workers finish the requests in progress
+    server_handle->server_socket = -1;
+    close(server_socket);
+    sli_http_server_pool_destroy(pool);
+    server_handle->context = NULL;
+    osEventFlagsSet(server_handle->http_server_id, HTTP_SERVER_EXIT);
+
+    while (1) {
+      osDelay(1000); // Delay for 1 second
+    }
+  }
 
   while (1) {
     socket_return_value = sl_si91x_accept_async(server_socket, client_accept_callback);
@@ -379,22 +1218,25 @@ static void sli_http_server(const void *arg)
         server_handle->client_socket = client_socket;
 
         if (server_handle->config.client_idle_time != 0) {
-          socket_return_value = setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-          if (socket_return_value) {
-            SL_DEBUG_LOG("\r\n setsockopt fail\r\n");
+          if (SL_STATUS_OK != sli_set_receive_timeout(client_socket, server_handle->config.client_idle_time)) {
             close(client_socket);
             continue;
-          } else {
-            SL_DEBUG_LOG("\r\n setsockopt done\r\n");
           }
         }
 
-        sli_process_request(server_handle, client_socket);
+        // Serve persistent connections until the client closes, idles out or the server is stopped
+        while ((SL_STATUS_OK == sli_process_request(server_handle, client_socket))
+               && sli_is_connection_reusable(server_handle)
+               && (0 == (osEventFlagsGet(server_handle->http_server_id) & HTTP_SERVER_STOP_CMD))) {
+          if (SL_STATUS_OK != sli_set_receive_timeout(client_socket, server_handle->config.keep_alive_timeout)) {
+            break;
+          }
+        }
       }
     }
-    osDelay(100);
-    close(client_socket);
-    server_handle->rem_resp_length = 0;
+    // Only the server thread serves connections in this mode, so it can wait for the NWP to flush the response
+    osDelay(HTTP_SERVER_CLOSE_DELAY_MS);
+    sli_close_client_socket(server_handle);
   }
 
   while (1) {
@@ -402,7 +1244,7 @@ static void sli_http_server(const void *arg)
   }
 }
 
-static int sli_process_socket_buffered_data(int fd, char *data, size_t data_length, int window_size)
+static int sli_process_socket_buffered_data(int fd, const char *data, size_t data_length, int window_size)
 {
   size_t tx_length = 0;
 
@@ -420,69 +1262,236 @@ static int sli_process_socket_buffered_data(int fd, char *data, size_t data_leng
   return 0;
 }
 
-static int sli_send_response_headers(sl_http_server_t *server, sl_http_server_response_t *response, int window_size)
+static void sli_http_tx_init(sli_http_tx_t *tx, sl_http_server_t *handle)
 {
-  char response_code[16]  = { 0 };
-  char content_length[32] = { 0 };
-  char *http_version      = NULL;
+  socklen_t window_size_length = sizeof(tx->window_size); // in/out parameter
+
+  tx->handle      = handle;
+  tx->window_size = 0;
+  tx->length      = 0;
+  tx->status      = SL_STATUS_OK;
+  getsockopt(handle->client_socket, SOL_SOCKET, SO_SNDBUF, (char *)&tx->window_size, &window_size_length);
+  if (tx->window_size <= 0) {
+    tx->window_size = SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH;
+  }
+}
 
-  // Convert the response code to a string
-  sprintf(response_code, "%d", response->response_code);
+static void sli_http_tx_send(sli_http_tx_t *tx, const uint8_t *data, uint32_t length)
+{
+  if ((SL_STATUS_OK == tx->status)
+      && (sli_process_socket_buffered_data(tx->handle->client_socket, (const char *)data, length, tx->window_size)
+          == -1)) {
+    SL_DEBUG_LOG("Failed to send buffer");
+    tx->status = SL_STATUS_FAIL;
+  }
+}
+
+static void sli_http_tx_flush(sli_http_tx_t *tx)
+{
+  if (tx->length > 0) {
+    sli_http_tx_send(tx, tx->handle->response_buffer, tx->length);
+    tx->length = 0;
+  }
+}
+
+static void sli_http_tx_append(sli_http_tx_t *tx, const void *data, uint32_t length)
+{
+  const uint8_t *bytes = data;
+  uint32_t count       = 0;
+
+  while (length > 0) {
+    count = SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH - tx->length;
+    if (count > length) {
+      count = length;
+    }
+    memcpy(&tx->handle->response_buffer[tx->length], bytes, count);
+    tx->length += count;
+    bytes += count;
+    length -= count;
+    if (SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH == tx->length) {
+      sli_http_tx_flush(tx);
+    }
+  }
+}
 
-  if (response->expected_data_length > 0) {
-    sprintf(content_length, "%lu", response->expected_data_length);
+static void sli_http_tx_append_string(sli_http_tx_t *tx, const char *text)
+{
+  sli_http_tx_append(tx, text, strlen(text));
+}
+
+// Data that does not fit the rest of the response buffer is sent from where it is stored instead of being copied
+static void sli_http_tx_append_data(sli_http_tx_t *tx, const uint8_t *data, uint32_t length)
+{
+  if (length <= (SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH - tx->length)) {
+    sli_http_tx_append(tx, data, length);
+  } else {
+    sli_http_tx_flush(tx);
+    sli_http_tx_send(tx, data, length);
   }
+}
+
+// Has the read callback of the body produce its data straight into the response buffer, framed as chunks if requested
+static void sli_http_tx_append_produced(sli_http_tx_t *tx, const sl_http_server_body_t *body, bool chunked)
+{
+  static const char hex_digits[] = "0123456789ABCDEF";
+  uint8_t *buffer                = tx->handle->response_buffer;
+  uint32_t remaining             = body->length;
+  uint32_t prefix                = chunked ? SLI_HTTP_CHUNK_SIZE_LINE_LENGTH : 0;
+  uint32_t suffix                = chunked ? 2 : 0;
+  uint32_t minimum               = prefix + suffix + (SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH / 4);
+  uint32_t space                 = 0;
+  int32_t produced               = 0;
+
+  while ((SL_STATUS_OK == tx->status) && (remaining > 0)) {
+    // Send what is gathered once the free space is too small to be worth a callback
+    if ((SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH - tx->length) < minimum) {
+      sli_http_tx_flush(tx);
+    }
+    space = SL_HTTP_SERVER_RESPONSE_BUFFER_LENGTH - tx->length - prefix - suffix;
+    if ((SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN != remaining) && (space > remaining)) {
+      space = remaining;
+    }
+
+    produced = body->read(body->context, &buffer[tx->length + prefix], space);
+    if ((produced < 0) || ((uint32_t)produced > space)) {
+      tx->status = SL_STATUS_FAIL;
+      break;
+    }
+    if (0 == produced) {
+      // A body that ends before its announced length cannot be completed
+      if (SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN != remaining) {
+        tx->status = SL_STATUS_FAIL;
+      }
+      break;
+    }
+
+    if (chunked) {
+      for (int i = 7; i >= 0; i--) {
+        buffer[tx->length + i] = hex_digits[((uint32_t)produced >> (4 * (7 - i))) & 0xF];
+      }
+      buffer[tx->length + 8] = '\r';
+      buffer[tx->length + 9] = '\n';
+    }
+    tx->length += prefix + (uint32_t)produced;
+    if (chunked) {
+      buffer[tx->length++] = '\r';
+      buffer[tx->length++] = '\n';
+    }
+    if (SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN != remaining) {
+      remaining -= (uint32_t)produced;
+    }
+  }
+}
+
+// Gathers the status line and the headers of a response, except for the empty line that ends them
+static void sli_write_response_headers(sli_http_tx_t *tx,
+                                       const sl_http_server_response_t *response,
+                                       uint32_t content_length,
+                                       sli_http_body_framing_t framing)
+{
+  sl_http_server_t *server = tx->handle;
+  char number[16]          = { 0 };
 
   if (SL_HTTP_VERSION_1_1 == server->request.version) {
-    http_version = "HTTP/1.1 ";
+    sli_http_tx_append_string(tx, "HTTP/1.1 ");
   } else {
-    http_version = "HTTP/1.0 ";
+    sli_http_tx_append_string(tx, "HTTP/1.0 ");
   }
 
-  sli_process_socket_buffered_data(server->client_socket, http_version, strlen(http_version), window_size);
-  sli_process_socket_buffered_data(server->client_socket, response_code, strlen(response_code), window_size);
-  sli_process_socket_buffered_data(server->client_socket, "\r\n", 2, window_size);
+  // Convert the response code to a string
+  sprintf(number, "%d", response->response_code);
+  sli_http_tx_append_string(tx, number);
+  sli_http_tx_append_string(tx, "\r\n");
 
   if (NULL != response->content_type) {
-    sli_process_socket_buffered_data(server->client_socket, "Content-Type: ", strlen("Content-Type: "), window_size);
-    sli_process_socket_buffered_data(server->client_socket,
-                                     response->content_type,
-                                     strlen(response->content_type),
-                                     window_size);
-    sli_process_socket_buffered_data(server->client_socket, "\r\n", 2, window_size);
-  }
-
-  if (response->expected_data_length > 0) {
-    sli_process_socket_buffered_data(server->client_socket,
-                                     "Content-Length: ",
-                                     strlen("Content-Length: "),
-                                     window_size);
-    sli_process_socket_buffered_data(server->client_socket, content_length, strlen(content_length), window_size);
-    sli_process_socket_buffered_data(server->client_socket, "\r\n", 2, window_size);
-  }
-  sli_process_socket_buffered_data(server->client_socket,
-                                   HTTP_CONNECTION_STATUS_HEADER,
-                                   strlen(HTTP_CONNECTION_STATUS_HEADER),
-                                   window_size);
+    sli_http_tx_append_string(tx, "Content-Type: ");
+    sli_http_tx_append_string(tx, response->content_type);
+    sli_http_tx_append_string(tx, "\r\n");
+  }
+
+  // Persistent connections need an explicit length to delimit the response, even when it is empty
+  if ((SLI_HTTP_BODY_CONTENT_LENGTH == framing) && ((content_length > 0) || server->keep_alive)) {
+    sprintf(number, "%lu", content_length);
+    sli_http_tx_append_string(tx, "Content-Length: ");
+    sli_http_tx_append_string(tx, number);
+    sli_http_tx_append_string(tx, "\r\n");
+  } else if (SLI_HTTP_BODY_CHUNKED == framing) {
+    sli_http_tx_append_string(tx, "Transfer-Encoding: chunked\r\n");
+  }
+  sli_http_tx_append_string(tx, server->keep_alive ? HTTP_CONNECTION_KEEP_ALIVE : HTTP_CONNECTION_STATUS_HEADER);
 
   // Append the headers to the response
   if ((response->header_count > 0) && (NULL != response->headers)) {
     for (int i = 0; i < response->header_count; i++) {
-      sli_process_socket_buffered_data(server->client_socket,
-                                       response->headers[i].key,
-                                       strlen(response->headers[i].key),
-                                       window_size);
-      sli_process_socket_buffered_data(server->client_socket, ": ", 2, window_size);
-      sli_process_socket_buffered_data(server->client_socket,
-                                       response->headers[i].value,
-                                       strlen(response->headers[i].value),
-                                       window_size);
-      sli_process_socket_buffered_data(server->client_socket, "\r\n", 2, window_size);
+      sli_http_tx_append_string(tx, response->headers[i].key);
+      sli_http_tx_append_string(tx, ": ");
+      sli_http_tx_append_string(tx, response->headers[i].value);
+      sli_http_tx_append_string(tx, "\r\n");
     }
   }
+}
 
-  sli_process_socket_buffered_data(server->client_socket, "\r\n", 2, window_size);
-  return 0;
+// Sends a response with a streamed body. vary_encoding is set when another content coding of the body exists.
+static sl_status_t sli_send_response_body(sl_http_server_t *handle,
+                                          const sl_http_server_response_t *response,
+                                          const sl_http_server_body_t *body,
+                                          bool vary_encoding)
+{
+  sli_http_tx_t tx;
+  sl_http_server_response_t not_modified;
+  sli_http_body_framing_t framing = SLI_HTTP_BODY_CONTENT_LENGTH;
+  bool send_body                  = (SL_HTTP_REQUEST_HEAD != handle->request.type);
+
+  if ((NULL != body->etag) && sli_http_etag_matches(handle, body->etag)) {
+    // The client already holds this body
+    not_modified               = *response;
+    not_modified.response_code = SL_HTTP_RESPONSE_NOT_MODIFIED;
+    response                   = &not_modified;
+    framing                    = SLI_HTTP_BODY_NONE;
+    send_body                  = false;
+  } else if (SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN == body->length) {
+    if (SL_HTTP_VERSION_1_1 == handle->request.version) {
+      framing = SLI_HTTP_BODY_CHUNKED;
+    } else {
+      framing            = SLI_HTTP_BODY_CLOSE;
+      handle->keep_alive = false;
+    }
+  }
+
+  sli_http_tx_init(&tx, handle);
+  sli_write_response_headers(&tx, response, body->length, framing);
+  if (NULL != body->etag) {
+    sli_http_tx_append_string(&tx, "ETag: ");
+    sli_http_tx_append_string(&tx, body->etag);
+    sli_http_tx_append_string(&tx, "\r\n");
+  }
+  if (body->gzip_encoded && (SLI_HTTP_BODY_NONE != framing)) {
+    sli_http_tx_append_string(&tx, "Content-Encoding: gzip\r\n");
+  }
+  if (vary_encoding) {
+    sli_http_tx_append_string(&tx, "Vary: Accept-Encoding\r\n");
+  }
+  sli_http_tx_append_string(&tx, "\r\n");
+
+  if (send_body) {
+    if (SL_HTTP_SERVER_BODY_MEMORY == body->type) {
+      sli_http_tx_append_data(&tx, body->data, body->length);
+    } else {
+      sli_http_tx_append_produced(&tx, body, (SLI_HTTP_BODY_CHUNKED == framing));
+    }
+    if (SLI_HTTP_BODY_CHUNKED == framing) {
+      sli_http_tx_append_string(&tx, "0\r\n\r\n");
+    }
+  }
+  sli_http_tx_flush(&tx);
+
+  // The response cannot be resumed, a connection left with a partial body is closed
+  handle->rem_resp_length = 0;
+  handle->response_sent   = true;
+  if (SL_STATUS_OK != tx.status) {
+    handle->keep_alive = false;
+  }
+  return tx.status;
 }
 
 /******************************************************
@@ -501,14 +1510,23 @@ sl_status_t sl_http_server_init(sl_http_server_t *handle, const sl_http_server_c
   } else {
     handle->config.default_handler = unknown_request_handler;
   }
-  handle->config.handlers_list    = config->handlers_list;
-  handle->config.handlers_count   = config->handlers_count;
-  handle->config.client_idle_time = config->client_idle_time;
+  handle->config.handlers_list      = config->handlers_list;
+  handle->config.handlers_count     = config->handlers_count;
+  handle->config.client_idle_time   = config->client_idle_time;
+  handle->config.max_clients        = config->max_clients;
+  handle->config.worker_count       = config->worker_count;
+  handle->config.keep_alive_timeout = config->keep_alive_timeout;
+  handle->server_socket             = -1;
+  handle->client_socket             = -1;
+  handle->keep_alive                = false;
+  handle->parent                    = NULL;
+  handle->context                   = NULL;
 
   memset(handle->request_buffer, 0, sizeof(MAX_HEADER_BUFFER_LENGTH));
   handle->http_server_id = osEventFlagsNew(NULL);
 
   memset(&(handle->request), 0, sizeof(sl_http_server_request_t));
+  sli_build_route_table(handle);
 
   return SL_STATUS_OK;
 }
@@ -584,10 +1602,7 @@ sl_status_t sl_http_server_get_request_headers(sl_http_server_t *handle,
                                                uint16_t header_count)
 {
 
-  uint16_t current_count = 0;
-  char *header           = NULL;
-  char *sol              = NULL;
-  int length             = 0;
+  uint16_t count = 0;
 
   if (NULL == handle) {
     return SL_STATUS_INVALID_PARAMETER;
@@ -605,34 +1620,13 @@ sl_status_t sl_http_server_get_request_headers(sl_http_server_t *handle,
     return SL_STATUS_INVALID_PARAMETER;
   }
 
-  sol    = handle->header;
-  length = strlen(sol);
-  header = sol;
-  for (int i = 0; i < length; i++) {
-    if ('\r' == header[i] && '\n' == header[i + 1]) {
-      // Found a new line
-      header[i]     = 0;
-      header[i + 1] = 0;
-
-      // Seggrigate key and value in current header line
-      char *colon_pos = strchr(sol, ':'); // Find the colon position
-      if (' ' == *(colon_pos - 1)) {
-        *(colon_pos - 1) = 0;
-      } else {
-        *colon_pos = 0;
-      }
-      colon_pos += 2;
-
-      headers[current_count].key   = sol;
-      headers[current_count].value = colon_pos;
-
-      sol = &(header[i + 2]);
-      current_count++;
-      if (current_count == header_count) {
-        break;
-      }
-    }
+  // The headers were recorded in place while the request was parsed
+  count = (request->request_header_count < SL_HTTP_SERVER_MAX_REQUEST_HEADERS) ? request->request_header_count
+                                                                              : SL_HTTP_SERVER_MAX_REQUEST_HEADERS;
+  if (count > header_count) {
+    count = header_count;
   }
+  memcpy(headers, handle->request_headers, count * sizeof(sl_http_header_t));
   return SL_STATUS_OK;
 }
 
@@ -654,7 +1648,7 @@ sl_status_t sl_http_server_read_request_data(sl_http_server_t *handle, sl_http_r
     return SL_STATUS_INVALID_PARAMETER;
   }
 
-  if (0 == recvData->request->request_data_length) {
+  if ((0 == recvData->request->request_data_length) && !recvData->request->is_chunked) {
     return SL_STATUS_INVALID_PARAMETER;
   }
 
@@ -663,6 +1657,10 @@ sl_status_t sl_http_server_read_request_data(sl_http_server_t *handle, sl_http_r
   }
   recvData->received_data_length = 0;
 
+  if (recvData->request->is_chunked) {
+    return sli_read_chunked_request_data(handle, recvData);
+  }
+
   length  = 0;
   offset  = 0;
   rem_len = handle->data_length;
@@ -685,6 +1683,9 @@ sl_status_t sl_http_server_read_request_data(sl_http_server_t *handle, sl_http_r
     }
 
     rem_len = recvData->buffer_length - length;
+    if (rem_len > handle->rem_len) {
+      rem_len = handle->rem_len;
+    }
   } else {
     if (handle->rem_len > recvData->buffer_length) {
       rem_len = recvData->buffer_length;
@@ -695,9 +1696,10 @@ sl_status_t sl_http_server_read_request_data(sl_http_server_t *handle, sl_http_r
 
   while (0 != rem_len) {
     int receive_length = recv(handle->client_socket, &(recvData->buffer[offset]), rem_len, 0);
-    if (receive_length < 0) {
+    if (receive_length <= 0) {
+      // The server thread closes the client socket once the request handler returns
       SL_DEBUG_LOG("\r\nSocket receive failed with bsd error: %d\r\n", errno);
-      close(handle->client_socket);
+      handle->keep_alive = false;
       return SL_STATUS_FAIL;
     }
     length = (uint32_t)receive_length;
@@ -712,8 +1714,7 @@ sl_status_t sl_http_server_read_request_data(sl_http_server_t *handle, sl_http_r
 
 sl_status_t sl_http_server_send_response(sl_http_server_t *handle, sl_http_server_response_t *response)
 {
-  int buffersize              = 0;
-  socklen_t buffersize_length = sizeof(buffersize); // in/out parameter
+  sli_http_tx_t tx;
 
   // Check if the response is not NULL
   if (response == NULL) {
@@ -731,20 +1732,16 @@ sl_status_t sl_http_server_send_response(sl_http_server_t *handle, sl_http_serve
     return SL_STATUS_FAIL;
   }
 
-  getsockopt(handle->client_socket, SOL_SOCKET, SO_SNDBUF, (char *)&buffersize, &buffersize_length);
-
-  sli_send_response_headers(handle, response, buffersize);
-
+  // Headers and a body that fits the response buffer go out in a single send
+  sli_http_tx_init(&tx, handle);
+  sli_write_response_headers(&tx, response, response->expected_data_length, SLI_HTTP_BODY_CONTENT_LENGTH);
+  sli_http_tx_append_string(&tx, "\r\n");
   if ((NULL != response->data) && (response->current_data_length > 0)) {
-    if (sli_process_socket_buffered_data(handle->client_socket,
-                                         (char *)response->data,
-                                         response->current_data_length,
-                                         buffersize)
-        == -1) {
-      SL_DEBUG_LOG("Failed to send buffer");
-      // TODO: Free the response string
-      return SL_STATUS_FAIL;
-    }
+    sli_http_tx_append_data(&tx, response->data, response->current_data_length);
+  }
+  sli_http_tx_flush(&tx);
+  if (SL_STATUS_OK != tx.status) {
+    return SL_STATUS_FAIL;
   }
 
   handle->rem_resp_length = response->expected_data_length - response->current_data_length;
@@ -755,8 +1752,7 @@ sl_status_t sl_http_server_send_response(sl_http_server_t *handle, sl_http_serve
 
 sl_status_t sl_http_server_write_data(sl_http_server_t *handle, uint8_t *data, uint32_t data_length)
 {
-  int buffersize              = 0;
-  socklen_t buffersize_length = sizeof(buffersize); // in/out parameter
+  sli_http_tx_t tx;
 
   if (handle == NULL) {
     return SL_STATUS_FAIL;
@@ -779,9 +1775,9 @@ sl_status_t sl_http_server_write_data(sl_http_server_t *handle, uint8_t *data, u
     return SL_STATUS_FAIL;
   }
 
-  getsockopt(handle->client_socket, SOL_SOCKET, SO_SNDBUF, (char *)&buffersize, &buffersize_length);
-  if (sli_process_socket_buffered_data(handle->client_socket, (char *)data, data_length, buffersize) == -1) {
-    SL_DEBUG_LOG("Failed to send buffer");
+  sli_http_tx_init(&tx, handle);
+  sli_http_tx_send(&tx, data, data_length);
+  if (SL_STATUS_OK != tx.status) {
     return SL_STATUS_FAIL;
   }
 
@@ -789,3 +1785,95 @@ sl_status_t sl_http_server_write_data(sl_http_server_t *handle, uint8_t *data, u
 
   return SL_STATUS_OK;
 }
+
+sl_status_t sl_http_server_send_response_body(sl_http_server_t *handle,
+                                              sl_http_server_response_t *response,
+                                              const sl_http_server_body_t *body)
+{
+  if ((NULL == handle) || (NULL == response) || (NULL == body)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if (SL_HTTP_SERVER_BODY_MEMORY == body->type) {
+    if (((NULL == body->data) && (body->length > 0)) || (SL_HTTP_SERVER_BODY_LENGTH_UNKNOWN == body->length)) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+  } else if ((SL_HTTP_SERVER_BODY_CALLBACK != body->type) || (NULL == body->read)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Check if the response is sent already
+  if (true == handle->response_sent) {
+    return SL_STATUS_FAIL;
+  }
+
+  return sli_send_response_body(handle, response, body, body->gzip_encoded);
+}
+
+sl_status_t sl_http_server_send_static_asset(sl_http_server_t *handle, const sl_http_server_static_asset_t *asset)
+{
+  sl_http_server_response_t response = { 0 };
+  sl_http_server_body_t body         = { 0 };
+
+  if ((NULL == handle) || (NULL == asset)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((NULL == asset->data) && (NULL == asset->gzip_data)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Check if the response is sent already
+  if (true == handle->response_sent) {
+    return SL_STATUS_FAIL;
+  }
+
+  response.response_code = SL_HTTP_RESPONSE_OK;
+  response.content_type  = (char *)asset->content_type;
+  response.headers       = asset->headers;
+  response.header_count  = asset->header_count;
+
+  body.type = SL_HTTP_SERVER_BODY_MEMORY;
+  body.etag = asset->etag;
+  if ((NULL != asset->gzip_data) && ((NULL == asset->data) || sl_http_server_request_accepts_gzip(handle))) {
+    body.data         = asset->gzip_data;
+    body.length       = asset->gzip_length;
+    body.gzip_encoded = true;
+  } else {
+    body.data   = asset->data;
+    body.length = asset->length;
+  }
+
+  return sli_send_response_body(handle, &response, &body, (NULL != asset->data) && (NULL != asset->gzip_data));
+}
+
+bool sl_http_server_request_accepts_gzip(const sl_http_server_t *handle)
+{
+  const char *value = NULL;
+
+  if (NULL == handle) {
+    return false;
+  }
+
+  value = sli_http_find_request_header(handle, "Accept-Encoding");
+  for (; (NULL != value) && (*value != 0); value++) {
+    if (!sli_http_starts_with(value, "gzip")) {
+      continue;
+    }
+    for (value += 4; *value == ' '; value++) {
+    }
+    if (*value != ';') {
+      return true;
+    }
+    for (value++; *value == ' '; value++) {
+    }
+    if (!sli_http_starts_with(value, "q=0")) {
+      return true;
+    }
+    // A weight of zero, q=0 or q=0.000, refuses the coding
+    for (value += 3; (*value == '.') || (*value == '0'); value++) {
+    }
+    return ((*value >= '1') && (*value <= '9'));
+  }
+  return false;
+}
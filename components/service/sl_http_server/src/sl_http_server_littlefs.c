@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * # License
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "sl_http_server_littlefs.h"
+#include <string.h>
+
+/******************************************************
+ *                   Type Definitions
+ ******************************************************/
+typedef struct {
+  lfs_t *lfs;
+  lfs_file_t file;
+} sli_http_server_littlefs_file_t;
+
+/******************************************************
+ *               Static functions
+ ******************************************************/
+static int32_t sli_http_server_littlefs_read(void *context, uint8_t *buffer, uint32_t buffer_length)
+{
+  sli_http_server_littlefs_file_t *source = (sli_http_server_littlefs_file_t *)context;
+
+  // Negative littlefs error codes abort the response
+  return (int32_t)lfs_file_read(source->lfs, &source->file, buffer, buffer_length);
+}
+
+/******************************************************
+ *               Function Definitions APIs
+ ******************************************************/
+sl_status_t sl_http_server_send_littlefs_file(sl_http_server_t *handle,
+                                              sl_http_server_response_t *response,
+                                              lfs_t *lfs,
+                                              const char *path,
+                                              const char *etag)
+{
+  sli_http_server_littlefs_file_t source = { 0 };
+  sl_http_server_body_t body             = { 0 };
+  char gzip_path[SL_HTTP_SERVER_LITTLEFS_PATH_MAX + 1];
+  size_t path_length = 0;
+  lfs_soff_t size    = 0;
+  int result         = LFS_ERR_NOENT;
+  sl_status_t status = SL_STATUS_OK;
+
+  if ((NULL == handle) || (NULL == response) || (NULL == lfs) || (NULL == path)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Check if the response is sent already
+  if (true == handle->response_sent) {
+    return SL_STATUS_FAIL;
+  }
+
+  source.lfs  = lfs;
+  path_length = strlen(path);
+  if (((path_length + 3) <= SL_HTTP_SERVER_LITTLEFS_PATH_MAX) && sl_http_server_request_accepts_gzip(handle)) {
+    memcpy(gzip_path, path, path_length);
+    memcpy(&gzip_path[path_length], ".gz", sizeof(".gz"));
+    result = lfs_file_open(lfs, &source.file, gzip_path, LFS_O_RDONLY);
+    body.gzip_encoded = (LFS_ERR_OK == result);
+  }
+  if (LFS_ERR_OK != result) {
+    result = lfs_file_open(lfs, &source.file, path, LFS_O_RDONLY);
+  }
+  if (LFS_ERR_NOENT == result) {
+    return SL_STATUS_NOT_FOUND;
+  }
+  if (LFS_ERR_OK != result) {
+    return SL_STATUS_FAIL;
+  }
+
+  size = lfs_file_size(lfs, &source.file);
+  if (size < 0) {
+    lfs_file_close(lfs, &source.file);
+    return SL_STATUS_FAIL;
+  }
+
+  body.type    = SL_HTTP_SERVER_BODY_CALLBACK;
+  body.read    = sli_http_server_littlefs_read;
+  body.context = &source;
+  body.length  = (uint32_t)size;
+  body.etag    = etag;
+  status       = sl_http_server_send_response_body(handle, response, &body);
+
+  lfs_file_close(lfs, &source.file);
+  return status;
+}
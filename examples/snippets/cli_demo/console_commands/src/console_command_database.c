@@ -616,6 +616,16 @@ static const console_descriptive_command_t _wifi_get_client_info_command = {
   .argument_list = { CONSOLE_ARG_END }
 };
 
+extern sl_status_t wifi_get_command_latency_command_handler(console_args_t *arguments);
+static const char *_wifi_get_command_latency_arg_help[] = {};
+
+static const console_descriptive_command_t _wifi_get_command_latency_command = {
+  .description   = "Print per-command latency histograms of the driver",
+  .argument_help = _wifi_get_command_latency_arg_help,
+  .handler       = wifi_get_command_latency_command_handler,
+  .argument_list = { CONSOLE_ARG_END }
+};
+
 extern sl_status_t wifi_get_default_interface_command_handler(console_args_t *arguments);
 static const char *_wifi_get_default_interface_arg_help[] = {};
 
@@ -1327,7 +1337,7 @@ static const console_descriptive_command_t _wifi_update_gain_table_command = {
   .handler       = sl_wifi_update_gain_table_command_handler,
   .argument_list = { CONSOLE_ARG_UINT, CONSOLE_ARG_UINT, CONSOLE_ARG_END }
 };
-const console_database_t console_command_database = { CONSOLE_DATABASE_ENTRIES(
+const console_database_t console_command_database = { CONSOLE_SORTED_DATABASE_ENTRIES(
   { "get", &_get_command },
   { "help", &_help_command },
   { "list", &_list_command },
@@ -1347,6 +1357,7 @@ const console_database_t console_command_database = { CONSOLE_DATABASE_ENTRIES(
   { "thread", &_thread_command },
   { "wifi_11ax_config", &_wifi_11ax_config_command },
   { "wifi_assert", &_wifi_assert_command },
+  { "wifi_ax_transmit_test_start", &_wifi_ax_transmit_test_start_command },
   { "wifi_bsd_get_host_by_name", &_wifi_bsd_get_host_by_name_command },
   { "wifi_bsd_get_peer_name", &_wifi_bsd_get_peer_name_command },
   { "wifi_bsd_get_sock_name", &_wifi_bsd_get_sock_name_command },
@@ -1377,6 +1388,7 @@ const console_database_t console_command_database = { CONSOLE_DATABASE_ENTRIES(
   { "wifi_get_ap_configuration", &_wifi_get_ap_configuration_command },
   { "wifi_get_channel", &_wifi_get_channel_command },
   { "wifi_get_client_info", &_wifi_get_client_info_command },
+  { "wifi_get_command_latency", &_wifi_get_command_latency_command },
   { "wifi_get_default_interface", &_wifi_get_default_interface_command },
   { "wifi_get_fw_version", &_wifi_get_fw_version_command },
   { "wifi_get_mac_address", &_wifi_get_mac_address_command },
@@ -1423,6 +1435,5 @@ const console_database_t console_command_database = { CONSOLE_DATABASE_ENTRIES(
   { "wifi_stop_statistic_report", &_wifi_stop_statistic_report_command },
   { "wifi_test_client_configuration", &_wifi_test_client_configuration_command },
   { "wifi_transmit_test_start", &_wifi_transmit_test_start_command },
-  { "wifi_ax_transmit_test_start", &_wifi_ax_transmit_test_start_command },
   { "wifi_transmit_test_stop", &_wifi_transmit_test_stop_command },
   { "wifi_update_gain_table", &_wifi_update_gain_table_command }, ) };
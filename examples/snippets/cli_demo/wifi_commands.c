@@ -40,6 +40,7 @@
 #include "aws_client_certificate.pem.crt.h"
 #include "aws_client_private_key.pem.key.h"
 #include "sl_si91x_driver.h"
+#include "sl_si91x_command_latency.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -898,6 +899,32 @@ sl_status_t wifi_get_statistics_command_handler(console_args_t *arguments)
   return status;
 }
 
+sl_status_t wifi_get_command_latency_command_handler(console_args_t *arguments)
+{
+  UNUSED_PARAMETER(arguments);
+  static const char *interval_names[SL_SI91X_COMMAND_LATENCY_COUNT] = { "queued", "device", "delivery", "total" };
+  // Too large for the application thread stack
+  static sl_si91x_command_latency_t latencies[SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS];
+  uint32_t count = sl_si91x_get_command_latencies(latencies, SL_SI91X_COMMAND_LATENCY_MAX_COMMANDS);
+
+  if (count == 0) {
+    printf("No commands traced, build with SL_SI91X_COMMAND_LATENCY_TRACE defined\r\n");
+    return SL_STATUS_OK;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    printf("Command 0x%04X: count %lu\r\n", latencies[i].command, latencies[i].count);
+    for (int interval = 0; interval < SL_SI91X_COMMAND_LATENCY_COUNT; interval++) {
+      printf("  %-8s max %lu ms:", interval_names[interval], latencies[i].max_ms[interval]);
+      for (int bin = 0; bin < SL_SI91X_COMMAND_LATENCY_HISTOGRAM_BINS; bin++) {
+        printf(" %lu", latencies[i].histogram[interval][bin]);
+      }
+      printf("\r\n");
+    }
+  }
+  return SL_STATUS_OK;
+}
+
 sl_status_t wifi_get_operational_statistics_command_handler(console_args_t *arguments)
 {
   UNUSED_PARAMETER(arguments);